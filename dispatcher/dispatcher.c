@@ -12,6 +12,9 @@
 #include "ipc/ipc.h"
 #include "scheduler/scheduler.h"
 #include "ringbuffer/ringbuf.h"
+#include "log/log.h"
+#include "pmu/pmu.h"
+#include "prof/prof.h"
 
 /**************************************************
  * MACRO DEFINTIONS
@@ -20,6 +23,8 @@
 /**************************************************
  * GLOBAL VARIABLES
  ***************************************************/
+static tcb_t *uart_rx_tcb;          // woken by the UART ISR
+static tcb_t *ring_consumer_tcb;    // woken by uart_rx_task
 
 /**************************************************
  * HELPER FUNCTIONS
@@ -37,63 +42,122 @@ unsigned long get_cpu_id(void) {
     return id & 0xFF;
 }
 
+/* UART ISR (Core 0, same core as the task) -> end uart_rx_task's sleep */
+static void uart_rx_wake(void) {
+    sched_wake(uart_rx_tcb);
+}
+
 void uart_rx_task(void) {
-    /* Simulating real time keyboard */
+    /* The UART ISR already drained the FIFO; move its ring into ours */
+    volatile unsigned char *span;
+
+    uart_rx_tcb = sched_self();
+    uart_set_rx_notify(uart_rx_wake);
+
     while (1) {
-        if(uart_has_data()) {
-            unsigned char c = (unsigned char)uart_getc();
-            ring_buffer_put(UART_RX_BUFFER, c);
+        unsigned int room = ring_buffer_reserve(UART_RX_BUFFER, &span, RING_BUFFER_SIZE);
+        unsigned int n = uart_read((unsigned char *)span, room);
+        if (n) {
+            ring_buffer_commit(UART_RX_BUFFER, n);
             __asm__ volatile("sev" ::: "memory");
+            sched_wake(ring_consumer_tcb);
+            task_yield();
+        } else {
+            task_sleep_ms(CONSOLE_IDLE_MS);     // until the ISR wakes us
         }
-        task_yield();
     }
 }
 
 void ring_consumer_task(void) {
-    unsigned char byte = '\0';
+    const volatile unsigned char *span;
+
+    ring_consumer_tcb = sched_self();
+
     while (1) {
-        if (ring_buffer_get(UART_RX_BUFFER, &byte) == 0) {
-
-            /* Halt the system when ctr+c arrives */
-            spinlock_acquire(SPINLOCK_ADDR);
-            switch (uart_key_event(byte)) {
-                case KEY_CTRL_C:
-                    uart_puts("\r\n[ERROR] Keyboard locked. System halted.\r\n");
-                    while (1) { __asm__ volatile("wfe"); }
-                    break;
-                case KEY_ENTER:
-                    uart_puts("\r\n");
-                    break;
-                case KEY_NONE:
-                default:
-                    uart_putc(byte);
-                    break;
+        unsigned int n = ring_buffer_peek(UART_RX_BUFFER, &span, RING_BUFFER_SIZE);
+        if (n) {
+
+            /* Halt the system when ctr+c arrives. IRQs masked while the
+             * console lock is held: Core 0 is preemptive */
+            uint64_t daif = spinlock_acquire_irqsave(SPINLOCK_ADDR);
+            for (unsigned int i = 0; i < n; i++) {
+                unsigned char byte = span[i];
+                switch (uart_key_event(byte)) {
+                    case KEY_CTRL_C:
+                        uart_puts("\r\n[ERROR] Keyboard locked. System halted.\r\n");
+                        while (1) { __asm__ volatile("wfe"); }
+                        break;
+                    case KEY_ENTER:
+                        uart_puts("\r\n");
+                        break;
+                    case KEY_CTRL_P:
+                        uart_puts("\r\n");
+                        pmu_dump();         // lock already held
+                        break;
+                    case KEY_CTRL_R:        // profiles Core 0, where this task runs
+                        if (!prof_running()) {
+                            uart_puts("\r\n[PROF] sampling Core 0\r\n");
+                            prof_start(PROF_DEFAULT_HZ);
+                        } else {
+                            prof_stop();
+                            uart_puts("\r\n");
+                            if (prof_dump_semihost("prof.bin") == 0) {
+                                uart_puts("[PROF] wrote prof.bin\r\n");
+                            } else {
+                                prof_dump_uart();
+                            }
+                        }
+                        break;
+                    case KEY_NONE:
+                    default:
+                        uart_putc(byte);
+                        break;
+                }
             }
-            spinlock_release(SPINLOCK_ADDR);
+            spinlock_release_irqrestore(SPINLOCK_ADDR, daif);
+            ring_buffer_consume(UART_RX_BUFFER, n);
+            task_yield();
+        } else {
+            task_sleep_ms(CONSOLE_IDLE_MS);     // until uart_rx_task wakes us
         }
-        task_yield();
     }
 }
 
 void mailbox_dispatcher_task(void) {
-    unsigned int sender, msg_type, msg_data;
+    mailbox_msg_t batch[MAILBOX_DEPTH];
     unsigned long cpu = get_cpu_id();   // will always be 3 when this runs
 
     while (1) {
-        if (mailbox_receive(cpu, &sender, &msg_type, &msg_data) == 1) {
-
-            spinlock_acquire(SPINLOCK_ADDR);
-            uart_puts("[Core 3] RX from Core "); uart_putc('0' + sender);
-            uart_puts(" | Type: ");              uart_putc('0' + msg_type);
-            uart_puts(" | Data: ");              uart_puthex(msg_data);
-            uart_puts("\n");
-            spinlock_release(SPINLOCK_ADDR);
-
-            unsigned int ack_data = msg_data + (cpu << 16);
-            mailbox_send(sender, MSG_ACK, ack_data);
-            mailbox_clear(cpu);
+        /* Drain the whole inbox per wakeup instead of one message per round */
+        unsigned int n = mailbox_receive_batch(cpu, batch, MAILBOX_DEPTH);
+
+        for (unsigned int i = 0; i < n; i++) {
+            /* value = sender [47:40] | type [39:32] | data [31:0] */
+            LOG("mailbox RX sender|type|data: ",
+                ((uint64_t)batch[i].sender_id << 40) |
+                ((uint64_t)batch[i].msg_type  << 32) | batch[i].msg_data);
+
+            unsigned int ack_data = batch[i].msg_data + (cpu << 16);
+            mailbox_release(&batch[i]);     // payload buffers are not used here
+            mailbox_send(batch[i].sender_id, MSG_ACK, ack_data);
         }
-        task_yield();   // nothing in mailbox → give turn to next task
+        if (n) {
+            task_yield();
+        } else {
+            task_sleep_ms(MAILBOX_IDLE_MS);     // idle: WFI, steal LOW tasks
+        }
+    }
+}
+
+/******************************************************************************
+ * Function: logger_task
+ * Description: Lowest-priority consumer of the per-core log queues. Emits a
+ *              bounded batch per round so it never hogs its core.
+ *****************************************************************************/
+void logger_task(void) {
+    while (1) {
+        log_flush(LOG_FLUSH_BATCH);
+        task_yield();
     }
 }
 
@@ -121,6 +185,10 @@ void dispatcher_run(uint16_t task_id)
             mailbox_dispatcher_task();
             break;
 
+        case LOGGER_TASK:
+            logger_task();
+            break;
+
         default:
             uart_puts("[DISPATCHER] Unknown task ID: ");
             uart_puthex(task_id);
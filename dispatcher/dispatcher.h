@@ -20,6 +20,27 @@
 #define UART_RX_TASK (0UL)
 #define RING_COSUMER_TASK (1UL)
 #define MAILBOX_DISP_TASK (2UL)
+#define LOGGER_TASK (3UL)
+
+/* Longest sleep of the console tasks; the UART IRQ wakes them sooner */
+#define CONSOLE_IDLE_MS    (100U)
+
+/* Inbox poll period of mailbox_dispatcher_task: senders run on other
+ * cores and sched_wake() only reaches the local core, so it polls */
+#define MAILBOX_IDLE_MS    (1U)
+
+/* Task priorities (scheduler.h: SCHED_PRIO_LEVELS) — higher runs first */
+#define TASK_PRIO_IDLE     (0U)
+#define TASK_PRIO_LOW      (1U)     /* logging, housekeeping          */
+#define TASK_PRIO_NORMAL   (4U)     /* console, inter-core mailboxes  */
+#define TASK_PRIO_HIGH     (6U)     /* fieldbus RX (Modbus)           */
+
+/* Task affinity (jobContext_t.affinity). Pinned is the default: real-time
+ * tasks such as Modbus RX stay on the core that registered them. A mask
+ * makes the task migratable between the cores it names.                */
+#define TASK_AFFINITY_PINNED   (0U)
+#define TASK_AFFINITY_CORE(n)  (1U << (n))
+#define TASK_AFFINITY_ANY      (0x0FU)  /* cores 0-3                     */
 
 /*************************************************
  *  TYPEDEF STRUCTS UNIONS ENUMS
@@ -29,6 +50,8 @@ typedef struct {
     uint16_t    core_id;        /* which core is the jobContext on*/
     const char *task_name;      /* task__name = "uart_rx" i.e the driver name */
     void        (*entry)(void); /* entry point of the function */
+    uint8_t     priority;       /* TASK_PRIO_* (migratable: SCHED_MIG_PRIO) */
+    uint8_t     affinity;       /* TASK_AFFINITY_*, 0 = pinned */
 }jobContext_t;
 
 
@@ -40,6 +63,7 @@ unsigned long get_cpu_id(void);
 void uart_rx_task(void);
 void ring_consumer_task(void);
 void mailbox_dispatcher_task(void);
+void logger_task(void);
 void dispatcher_run(uint16_t task_id);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+/******************************************************************************
+* File: arena.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Bump allocator over the linker-defined shared arena
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "alloc/arena.h"
+#include "ipc/atomic.h"
+#include "libc/mem.h"
+#include "uart/uart0.h"
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+/* Linker script symbols — only their addresses mean anything */
+extern char __shared_start[], __shared_end[];
+
+static volatile uint64_t arena_cursor;     /* bytes handed out, from .bss */
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+/******************************************************************************
+* Function: arena_alloc
+* Description: Carve 'size' zeroed bytes out of the shared arena. Lock-free:
+*              the block is claimed with one CAS on the cursor, so two
+*              cores allocating at once each get their own block.
+* Parameters: size  - bytes wanted
+*             align - power of two, raised to ARENA_MIN_ALIGN if smaller
+* Returns: the block, or 0 when the arena is exhausted
+*****************************************************************************/
+void *arena_alloc(size_t size, size_t align)
+{
+    uintptr_t base  = (uintptr_t)__shared_start;
+    uint64_t  limit = (uint64_t)(__shared_end - __shared_start);
+    uint64_t  old, start;
+
+    if (align < ARENA_MIN_ALIGN) align = ARENA_MIN_ALIGN;
+
+    do {
+        old   = atomic_load_acquire64(&arena_cursor);
+        start = ((base + old + align - 1) & ~(uint64_t)(align - 1)) - base;
+        if (start + size > limit || start + size < start) return 0;
+    } while (!atomic_cas64(&arena_cursor, old, start + size));
+
+    return memset((void *)(base + start), 0, size);
+}
+
+/******************************************************************************
+* Function: arena_used / arena_size
+* Description: Bytes handed out so far (also the high-water mark, since
+*              nothing is ever returned) and total arena size
+*****************************************************************************/
+size_t arena_used(void)
+{
+    return (size_t)atomic_load_acquire64(&arena_cursor);
+}
+
+size_t arena_size(void)
+{
+    return (size_t)(__shared_end - __shared_start);
+}
+
+/******************************************************************************
+* Function: arena_stats_print
+* Description: One "[ARENA] base used/size" line. Caller holds the UART lock.
+*****************************************************************************/
+void arena_stats_print(void)
+{
+    uart_puts("[ARENA] base ");
+    uart_puthex((unsigned long)__shared_start);
+    uart_puts(" used ");
+    uart_putdec(arena_used());
+    uart_puts("/");
+    uart_putdec(arena_size());
+    uart_puts(" bytes\n");
+}
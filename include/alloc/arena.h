@@ -0,0 +1,47 @@
+/******************************************************************************
+* File: arena.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Shared-memory arena with a lock-free bump allocator
+*
+* The linker scripts reserve one NOLOAD region, .shared_arena
+* (__shared_start .. __shared_end), for everything more than one core
+* touches: the global spinlock, the mailboxes, the UART RX ring, the HMAC
+* context and the slab pools (slab.h). Each owner carves its object out
+* of the arena in its init function, so objects can grow without ever
+* overlapping:
+*
+*   lock = arena_alloc(sizeof(spinlock_t), CACHE_LINE_SIZE);
+*
+* Boot-time only: there is no free. The cursor is an offset in .bss, so
+* the arena is usable from the first line of main() without an init call.
+* arena_alloc() is one CAS on the cursor and never blocks, but boot
+* objects are normally created on Core 0 before the secondaries start.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef ARENA_H
+#define ARENA_H
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define ARENA_MIN_ALIGN     16      /* every block, whatever 'align' says  */
+
+/* One object of 'type', aligned to its own type */
+#define ARENA_NEW(type)     ((type *)arena_alloc(sizeof(type), _Alignof(type)))
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+void  *arena_alloc(size_t size, size_t align);
+size_t arena_used(void);
+size_t arena_size(void);
+void   arena_stats_print(void);
+
+#endif /* ARENA_H */
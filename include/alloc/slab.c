@@ -0,0 +1,294 @@
+/******************************************************************************
+* File: slab.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Slab pools over the shared arena, see slab.h
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "alloc/slab.h"
+#include "alloc/arena.h"
+#include "uart/uart0.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define SLAB_HEAD(tag, idx)     (((uint64_t)(tag) << 32) | (uint32_t)(idx))
+#define SLAB_HEAD_IDX(h)        ((uint32_t)(h))
+#define SLAB_HEAD_TAG(h)        ((uint32_t)((h) >> 32))
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+slab_pool_t *slab_msg_small;
+slab_pool_t *slab_msg_large;
+
+static slab_pool_t       *slab_registry[SLAB_MAX_POOLS];   /* by id - 1 */
+static volatile uint32_t  slab_pool_ids;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+static inline uint32_t slab_core_id(void)
+{
+    uint64_t mpidr;
+    __asm__ volatile("mrs %0, mpidr_el1" : "=r"(mpidr));
+    return (uint32_t)(mpidr & 0xFF) % SLAB_CORES;
+}
+
+/******************************************************************************
+* Function: slab_pop
+* Description: Take the first object off one core's list. The tag changes
+*              on every successful CAS, so a head that was popped and pushed
+*              back in between (ABA) makes the CAS fail instead of linking
+*              a stale 'next'.
+* Returns: object index, or SLAB_NIL if the list is empty
+*****************************************************************************/
+static uint32_t slab_pop(slab_pool_t *p, slab_core_t *c)
+{
+    uint64_t old, new;
+    uint32_t idx;
+
+    do {
+        old = atomic_load_acquire64(&c->head);
+        idx = SLAB_HEAD_IDX(old);
+        if (idx == SLAB_NIL) return SLAB_NIL;
+        new = SLAB_HEAD(SLAB_HEAD_TAG(old) + 1, p->next[idx]);
+    } while (!atomic_cas64(&c->head, old, new));
+
+    return idx;
+}
+
+/******************************************************************************
+* Function: slab_push
+* Description: Put object 'idx' at the front of one core's list. The CAS
+*              has release semantics, so the link is visible before the
+*              new head is.
+*****************************************************************************/
+static void slab_push(slab_pool_t *p, slab_core_t *c, uint32_t idx)
+{
+    uint64_t old;
+
+    do {
+        old = atomic_load_acquire64(&c->head);
+        p->next[idx] = SLAB_HEAD_IDX(old);
+    } while (!atomic_cas64(&c->head, old, SLAB_HEAD(SLAB_HEAD_TAG(old) + 1, idx)));
+}
+
+/******************************************************************************
+* Function: slab_index
+* Description: Index of 'obj' in the pool
+* Returns: the index, or SLAB_NIL if 'obj' is not the start of an object
+*****************************************************************************/
+static uint32_t slab_index(const slab_pool_t *p, const void *obj)
+{
+    uint64_t off = (uint64_t)((const uint8_t *)obj - p->base);
+    uint32_t idx = (uint32_t)(off / p->obj_size);
+
+    if ((const uint8_t *)obj < p->base || idx >= p->count ||
+        (uint64_t)idx * p->obj_size != off) {
+        return SLAB_NIL;
+    }
+    return idx;
+}
+
+/******************************************************************************
+* Function: slab_pool_create
+* Description: Carve a pool descriptor, 'count' objects and their links out
+*              of the shared arena, and deal the objects out to the per-core
+*              lists in equal contiguous runs. Boot time, one core.
+* Parameters: name     - static string, used by slab_stats_print()
+*             obj_size - bytes per object (rounded up to SLAB_ALIGN)
+*             count    - number of objects
+* Returns: the pool, or 0 if the arena is exhausted or all SLAB_MAX_POOLS
+*          handle ids are taken
+*****************************************************************************/
+slab_pool_t *slab_pool_create(const char *name, uint32_t obj_size, uint32_t count)
+{
+    if (count == 0 || count > SLAB_HANDLE_IDX_MASK) return 0;
+
+    uint32_t id = atomic_fetch_add32(&slab_pool_ids, 1) + 1;
+    if (id > SLAB_MAX_POOLS) return 0;
+
+    slab_pool_t *p = ARENA_NEW(slab_pool_t);
+    if (!p) return 0;
+
+    p->name     = name;
+    p->obj_size = (obj_size + SLAB_ALIGN - 1) & ~(uint32_t)(SLAB_ALIGN - 1);
+    p->count    = count;
+    p->id       = id;
+    p->base     = arena_alloc((uint64_t)p->obj_size * count, CACHE_LINE_SIZE);
+    p->next     = arena_alloc(sizeof(uint32_t) * count, sizeof(uint32_t));
+    if (!p->base || !p->next) return 0;
+
+    for (uint32_t c = 0; c < SLAB_CORES; c++) {
+        uint32_t first = (uint32_t)((uint64_t)count * c / SLAB_CORES);
+        uint32_t last  = (uint32_t)((uint64_t)count * (c + 1) / SLAB_CORES);
+
+        for (uint32_t i = first; i < last; i++) {
+            p->next[i] = (i + 1 < last) ? i + 1 : SLAB_NIL;
+        }
+        p->core[c].head = SLAB_HEAD(0, first < last ? first : SLAB_NIL);
+    }
+    __asm__ volatile("dmb ish" ::: "memory");
+    slab_registry[id - 1] = p;
+    return p;
+}
+
+/******************************************************************************
+* Function: slab_alloc
+* Description: One object from the calling core's list, else from the first
+*              other core's list that has one. The contents are whatever
+*              the last user left there.
+* Returns: the object, or 0 if every list is empty
+*****************************************************************************/
+void *slab_alloc(slab_pool_t *p)
+{
+    uint32_t     core = slab_core_id();
+    slab_core_t *own  = &p->core[core];
+    uint32_t     idx  = slab_pop(p, own);
+
+    if (idx == SLAB_NIL) {
+        for (uint32_t i = 1; i < SLAB_CORES && idx == SLAB_NIL; i++) {
+            idx = slab_pop(p, &p->core[(core + i) % SLAB_CORES]);
+        }
+        if (idx == SLAB_NIL) {
+            own->fails++;
+            return 0;
+        }
+        own->steals++;
+    }
+    own->allocs++;
+
+    uint32_t n  = atomic_fetch_add32(&p->in_use, 1) + 1;
+    uint32_t hw = p->high_water;
+    while (n > hw && !atomic_cas32(&p->high_water, hw, n)) {
+        hw = atomic_load_acquire32(&p->high_water);
+    }
+    return p->base + (uint64_t)idx * p->obj_size;
+}
+
+/******************************************************************************
+* Function: slab_free
+* Description: Return an object to the calling core's list. Any core may
+*              free an object any core allocated.
+* Returns: 0, or -1 if 'obj' is not the start of an object of this pool
+*****************************************************************************/
+int slab_free(slab_pool_t *p, void *obj)
+{
+    uint32_t idx = slab_index(p, obj);
+    if (idx == SLAB_NIL) return -1;
+
+    slab_core_t *own = &p->core[slab_core_id()];
+    slab_push(p, own, idx);
+    own->frees++;
+    atomic_fetch_add32(&p->in_use, (uint32_t)-1);
+    return 0;
+}
+
+/******************************************************************************
+* Function: slab_stats
+* Description: Snapshot of a pool's counters, per-core counters summed.
+*              Each core's counters are written by that core only, so the
+*              sums may be a few operations behind while others run.
+*****************************************************************************/
+void slab_stats(const slab_pool_t *p, slab_stats_t *out)
+{
+    out->obj_size   = p->obj_size;
+    out->count      = p->count;
+    out->in_use     = p->in_use;
+    out->high_water = p->high_water;
+    out->allocs = out->frees = out->fails = out->steals = 0;
+
+    for (uint32_t c = 0; c < SLAB_CORES; c++) {
+        out->allocs += p->core[c].allocs;
+        out->frees  += p->core[c].frees;
+        out->fails  += p->core[c].fails;
+        out->steals += p->core[c].steals;
+    }
+}
+
+/******************************************************************************
+* Function: slab_stats_print
+* Description: One "[SLAB] name ..." line. Caller holds the UART lock.
+*****************************************************************************/
+void slab_stats_print(const slab_pool_t *p)
+{
+    slab_stats_t st;
+    slab_stats(p, &st);
+
+    uart_puts("[SLAB] ");
+    uart_puts(p->name);
+    uart_puts(" size=");       uart_putdec(st.obj_size);
+    uart_puts(" count=");      uart_putdec(st.count);
+    uart_puts(" in_use=");     uart_putdec(st.in_use);
+    uart_puts(" high_water="); uart_putdec(st.high_water);
+    uart_puts(" allocs=");     uart_putdec(st.allocs);
+    uart_puts(" frees=");      uart_putdec(st.frees);
+    uart_puts(" fails=");      uart_putdec(st.fails);
+    uart_puts(" steals=");     uart_putdec(st.steals);
+    uart_puts("\n");
+}
+
+/******************************************************************************
+* Function: slab_handle
+* Description: Handle for an object of pool 'p', for passing it to another
+*              core by value
+* Returns: the handle, or SLAB_HANDLE_NONE if 'obj' is not in the pool
+*****************************************************************************/
+uint32_t slab_handle(const slab_pool_t *p, const void *obj)
+{
+    uint32_t idx = slab_index(p, obj);
+    return (idx == SLAB_NIL) ? SLAB_HANDLE_NONE
+                             : (p->id << SLAB_HANDLE_IDX_BITS) | idx;
+}
+
+/******************************************************************************
+* Function: slab_handle_obj
+* Description: Resolve a handle; the object is not checked for being in use
+* Parameters: handle - from slab_handle()
+*             pool   - if not 0, receives the owning pool
+* Returns: the object, or 0 if the handle names no pool or is out of range
+*****************************************************************************/
+void *slab_handle_obj(uint32_t handle, slab_pool_t **pool)
+{
+    uint32_t id  = handle >> SLAB_HANDLE_IDX_BITS;
+    uint32_t idx = handle & SLAB_HANDLE_IDX_MASK;
+
+    if (id == 0 || id > SLAB_MAX_POOLS) return 0;
+
+    slab_pool_t *p = slab_registry[id - 1];
+    if (!p || idx >= p->count) return 0;
+
+    if (pool) *pool = p;
+    return p->base + (uint64_t)idx * p->obj_size;
+}
+
+/******************************************************************************
+* Function: slab_handle_free
+* Description: slab_free() by handle
+* Returns: 0, or -1 if the handle is invalid
+*****************************************************************************/
+int slab_handle_free(uint32_t handle)
+{
+    slab_pool_t *p;
+    void *obj = slab_handle_obj(handle, &p);
+
+    return obj ? slab_free(p, obj) : -1;
+}
+
+/******************************************************************************
+* Function: slab_msg_pools_init
+* Description: Create the small and large message-buffer pools
+* Returns: 0 on success, -1 if the arena is too small
+*****************************************************************************/
+int slab_msg_pools_init(void)
+{
+    slab_msg_small = slab_pool_create("msg_small", SLAB_MSG_SMALL_SIZE, SLAB_MSG_SMALL_COUNT);
+    slab_msg_large = slab_pool_create("msg_large", SLAB_MSG_LARGE_SIZE, SLAB_MSG_LARGE_COUNT);
+    return (slab_msg_small && slab_msg_large) ? 0 : -1;
+}
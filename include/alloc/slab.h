@@ -0,0 +1,104 @@
+/******************************************************************************
+* File: slab.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Fixed-size object pools with lock-free per-core free lists
+*
+* A pool is 'count' objects of one size, carved from the shared arena
+* (arena.h) at boot together with its descriptor. Every core has its own
+* free list, a Treiber stack whose head packs a 32-bit ABA tag with the
+* index of the first free object:
+*
+*   slab_alloc()  pops the calling core's list; if that is empty it takes
+*                 one object from each other core's list in turn
+*   slab_free()   pushes onto the calling core's list, so a buffer freed by
+*                 the receiver of a message is reused by the receiver
+*
+* Both are O(1) (at most SLAB_CORES lists are looked at) and take no
+* lock; the only shared write besides the list heads is the in_use
+* counter that feeds the high-water mark. Links live in a separate array,
+* so a free object's payload is never written by the pool.
+*
+* A handle names an object without a pointer, so it can travel inside a
+* message (ipc.h, mailbox_send_buf): [31:24] pool id, [23:0] index.
+* Pool ids start at 1, so SLAB_HANDLE_NONE (0) is never a valid handle.
+*
+* The message-buffer pools (slab_msg_small / slab_msg_large) are created
+* by slab_msg_pools_init() on Core 0 before the secondaries start.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef SLAB_H
+#define SLAB_H
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stdint.h>
+#include "ipc/atomic.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define SLAB_CORES              4
+#define SLAB_ALIGN              16              /* object size granularity */
+#define SLAB_NIL                0xFFFFFFFFu     /* empty list              */
+#define SLAB_MAX_POOLS          8               /* pools with a handle id  */
+#define SLAB_HANDLE_NONE        0u
+#define SLAB_HANDLE_IDX_BITS    24
+#define SLAB_HANDLE_IDX_MASK    ((1u << SLAB_HANDLE_IDX_BITS) - 1)
+
+#define SLAB_MSG_SMALL_SIZE     64
+#define SLAB_MSG_SMALL_COUNT    128
+#define SLAB_MSG_LARGE_SIZE     512
+#define SLAB_MSG_LARGE_COUNT    32
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+/* One line per core: the list head plus counters only that core writes */
+typedef struct {
+    volatile uint64_t head;         /* [63:32] ABA tag, [31:0] index / NIL */
+    uint64_t          allocs;
+    uint64_t          frees;
+    uint64_t          fails;        /* every list was empty                */
+    uint64_t          steals;       /* served from another core's list     */
+} __attribute__((aligned(CACHE_LINE_SIZE))) slab_core_t;
+
+typedef struct {
+    slab_core_t        core[SLAB_CORES];
+    const char        *name;
+    uint8_t           *base;        /* object i at base + i * obj_size     */
+    volatile uint32_t *next;        /* free-list link of object i          */
+    uint32_t           obj_size;    /* rounded up to SLAB_ALIGN            */
+    uint32_t           count;
+    uint32_t           id;          /* 1..SLAB_MAX_POOLS, handle [31:24]   */
+    volatile uint32_t  in_use;
+    volatile uint32_t  high_water;
+} slab_pool_t;
+
+typedef struct {
+    uint32_t obj_size, count, in_use, high_water;
+    uint64_t allocs, frees, fails, steals;      /* summed over all cores   */
+} slab_stats_t;
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+extern slab_pool_t *slab_msg_small;
+extern slab_pool_t *slab_msg_large;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+slab_pool_t *slab_pool_create(const char *name, uint32_t obj_size, uint32_t count);
+void        *slab_alloc(slab_pool_t *p);
+int          slab_free(slab_pool_t *p, void *obj);
+void         slab_stats(const slab_pool_t *p, slab_stats_t *out);
+void         slab_stats_print(const slab_pool_t *p);
+int          slab_msg_pools_init(void);
+
+uint32_t     slab_handle(const slab_pool_t *p, const void *obj);
+void        *slab_handle_obj(uint32_t handle, slab_pool_t **pool);
+int          slab_handle_free(uint32_t handle);
+
+#endif /* SLAB_H */
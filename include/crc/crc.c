@@ -0,0 +1,240 @@
+/******************************************************************************
+* File: crc.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: CRC-16/MODBUS, CRC-32 and CRC-32C, see crc.h
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "crc/crc.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define CRC16_POLY      0xA001u
+#define CRC32_POLY      0xEDB88320u
+#define CRC32C_POLY     0x82F63B78u
+#define CRC_SLICES      8
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+/* 8-byte load from a byte buffer (AArch64 is little-endian) */
+typedef uint64_t __attribute__((may_alias)) crc_word_t;
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+/* t[k][b]: CRC of byte b followed by k zero bytes */
+static uint16_t crc16_table[CRC_SLICES][256];
+static uint32_t crc32_table[CRC_SLICES][256];
+static uint32_t crc32c_table[CRC_SLICES][256];
+static uint8_t  crc_tables_ready;
+static int      crc_backend;            /* CRC_BACKEND_TABLE until selected */
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+static void crc32_table_build(uint32_t (*t)[256], uint32_t poly)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int b = 0; b < 8; b++) c = (c & 1) ? (c >> 1) ^ poly : c >> 1;
+        t[0][i] = c;
+    }
+    for (uint32_t k = 1; k < CRC_SLICES; k++) {
+        for (uint32_t i = 0; i < 256; i++) {
+            t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+        }
+    }
+}
+
+static void crc_tables_init(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint16_t c = (uint16_t)i;
+        for (int b = 0; b < 8; b++) c = (c & 1) ? (uint16_t)((c >> 1) ^ CRC16_POLY) : (uint16_t)(c >> 1);
+        crc16_table[0][i] = c;
+    }
+    for (uint32_t k = 1; k < CRC_SLICES; k++) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint16_t c = crc16_table[k - 1][i];
+            crc16_table[k][i] = (uint16_t)((c >> 8) ^ crc16_table[0][c & 0xFF]);
+        }
+    }
+    crc32_table_build(crc32_table, CRC32_POLY);
+    crc32_table_build(crc32c_table, CRC32C_POLY);
+    crc_tables_ready = 1;
+}
+
+static int cpu_has_crc32(void)
+{
+    uint64_t isar0;
+
+    /* ID_AA64ISAR0_EL1.CRC32 [19:16]: 0 = none, 1 = CRC32 / CRC32C */
+    __asm__ volatile("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+    return ((isar0 >> 16) & 0xF) != 0;
+}
+
+/******************************************************************************
+* Function: crc_select_backend
+* Description: Build the tables and pick the CRC-32 backend for this CPU.
+*              Call once at boot, before other cores use the module.
+* Returns: the selected CRC_BACKEND_*
+*****************************************************************************/
+int crc_select_backend(void)
+{
+    if (!crc_tables_ready) crc_tables_init();
+    crc_backend = cpu_has_crc32() ? CRC_BACKEND_HW : CRC_BACKEND_TABLE;
+    return crc_backend;
+}
+
+/******************************************************************************
+* Function: crc_set_backend
+* Description: Force a CRC-32 backend (tests / benchmarks)
+* Returns: 0, or -1 if the CPU lacks the CRC32 instructions
+*****************************************************************************/
+int crc_set_backend(int backend)
+{
+    if (backend == CRC_BACKEND_HW && !cpu_has_crc32()) return -1;
+    if (!crc_tables_ready) crc_tables_init();
+    crc_backend = backend;
+    return 0;
+}
+
+int crc_get_backend(void)
+{
+    return crc_backend;
+}
+
+/******************************************************************************
+* Function: crc32_slice8
+* Description: Reflected 32-bit CRC, slicing-by-8: bytes up to an 8-byte
+*              boundary, then one aligned 64-bit load and eight independent
+*              lookups per word, then the tail
+*****************************************************************************/
+static uint32_t crc32_slice8(const uint32_t (*t)[256], uint32_t crc,
+                             const uint8_t *p, uint32_t len)
+{
+    while (len && ((uintptr_t)p & 7)) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+        len--;
+    }
+    for (; len >= 8; len -= 8, p += 8) {
+        uint64_t x = *(const crc_word_t *)p ^ crc;
+        crc = t[7][x & 0xFF]         ^ t[6][(x >> 8) & 0xFF]  ^
+              t[5][(x >> 16) & 0xFF] ^ t[4][(x >> 24) & 0xFF] ^
+              t[3][(x >> 32) & 0xFF] ^ t[2][(x >> 40) & 0xFF] ^
+              t[1][(x >> 48) & 0xFF] ^ t[0][x >> 56];
+    }
+    while (len--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    return crc;
+}
+
+/* ARMv8 CRC32 instructions, same alignment split as crc32_slice8() */
+static uint32_t crc32_hw(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+    while (len && ((uintptr_t)p & 7)) {
+        __asm__("crc32b %w0, %w0, %w1" : "+r"(crc) : "r"((uint32_t)*p++));
+        len--;
+    }
+    for (; len >= 8; len -= 8, p += 8) {
+        __asm__("crc32x %w0, %w0, %x1" : "+r"(crc) : "r"(*(const crc_word_t *)p));
+    }
+    while (len--) __asm__("crc32b %w0, %w0, %w1" : "+r"(crc) : "r"((uint32_t)*p++));
+    return crc;
+}
+
+static uint32_t crc32c_hw(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+    while (len && ((uintptr_t)p & 7)) {
+        __asm__("crc32cb %w0, %w0, %w1" : "+r"(crc) : "r"((uint32_t)*p++));
+        len--;
+    }
+    for (; len >= 8; len -= 8, p += 8) {
+        __asm__("crc32cx %w0, %w0, %x1" : "+r"(crc) : "r"(*(const crc_word_t *)p));
+    }
+    while (len--) __asm__("crc32cb %w0, %w0, %w1" : "+r"(crc) : "r"((uint32_t)*p++));
+    return crc;
+}
+
+/******************************************************************************
+* Function: crc16_modbus_update
+* Description: Feed 'len' bytes into a CRC-16/MODBUS register (start with
+*              CRC16_MODBUS_INIT). The ADU carries the result low byte first.
+*****************************************************************************/
+uint16_t crc16_modbus_update(uint16_t crc, const uint8_t *p, uint32_t len)
+{
+    const uint16_t (*t)[256] = crc16_table;
+
+    if (!crc_tables_ready) crc_tables_init();
+
+    while (len && ((uintptr_t)p & 7)) {
+        crc = (uint16_t)((crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF]);
+        len--;
+    }
+    for (; len >= 8; len -= 8, p += 8) {
+        uint64_t x = *(const crc_word_t *)p ^ crc;
+        crc = t[7][x & 0xFF]         ^ t[6][(x >> 8) & 0xFF]  ^
+              t[5][(x >> 16) & 0xFF] ^ t[4][(x >> 24) & 0xFF] ^
+              t[3][(x >> 32) & 0xFF] ^ t[2][(x >> 40) & 0xFF] ^
+              t[1][(x >> 48) & 0xFF] ^ t[0][x >> 56];
+    }
+    while (len--) crc = (uint16_t)((crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF]);
+    return crc;
+}
+
+/******************************************************************************
+* Function: crc32_update / crc32c_update
+* Description: Feed 'len' bytes into a CRC-32 / CRC-32C register (start with
+*              CRC32_INIT, finish with crc32_final)
+*****************************************************************************/
+uint32_t crc32_update(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+    if (crc_backend == CRC_BACKEND_HW) return crc32_hw(crc, p, len);
+    if (!crc_tables_ready) crc_tables_init();
+    return crc32_slice8((const uint32_t (*)[256])crc32_table, crc, p, len);
+}
+
+uint32_t crc32c_update(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+    if (crc_backend == CRC_BACKEND_HW) return crc32c_hw(crc, p, len);
+    if (!crc_tables_ready) crc_tables_init();
+    return crc32_slice8((const uint32_t (*)[256])crc32c_table, crc, p, len);
+}
+
+/******************************************************************************
+* Function: crc16_modbus_bitwise / crc32_bitwise / crc32c_bitwise
+* Description: The definitions, one bit per step. Reference only.
+*****************************************************************************/
+uint16_t crc16_modbus_bitwise(uint16_t crc, const uint8_t *p, uint32_t len)
+{
+    while (len--) {
+        crc ^= *p++;
+        for (int b = 0; b < 8; b++) crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ CRC16_POLY) : (uint16_t)(crc >> 1);
+    }
+    return crc;
+}
+
+static uint32_t crc32_bitwise_poly(uint32_t crc, const uint8_t *p, uint32_t len, uint32_t poly)
+{
+    while (len--) {
+        crc ^= *p++;
+        for (int b = 0; b < 8; b++) crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+    }
+    return crc;
+}
+
+uint32_t crc32_bitwise(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+    return crc32_bitwise_poly(crc, p, len, CRC32_POLY);
+}
+
+uint32_t crc32c_bitwise(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+    return crc32_bitwise_poly(crc, p, len, CRC32C_POLY);
+}
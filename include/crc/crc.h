@@ -0,0 +1,82 @@
+/******************************************************************************
+* File: crc.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: CRC-16/MODBUS, CRC-32 and CRC-32C
+*
+*   CRC-16/MODBUS   poly 0x8005 reflected (0xA001), init 0xFFFF, no xorout
+*   CRC-32          poly 0x04C11DB7 reflected (0xEDB88320), init / xorout ~0
+*   CRC-32C         poly 0x1EDC6F41 reflected (0x82F63B78), init / xorout ~0
+*
+* CRC-16 is table driven, slicing-by-8: one 64-bit load and eight lookups
+* per 8 bytes. CRC-32 / CRC-32C use the ARMv8 CRC32 instructions (crc32x /
+* crc32cx, 8 bytes per instruction) when ID_AA64ISAR0_EL1.CRC32 reports
+* them, else the same slicing-by-8 tables. Every backend gives bit-identical
+* results; the *_bitwise() versions are the one-bit-at-a-time definitions,
+* kept as the reference for tests and benchmarks.
+*
+* Streaming: *_update() takes and returns the raw register, so a message
+* may be fed in any number of pieces:
+*
+*   uint32_t c = CRC32_INIT;
+*   c = crc32_update(c, hdr, hdr_len);
+*   c = crc32_update(c, body, body_len);
+*   c = crc32_final(c);                       (== crc32(whole message))
+*
+* CRC-16/MODBUS has no final xor, so its register is the result.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef CRC_H
+#define CRC_H
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stdint.h>
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define CRC16_MODBUS_INIT   0xFFFFu
+#define CRC32_INIT          0xFFFFFFFFu
+
+#define CRC_BACKEND_TABLE   0       /* slicing-by-8, always available    */
+#define CRC_BACKEND_HW      1       /* crc32x / crc32cx (CRC-32 / -32C)   */
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+int      crc_select_backend(void);
+int      crc_set_backend(int backend);
+int      crc_get_backend(void);
+
+uint16_t crc16_modbus_update(uint16_t crc, const uint8_t *p, uint32_t len);
+uint32_t crc32_update(uint32_t crc, const uint8_t *p, uint32_t len);
+uint32_t crc32c_update(uint32_t crc, const uint8_t *p, uint32_t len);
+
+/* Bitwise references */
+uint16_t crc16_modbus_bitwise(uint16_t crc, const uint8_t *p, uint32_t len);
+uint32_t crc32_bitwise(uint32_t crc, const uint8_t *p, uint32_t len);
+uint32_t crc32c_bitwise(uint32_t crc, const uint8_t *p, uint32_t len);
+
+static inline uint32_t crc32_final(uint32_t crc)
+{
+    return ~crc;
+}
+
+static inline uint16_t crc16_modbus(const uint8_t *p, uint32_t len)
+{
+    return crc16_modbus_update(CRC16_MODBUS_INIT, p, len);
+}
+
+static inline uint32_t crc32(const uint8_t *p, uint32_t len)
+{
+    return crc32_final(crc32_update(CRC32_INIT, p, len));
+}
+
+static inline uint32_t crc32c(const uint8_t *p, uint32_t len)
+{
+    return crc32_final(crc32c_update(CRC32_INIT, p, len));
+}
+
+#endif /* CRC_H */
@@ -10,7 +10,10 @@
 #include <stdbool.h>
 #include "crypto/hmac_sha256.h"
 #include "crypto/sha256.h"
+#include "crypto/tc_defs.h"
 #include "uart/uart0.h"
+#include "pmu/pmu.h"
+#include "alloc/arena.h"
 
 /**************************************************
  * MACRO DEFINITIONS
@@ -19,30 +22,83 @@
 /**************************************************
  * GLOBAL VARIABLES
  ***************************************************/
+static volatile hmac_ctx_t *hmac_ctx;      /* shared arena, hmac_key_init() */
 
 /**************************************************
  * HELPER FUNCTIONS
  ***************************************************/
+
+/******************************************************************************
+* Function: hmac_pad_midstate
+* Description: SHA-256 state after hashing one block of (K zero-padded) ^ pad
+*****************************************************************************/
+static void hmac_pad_midstate(const uint8_t key[HMAC_KEY_SIZE], uint8_t pad,
+                              volatile unsigned int iv_out[TC_SHA256_STATE_BLOCKS])
+{
+    uint8_t  block[64];
+    struct tc_sha256_state_struct state;
+
+    for (unsigned int i = 0; i < 32; i++)  block[i] = key[i] ^ pad;
+    for (unsigned int i = 32; i < 64; i++) block[i] = pad;      /* 0x00 ^ pad */
+
+    tc_sha256_init(&state);
+    tc_sha256_update(&state, block, 64);   /* exactly one compress */
+    for (unsigned int i = 0; i < TC_SHA256_STATE_BLOCKS; i++) iv_out[i] = state.iv[i];
+
+    _set(block, 0x00, sizeof(block));      /* don't leave K ^ pad on the stack */
+}
+
+/******************************************************************************
+* Function: hmac_resume
+* Description: Load a cached midstate as if 64 bytes had already been hashed
+*****************************************************************************/
+static void hmac_resume(TCSha256State_t s, const volatile unsigned int iv[TC_SHA256_STATE_BLOCKS])
+{
+    for (unsigned int i = 0; i < TC_SHA256_STATE_BLOCKS; i++) s->iv[i] = iv[i];
+    s->bits_hashed     = TC_SHA256_BLOCK_SIZE << 3;
+    s->leftover_offset = 0;
+}
+
 void hmac_key_init(const uint8_t key[HMAC_KEY_SIZE])
 {
-    volatile uint8_t *copy_key = ((volatile uint8_t*) HMAC_KEY_ADDR);
+    if (!hmac_ctx) hmac_ctx = ARENA_NEW(hmac_ctx_t);
+    if (!hmac_ctx) {
+        uart_puts("[HMAC] Shared arena exhausted, halting\n");
+        while (1) { __asm__ volatile("wfe"); }
+    }
+
+    volatile hmac_ctx_t *ctx = hmac_ctx;
     for(unsigned i = 0; i < 32; i++) {
-        *(copy_key + i) = key[i];
+        ctx->key[i] = key[i];
     }
 
+    hmac_pad_midstate(key, HMAC_IPAD, ctx->inner_iv);
+    hmac_pad_midstate(key, HMAC_OPAD, ctx->outer_iv);
+
     // data memory barrier asm instruction
     __asm__ volatile("dmb sy" ::: "memory");
     uart_puts("[CRYPTO] HMAC key loaded\n"); // Assist instruction
 } 
 
-void hmac_tag_compute(const volatile mailbox_t *mb, uint8_t tag_out[HMAC_TAG_SIZE])
+/******************************************************************************
+* Function: hmac_tag_compute
+* Description: Tag over the message header and, when a pool buffer is
+*              attached, over the buffer fields and the payload too:
+*                no buffer:  4 header words            (16 bytes)
+*                buffer:     4 header words + handle + off|len + payload
+*              The two inputs differ in length, so neither can be passed
+*              off as the other.
+* Parameters: mb      - message (tag[] is not read)
+*             payload - mb->buf_len bytes, ignored without a buffer
+*****************************************************************************/
+void hmac_tag_compute(const mailbox_msg_t *mb, const uint8_t *payload,
+                      uint8_t tag_out[HMAC_TAG_SIZE])
 {
-    uint8_t  k_padded[64];       // key zero-padded to SHA-256 block size
-    uint8_t  ipad_key[64];       // k_padded XOR 0x36
-    uint8_t  opad_key[64];       // k_padded XOR 0x5C
-    uint8_t  msg[16];            // the 4 mailbox fields as raw bytes
+    uint8_t  msg[24];            // the mailbox fields as raw bytes
     uint8_t  inner_hash[32];     // result of inner SHA-256
     struct tc_sha256_state_struct state;
+
+    PMU_PROBE_BEGIN(PMU_PROBE_HMAC_TAG);
     // Copy all the fields into the msg[] array
     /* sender_id = 0x01020304 */
     msg[0] = (uint8_t)(mb->sender_id >> 24);  /* 0x01 */
@@ -68,37 +124,47 @@ void hmac_tag_compute(const volatile mailbox_t *mb, uint8_t tag_out[HMAC_TAG_SIZ
     msg[14] = (uint8_t)(mb->counter >> 8);
     msg[15] = (uint8_t)(mb->counter);
 
-    /* k_padded init with HMAC_KEY_ADDR values*/
-    /* First for loop copies the first HMAC_KEY_ADDR with the first half*/
-    /* Second for copies full 0 into the other half */
-    for (unsigned int i = 0; i < 32; i++) k_padded[i] = HMAC_KEY_ADDR[i];
-    for (unsigned int i = 32; i < 64; i++) k_padded[i] = 0x00;
+    /* buffer handle, offset, length */
+    msg[16] = (uint8_t)(mb->buf_handle >> 24);
+    msg[17] = (uint8_t)(mb->buf_handle >> 16);
+    msg[18] = (uint8_t)(mb->buf_handle >> 8);
+    msg[19] = (uint8_t)(mb->buf_handle);
+    msg[20] = (uint8_t)(mb->buf_off >> 8);
+    msg[21] = (uint8_t)(mb->buf_off);
+    msg[22] = (uint8_t)(mb->buf_len >> 8);
+    msg[23] = (uint8_t)(mb->buf_len);
 
-    /* ipad_key = (000000HMAC_KEY_ADDR) ^ 0x36 */
-    for (unsigned int i = 0; i < 64; i++) ipad_key[i] = k_padded[i] ^ HMAC_IPAD;
-    tc_sha256_init(&state);
-    tc_sha256_update(&state, ipad_key, 64);
-    tc_sha256_update(&state, msg, 16);
+    int has_buf = (mb->buf_handle != MSG_BUF_NONE);
+
+    /* inner = SHA256((K ^ ipad) || msg [|| payload]) — resume after ipad */
+    hmac_resume(&state, hmac_ctx->inner_iv);
+    tc_sha256_update(&state, msg, has_buf ? sizeof(msg) : 16);
+    if (has_buf && mb->buf_len) tc_sha256_update(&state, payload, mb->buf_len);
     tc_sha256_final(inner_hash, &state);
 
-    /* opad_key = (000000HMAC_KEY_ADDR) ^ 0x5C */
-    for (unsigned int i = 0; i < 64; i++) opad_key[i] = k_padded[i] ^ HMAC_OPAD;
-    tc_sha256_init(&state);
-    tc_sha256_update(&state, opad_key, 64);
+    /* tag = SHA256((K ^ opad) || inner) — resume after the opad block */
+    hmac_resume(&state, hmac_ctx->outer_iv);
     tc_sha256_update(&state, inner_hash, 32);
     tc_sha256_final(tag_out, &state);
+    PMU_PROBE_END(PMU_PROBE_HMAC_TAG);
 }
 
-int hmac_tag_verify(const volatile mailbox_t *mb)
+/******************************************************************************
+* Function: hmac_tag_verify
+* Description: Recompute the tag (same inputs as hmac_tag_compute) and
+*              compare it with mb->tag in constant time
+* Returns: 1 if the tag matches, 0 otherwise
+*****************************************************************************/
+int hmac_tag_verify(const mailbox_msg_t *mb, const uint8_t *payload)
 {
     uint8_t  expected[32];       // used in the verify hmac function
     uint8_t change = 0x00;
 
-    hmac_tag_compute(mb, expected);
+    hmac_tag_compute(mb, payload, expected);
     for(unsigned i = 0; i < 32; i++) {
         expected[i] = expected[i] ^ mb->tag[i];
         change |= expected[i];
     }
 
     return (change == 0x00);
-}
\ No newline at end of file
+}
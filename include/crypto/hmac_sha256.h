@@ -2,7 +2,7 @@
  * File: include/crypto/hmac_sha256.h
  * Project: RPi5-Industrial-Gateway Bare Metal Development
  * Description: HMAC-SHA256 inter-core message authentication
- *              Operates on mailbox_t — no dynamic allocation
+ *              Operates on mailbox_msg_t — no dynamic allocation
  * Copyright (c) 2026 Maior Cristian
  ******************************************************************************/
 #ifndef HMAC_SHA256_H
@@ -13,6 +13,7 @@
  ***************************************************/
 #include <stdint.h>
 #include "ipc/ipc.h"
+#include "crypto/sha256.h"
 //Todo : Implement TinyCrypt SHA-256
 //#include "crypto/tc_sha256.h"   /* TinyCrypt SHA-256 — Intel, BSD-2 */
 
@@ -24,17 +25,32 @@
 #define HMAC_IPAD        0x36
 #define HMAC_OPAD        0x5C
 
-/* Fixed address in shared RAM — 8-byte aligned after ring buffer */
 /* RFC 2104 standard */
-#define HMAC_KEY_ADDR    ((const uint8_t *)0x40220310)
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+/*
+ * The key never changes after hmac_key_init(), so SHA-256 of the two
+ * 64-byte pad blocks is done once there. A tag then costs 2 compress
+ * calls (inner msg block + outer digest block) instead of 4.
+ * Size: 32 + 32 + 32 = 96 bytes, carved from the shared arena by
+ * hmac_key_init().
+ */
+typedef struct {
+    uint8_t      key[HMAC_KEY_SIZE];
+    unsigned int inner_iv[TC_SHA256_STATE_BLOCKS];  /* state after K ^ ipad */
+    unsigned int outer_iv[TC_SHA256_STATE_BLOCKS];  /* state after K ^ opad */
+} hmac_ctx_t;
 
 /**************************************************
  * FUNCTION PROTOTYPES
  ***************************************************/
 
 void hmac_key_init(const uint8_t key[HMAC_KEY_SIZE]);
-void hmac_tag_compute(const volatile mailbox_t *mb, uint8_t tag_out[HMAC_TAG_SIZE]);
-int hmac_tag_verify(const volatile mailbox_t *mb);
+void hmac_tag_compute(const mailbox_msg_t *mb, const uint8_t *payload,
+                      uint8_t tag_out[HMAC_TAG_SIZE]);
+int hmac_tag_verify(const mailbox_msg_t *mb, const uint8_t *payload);
 
 
 #endif /* HMAC_SHA256_H */
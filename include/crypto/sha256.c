@@ -36,8 +36,46 @@
 /* necessary addition that does not corrupt the copyright*/
 #include "crypto/tc_defs.h"
 #include "crypto/sha256.h"
+#include "pmu/pmu.h"
 
 static void compress(unsigned int *iv, const uint8_t *data);
+static void compress_scalar(unsigned int *iv, const uint8_t *data);
+
+/* ARMv8 Crypto Extension backend — src/sha256_ce.S (project addition) */
+extern void sha256_ce_compress(unsigned int *iv, const uint8_t *data);
+
+/* .bss — stays TC_SHA256_BACKEND_SCALAR until tc_sha256_select_backend() */
+static int sha256_backend;
+
+static int cpu_has_sha2(void)
+{
+	uint64_t isar0;
+
+	/* ID_AA64ISAR0_EL1.SHA2 [15:12]: 0 = none, 1 = SHA256, 2 = +SHA512 */
+	__asm__ volatile("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+	return ((isar0 >> 12) & 0xF) != 0;
+}
+
+int tc_sha256_select_backend(void)
+{
+	sha256_backend = cpu_has_sha2() ? TC_SHA256_BACKEND_CE
+					: TC_SHA256_BACKEND_SCALAR;
+	return sha256_backend;
+}
+
+int tc_sha256_set_backend(int backend)
+{
+	if (backend == TC_SHA256_BACKEND_CE && !cpu_has_sha2()) {
+		return TC_CRYPTO_FAIL;
+	}
+	sha256_backend = backend;
+	return TC_CRYPTO_SUCCESS;
+}
+
+int tc_sha256_get_backend(void)
+{
+	return sha256_backend;
+}
 
 int tc_sha256_init(TCSha256State_t s)
 {
@@ -182,6 +220,17 @@ static inline unsigned int BigEndian(const uint8_t **c)
 }
 
 static void compress(unsigned int *iv, const uint8_t *data)
+{
+	PMU_PROBE_BEGIN(PMU_PROBE_SHA256_COMPRESS);
+	if (sha256_backend == TC_SHA256_BACKEND_CE) {
+		sha256_ce_compress(iv, data);
+	} else {
+		compress_scalar(iv, data);
+	}
+	PMU_PROBE_END(PMU_PROBE_SHA256_COMPRESS);
+}
+
+static void compress_scalar(unsigned int *iv, const uint8_t *data)
 {
 	unsigned int a, b, c, d, e, f, g, h;
 	unsigned int s0, s1;
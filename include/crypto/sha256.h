@@ -122,6 +122,31 @@ int tc_sha256_update (TCSha256State_t s, const uint8_t *data, size_t datalen);
  */
 int tc_sha256_final(uint8_t *digest, TCSha256State_t s);
 
+/*
+ * Compression backend selection (project addition, not part of TinyCrypt).
+ * Both backends produce bit-identical digests; the scalar loop is always
+ * available, the CE backend needs ID_AA64ISAR0_EL1.SHA2 (A72 / A76).
+ */
+#define TC_SHA256_BACKEND_SCALAR (0)
+#define TC_SHA256_BACKEND_CE     (1)
+
+/**
+ *  @brief Probe ID_AA64ISAR0_EL1 and pick the fastest backend (call at boot)
+ *  @return the selected TC_SHA256_BACKEND_*
+ */
+int tc_sha256_select_backend(void);
+
+/**
+ *  @brief Force a backend (tests / benchmarks)
+ *  @return TC_CRYPTO_FAIL if the CPU lacks the requested extension
+ */
+int tc_sha256_set_backend(int backend);
+
+/**
+ *  @brief Currently active TC_SHA256_BACKEND_*
+ */
+int tc_sha256_get_backend(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,6 +8,8 @@
  * INCLUDE FILES
  ***************************************************/
  #include "interrupts/irq.h"
+ #include "scheduler/scheduler.h"
+ #include "pmu/pmu.h"
 
  /**************************************************
  * MACRO DEFINTIONS
@@ -16,11 +18,16 @@
 #define GICC_BASE  0x08010000UL
 
 #define GICD_CTLR          (*(volatile uint32_t *)(GICD_BASE + 0x000))
+#define GICD_IGROUPR(n)    (*(volatile uint32_t *)(GICD_BASE + 0x080 + (n)*4))
 #define GICD_ISENABLER(n)  (*(volatile uint32_t *)(GICD_BASE + 0x100 + (n)*4))
 #define GICD_ICENABLER(n)  (*(volatile uint32_t *)(GICD_BASE + 0x180 + (n)*4))
 #define GICD_IPRIORITYR(n) (*(volatile uint32_t *)(GICD_BASE + 0x400 + (n)*4))
 #define GICD_ITARGETSR(n)  (*(volatile uint32_t *)(GICD_BASE + 0x800 + (n)*4))
 #define GICD_ICFGR(n)      (*(volatile uint32_t *)(GICD_BASE + 0xC00 + (n)*4))
+/* Byte views of IPRIORITYR / ITARGETSR (byte-accessible in GICv2) */
+#define GICD_IPRIORITYB(n) (*(volatile uint8_t  *)(GICD_BASE + 0x400 + (n)))
+#define GICD_ITARGETSB(n)  (*(volatile uint8_t  *)(GICD_BASE + 0x800 + (n)))
+#define GICD_SGIR          (*(volatile uint32_t *)(GICD_BASE + 0xF00))
 
 #define GICC_CTLR  (*(volatile uint32_t *)(GICC_BASE + 0x000))
 #define GICC_PMR   (*(volatile uint32_t *)(GICC_BASE + 0x004))
@@ -28,19 +35,51 @@
 #define GICC_IAR   (*(volatile uint32_t *)(GICC_BASE + 0x00C))
 #define GICC_EOIR  (*(volatile uint32_t *)(GICC_BASE + 0x010))
 
+/* GICC_CTLR with groups: Group 0 → FIQ, Group 1 → IRQ, IAR acknowledges
+ * both (AckCtl), GICC_BPR governs both (CBPR) */
+#define GICC_CTLR_GROUPS   0x1Fu    /* EnableGrp0|EnableGrp1|AckCtl|FIQEn|CBPR */
+#define GICD_CTLR_GROUPS   0x03u    /* EnableGrp0|EnableGrp1                   */
+#define IRQ_SPURIOUS       1023u
+
 /**************************************************
  * GLOBAL VARIABLES
  ***************************************************/
 static irq_handler_t irq_table[IRQ_MAX_HANDLERS];
 
+/* Lean-path handlers, looked up by vector.S straight from the IAR value
+ * (irq_register_fast / irq_set_fiq). Not static: the stub reads it. */
+irq_handler_t irq_fast_table[IRQ_MAX_HANDLERS];
+
+/* Interrupt groups are writable (no Security Extensions, e.g. QEMU virt):
+ * everything is Group 1 (IRQ) except the one FIQ source */
+static uint32_t irq_groups;
+static uint32_t irq_fiq_id = IRQ_SPURIOUS;
+static uint32_t irq_fiq_core;           /* whose banked copy, for an SGI/PPI */
+
+/* Frame of the IRQ being handled on each core (NULL outside a handler) */
+static exc_frame_t *irq_frames[IRQ_MAX_CORES];
+
+/* Handlers active on each core: 1 in a handler, 2+ when preempted */
+static uint32_t irq_depth[IRQ_MAX_CORES];
+
 /**************************************************
  * HELPER FUNCTIONS
  ***************************************************/
 
+static inline uint32_t irq_core_id(void)
+{
+    uint64_t mpidr;
+    __asm__ volatile("mrs %0, mpidr_el1" : "=r"(mpidr));
+    return (uint32_t)(mpidr & 0xFF) % IRQ_MAX_CORES;
+}
+
  /******************************************************************************
 * Function: irq_init
 * Description: Initialize the GICv2 distributor and CPU interface.
-*              Masks all SPIs, sets medium priority on all INTIDs.
+*              Masks all SPIs, sets medium priority on all INTIDs and puts
+*              them all in Group 1 (IRQ), which leaves Group 0 for the FIQ
+*              source. Where the groups are Secure-only (IGROUPR reads
+*              back 0) the single-group setup is kept and there is no FIQ.
 *****************************************************************************/
 void irq_init(void)
 {
@@ -54,10 +93,40 @@ void irq_init(void)
         GICD_ITARGETSR(i) = 0x01010101u;        /* route all SPIs → CPU0  */
     for (i = 2; i < 8; i++)
         GICD_ICFGR(i) = 0x00000000u;            /* level-sensitive        */
-    GICD_CTLR = 1u;                             /* enable distributor     */
-    GICC_PMR  = 0xFFu;                          /* pass all priorities    */
-    GICC_BPR  = 0x00u;
-    GICC_CTLR = 1u;                             /* enable CPU interface   */
+    for (i = 0; i < 8; i++)
+        GICD_IGROUPR(i) = 0xFFFFFFFFu;          /* all Group 1 (IRQ)      */
+    irq_groups = (GICD_IGROUPR(0) != 0);
+    GICD_CTLR = irq_groups ? GICD_CTLR_GROUPS : 1u;  /* enable distributor */
+    GICC_PMR  = IRQ_PRIO_MASK_ALL;              /* pass all priorities    */
+    GICC_BPR  = IRQ_BPR_DEFAULT;
+    GICC_CTLR = irq_groups ? GICC_CTLR_GROUPS : 1u;  /* enable CPU interface */
+}
+
+/******************************************************************************
+* Function: irq_init_cpu
+* Description: Per-core half of the GIC setup: the CPU interface and the
+*              SGI/PPI priority registers are banked, so every core that
+*              wants PPIs (e.g. its own timer, INTID 30) must run this.
+*              irq_init() already covers Core 0. Banked priorities go back
+*              to the default, except that a banked FIQ source this core
+*              set up with irq_set_fiq() stays Group 0 at IRQ_PRIO_CRITICAL
+*              (sched_run() calls this after bench/test setup did so).
+*****************************************************************************/
+void irq_init_cpu(void)
+{
+    uint32_t i;
+    for (i = 0; i < 8; i++)
+        GICD_IPRIORITYR(i) = 0xA0A0A0A0u;      /* banked SGI/PPI priority */
+    if (irq_groups) {
+        GICD_IGROUPR(0) = 0xFFFFFFFFu;          /* banked SGI/PPI group    */
+        if (irq_fiq_id < IRQ_SPI_BASE && irq_fiq_core == irq_core_id()) {
+            irq_set_priority(irq_fiq_id, IRQ_PRIO_CRITICAL);
+            GICD_IGROUPR(0) &= ~(1u << irq_fiq_id);
+        }
+    }
+    GICC_PMR  = IRQ_PRIO_MASK_ALL;
+    GICC_BPR  = IRQ_BPR_DEFAULT;
+    GICC_CTLR = irq_groups ? GICC_CTLR_GROUPS : 1u;
 }
 
 /******************************************************************************
@@ -68,10 +137,159 @@ void irq_init(void)
 void irq_register_handler(uint32_t irq_id, irq_handler_t handler)
 {
     if (irq_id >= IRQ_MAX_HANDLERS) return;
+    irq_fast_table[irq_id] = 0;
     irq_table[irq_id] = handler;
     GICD_ISENABLER(irq_id / 32u) = (1u << (irq_id % 32u));
 }
 
+/******************************************************************************
+* Function: irq_register_fast
+* Description: Register a lean-path handler: vector.S saves only the
+*              caller-saved registers and calls it straight from the IAR
+*              value, with IRQs and FIQs masked. No nesting, no PMU probe,
+*              no irq_current_frame() and no task switch afterwards, so it
+*              must be short and must not block or yield.
+* Returns: 0, or -1 if irq_id is out of range
+*****************************************************************************/
+int irq_register_fast(uint32_t irq_id, irq_handler_t handler)
+{
+    if (irq_id >= IRQ_MAX_HANDLERS) return -1;
+    irq_table[irq_id] = 0;
+    irq_fast_table[irq_id] = handler;
+    __asm__ volatile("dmb ish" ::: "memory");  /* entry before the enable */
+    GICD_ISENABLER(irq_id / 32u) = (1u << (irq_id % 32u));
+    return 0;
+}
+
+/******************************************************************************
+* Function: irq_set_fiq
+* Description: Make 'irq_id' the FIQ source: Group 0 at IRQ_PRIO_CRITICAL,
+*              handled on the lean path, and FIQs unmasked on the calling
+*              core. A previous FIQ source goes back to Group 1 and keeps
+*              its lean handler. For an SGI/PPI this is the calling core's
+*              banked copy, which a later irq_init_cpu() on that core
+*              keeps; route an SPI with irq_set_affinity().
+* Returns: 0, or -1 if irq_id is out of range or the GIC does not let
+*          this core change groups (Group 0 is Secure-owned)
+*****************************************************************************/
+int irq_set_fiq(uint32_t irq_id, irq_handler_t handler)
+{
+    if (irq_id >= IRQ_MAX_HANDLERS || !irq_groups) return -1;
+
+    uint32_t old = irq_fiq_id;
+    if (old < IRQ_MAX_HANDLERS && old != irq_id)
+        GICD_IGROUPR(old / 32u) |= 1u << (old % 32u);
+
+    irq_set_priority(irq_id, IRQ_PRIO_CRITICAL);
+    GICD_IGROUPR(irq_id / 32u) &= ~(1u << (irq_id % 32u));
+    irq_fiq_id   = irq_id;
+    irq_fiq_core = irq_core_id();
+    irq_register_fast(irq_id, handler);
+    __asm__ volatile("msr daifclr, #1" ::: "memory");
+    return 0;
+}
+
+/******************************************************************************
+* Function: irq_set_priority / irq_get_priority
+* Description: Priority of one INTID (lower = more urgent). SGIs and PPIs
+*              (below IRQ_SPI_BASE) are banked, so this only sets the
+*              calling core's copy, and irq_init_cpu() resets it: call it
+*              afterwards. The GIC drops the low bits it does not implement.
+* Returns: 0, or -1 if irq_id is out of range
+*****************************************************************************/
+int irq_set_priority(uint32_t irq_id, uint8_t prio)
+{
+    if (irq_id >= IRQ_MAX_HANDLERS) return -1;
+    GICD_IPRIORITYB(irq_id) = prio;
+    return 0;
+}
+
+uint8_t irq_get_priority(uint32_t irq_id)
+{
+    return (irq_id < IRQ_MAX_HANDLERS) ? GICD_IPRIORITYB(irq_id) : 0xFFu;
+}
+
+/******************************************************************************
+* Function: irq_set_affinity
+* Description: Route an SPI to the cores in 'cpu_mask' (bit n = core n).
+*              In GICv2 1-of-N mode the distributor hands each assertion
+*              to one of them. Takes effect for the next assertion.
+* Returns: 0, or -1 for an SGI/PPI (fixed to its own core), an
+*          out-of-range INTID or an empty mask
+*****************************************************************************/
+int irq_set_affinity(uint32_t irq_id, uint8_t cpu_mask)
+{
+    if (irq_id < IRQ_SPI_BASE || irq_id >= IRQ_MAX_HANDLERS) return -1;
+    if ((cpu_mask & ((1u << IRQ_MAX_CORES) - 1)) == 0) return -1;
+    GICD_ITARGETSB(irq_id) = cpu_mask;
+    return 0;
+}
+
+/******************************************************************************
+* Function: irq_set_trigger
+* Description: Level- or edge-triggered for one PPI/SPI (ICFGR bit 2n+1).
+*              The spec leaves changing ICFGR on an enabled INTID
+*              unpredictable, so it is disabled around the write. ICFGR is
+*              shared by 16 INTIDs and read-modify-written: configure at
+*              bring-up, not concurrently from two cores.
+* Returns: 0, or -1 for an SGI (always edge) or an out-of-range INTID
+*****************************************************************************/
+int irq_set_trigger(uint32_t irq_id, irq_trigger_t trigger)
+{
+    if (irq_id < 16u || irq_id >= IRQ_MAX_HANDLERS) return -1;
+
+    uint32_t bit     = 1u << (irq_id % 32u);
+    uint32_t enabled = GICD_ISENABLER(irq_id / 32u) & bit;
+    uint32_t cfg_bit = 2u << ((irq_id % 16u) * 2u);
+
+    if (enabled) GICD_ICENABLER(irq_id / 32u) = bit;
+    uint32_t cfg = GICD_ICFGR(irq_id / 16u);
+    GICD_ICFGR(irq_id / 16u) = (trigger == IRQ_TRIGGER_EDGE) ? (cfg | cfg_bit)
+                                                             : (cfg & ~cfg_bit);
+    if (enabled) GICD_ISENABLER(irq_id / 32u) = bit;
+    return 0;
+}
+
+/******************************************************************************
+* Function: irq_set_binary_point
+* Description: Set the calling core's GICC_BPR: how many low priority bits
+*              are ignored when deciding whether a pending IRQ may preempt
+*              a running handler. IRQ_BPR_MAX turns nesting off.
+* Returns: the value the GIC kept (it raises values below its minimum)
+*****************************************************************************/
+uint32_t irq_set_binary_point(uint32_t bpr)
+{
+    GICC_BPR = bpr & 0x7u;
+    return GICC_BPR & 0x7u;
+}
+
+/******************************************************************************
+* Function: irq_nesting
+* Description: Handlers active on the calling core: 0 outside any, 1 in a
+*              handler, 2 or more while a higher-priority IRQ preempts one
+*****************************************************************************/
+uint32_t irq_nesting(void)
+{
+    return irq_depth[irq_core_id()];
+}
+
+/******************************************************************************
+* Function: irq_send_sgi / irq_send_sgi_self
+* Description: Raise software-generated interrupt 'sgi_id' (0-15) on the
+*              cores in 'cpu_mask' (bit n = core n), or on the calling core
+*****************************************************************************/
+void irq_send_sgi(uint32_t sgi_id, uint32_t cpu_mask)
+{
+    __asm__ volatile("dsb ishst" ::: "memory");     /* data before the IPI */
+    GICD_SGIR = ((cpu_mask & 0xFFu) << 16) | (sgi_id & 0xFu);
+}
+
+void irq_send_sgi_self(uint32_t sgi_id)
+{
+    __asm__ volatile("dsb ishst" ::: "memory");
+    GICD_SGIR = (2u << 24) | (sgi_id & 0xFu);       /* TargetListFilter = self */
+}
+
 /******************************************************************************
 * Function: irq_enable
 * Description: Unmask IRQ exceptions at EL1 by clearing DAIF.I bit (bit 1)
@@ -83,28 +301,77 @@ void irq_enable(void)  { __asm__ volatile("msr daifclr, #2" ::: "memory"); }
 *****************************************************************************/
 void irq_disable(void) { __asm__ volatile("msr daifset, #2" ::: "memory"); }
 
+/******************************************************************************
+* Function: irq_current_frame
+* Description: For handlers that need the interrupted context (the PC
+*              sampling profiler): the exception frame vector.S saved for
+*              the IRQ currently being handled on this core.
+* Returns: frame pointer, or NULL when not called from an IRQ handler
+*****************************************************************************/
+exc_frame_t *irq_current_frame(void)
+{
+    return irq_frames[irq_core_id()];
+}
+
+/******************************************************************************
+* Function: irq_dispatch
+* Description: Full IRQ path. vector.S has read GICC_IAR and found no lean
+*              handler, saved the whole frame and calls this; IRQs arriving
+*              at lower ELs come through common_trap_handler. Dispatches
+*              to the registered handler, then writes GICC_EOIR to signal
+*              end-of-interrupt, then gives the scheduler a chance to
+*              preempt (sched_irq_exit).
+*              The handler runs with IRQs unmasked: the GIC only signals
+*              an IRQ of higher group priority than the one being handled,
+*              so that one preempts it and returns here through its own
+*              frame (ELR/SPSR live in the frame, not just the registers).
+*              IRQs are masked again before EOI, so restore_regs/ERET is
+*              never interrupted. Only the outermost level is measured and
+*              may switch tasks. A handler that shares a lock with a
+*              higher-priority one must take it with IRQs masked.
+*              FIQs are unmasked along with IRQs, so the FIQ source
+*              preempts any handler on this path.
+* Parameters: iar   - GICC_IAR value (INTID in bits [9:0])
+*             frame - full exception frame of the interrupted context
+*****************************************************************************/
+void irq_dispatch(uint32_t iar, exc_frame_t *frame)
+{
+    uint32_t irq_id = iar & 0x3FFu;                   /* INTID in bits [9:0]    */
+    if (irq_id == IRQ_SPURIOUS) return;               /* spurious — ignore      */
+
+    uint32_t     core  = irq_core_id();
+    uint32_t     depth = irq_depth[core]++;
+    exc_frame_t *outer = irq_frames[core];            /* preempted handler's    */
+    if (depth == 0) PMU_PROBE_BEGIN(PMU_PROBE_IRQ);
+    irq_frames[core] = frame;
+    if (irq_id < IRQ_MAX_HANDLERS && irq_table[irq_id]) {
+        __asm__ volatile("msr daifclr, #3" ::: "memory");   /* let higher prio nest */
+        irq_table[irq_id](irq_id);
+        __asm__ volatile("msr daifset, #3" ::: "memory");
+    }
+    irq_frames[core] = outer;
+    GICC_EOIR = iar;                                  /* end-of-interrupt       */
+    irq_depth[core] = depth;
+    if (depth) return;                                /* back into the handler  */
+    PMU_PROBE_END(PMU_PROBE_IRQ);                     /* before any task switch */
+    sched_irq_exit(frame);                            /* may switch tasks       */
+}
+
 /******************************************************************************
 * Function: common_trap_handler
-* Description: Central exception dispatcher called from every vector stub
-*              in vector.S. For IRQ exceptions, reads GICC_IAR to obtain
-*              the INTID, dispatches to the registered handler, then writes
-*              GICC_EOIR to signal end-of-interrupt.
+* Description: Central exception dispatcher called from the vector stubs
+*              that save a full frame. IRQs from lower ELs read GICC_IAR
+*              and go to irq_dispatch(); current-EL IRQs and FIQs enter
+*              through the lean stub in vector.S instead.
 *              All other exception types halt the core.
 *****************************************************************************/
 void common_trap_handler(uint64_t exc_id, exc_frame_t *frame)
 {
-    (void)frame;
     switch (exc_id) {
         case EXC_SPX_IRQ:
-        case EXC_A64_IRQ: {
-            uint32_t iar    = GICC_IAR; //Interrupt Ack Reg
-            uint32_t irq_id = iar & 0x3FFu;          /* INTID in bits [9:0]    */
-            if (irq_id == 1023u) break;               /* spurious — ignore      */
-            if (irq_id < IRQ_MAX_HANDLERS && irq_table[irq_id])
-                irq_table[irq_id](irq_id);
-            GICC_EOIR = iar;                          /* end-of-interrupt       */
-            break;
-    }
+        case EXC_A64_IRQ:
+            irq_dispatch(GICC_IAR, frame);            /* Interrupt Ack Reg      */
+            return;
         default: for (;;) __asm__ volatile("wfe");         /* fatal — halt core      */
     }
 }
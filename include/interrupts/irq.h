@@ -36,9 +36,32 @@ typedef struct {
 #define EXC_A64_FIQ    0x23u
 #define EXC_A64_SERR   0x24u
 /* GIC INTID constants for this project */
+#define IRQ_ID_VTIMER  27u   /* virtual timer PPI → INTID 27 (profiler) */
 #define IRQ_ID_TIMER   30u   /* ARM generic timer PPI → INTID 30 */
 #define IRQ_ID_UART0   33u   /* PL011 UART0 SPI #1   → INTID 33 */
 #define IRQ_MAX_HANDLERS 64u
+#define IRQ_MAX_CORES    4u
+#define IRQ_SPI_BASE     32u  /* INTIDs below are banked SGIs/PPIs          */
+
+/* Priorities: lower value = more urgent. A pending IRQ preempts a running
+ * handler only if its group priority (the bits above the binary point) is
+ * lower than the running one. Multiples of 0x20 stay distinct on a
+ * GIC-400 (5 priority bits) up to IRQ_BPR_DEFAULT. */
+#define IRQ_PRIO_CRITICAL 0x40u
+#define IRQ_PRIO_HIGH     0x80u
+#define IRQ_PRIO_DEFAULT  0xA0u   /* what irq_init() gives every INTID     */
+#define IRQ_PRIO_LOW      0xC0u
+#define IRQ_PRIO_MASK_ALL 0xFFu   /* GICC_PMR value that passes everything */
+
+/* GICC_BPR: group priority = priority bits [7:bpr+1]. The GIC raises
+ * values below its minimum, irq_set_binary_point() returns what stuck. */
+#define IRQ_BPR_DEFAULT   0u
+#define IRQ_BPR_MAX       7u      /* no preemption at all                  */
+
+typedef enum {
+    IRQ_TRIGGER_LEVEL = 0,
+    IRQ_TRIGGER_EDGE  = 1,
+} irq_trigger_t;
 
 /**************************************************
  * GLOBAL VARIABLES
@@ -50,7 +73,20 @@ typedef void (*irq_handler_t)(uint32_t irq_id);
  * HELPER FUNCTIONS
  ***************************************************/
 void irq_init(void);
+void irq_init_cpu(void);
 void irq_register_handler(uint32_t irq_id, irq_handler_t handler);
+int  irq_register_fast(uint32_t irq_id, irq_handler_t handler);
+int  irq_set_fiq(uint32_t irq_id, irq_handler_t handler);
+int  irq_set_priority(uint32_t irq_id, uint8_t prio);
+uint8_t irq_get_priority(uint32_t irq_id);
+int  irq_set_affinity(uint32_t irq_id, uint8_t cpu_mask);
+int  irq_set_trigger(uint32_t irq_id, irq_trigger_t trigger);
+uint32_t irq_set_binary_point(uint32_t bpr);
+uint32_t irq_nesting(void);
+void irq_send_sgi(uint32_t sgi_id, uint32_t cpu_mask);
+void irq_send_sgi_self(uint32_t sgi_id);
 void irq_enable(void);
 void irq_disable(void);
+exc_frame_t *irq_current_frame(void);
+void irq_dispatch(uint32_t iar, exc_frame_t *frame);
 void common_trap_handler(uint64_t exc_id, exc_frame_t *frame);
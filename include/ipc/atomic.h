@@ -0,0 +1,242 @@
+/******************************************************************************
+* File: atomic.h
+* Description: Acquire/release primitives shared by the lock-free structures
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#ifndef ATOMIC_H
+#define ATOMIC_H
+
+#include <stdint.h>
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define CACHE_LINE_SIZE     64      /* Cortex-A72 / A76 L1D line size        */
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+/* Set by spinlock_init() from ID_AA64ISAR0_EL1.Atomic: 1 = ARMv8.1 LSE
+ * (LDADD/SWP/CAS) present (A76), 0 = exclusives only (A72).           */
+extern int atomic_use_lse;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+/******************************************************************************
+* Function: atomic_load_acquire32
+* Description: LDAR — later loads/stores cannot be hoisted above this read
+*****************************************************************************/
+static inline uint32_t atomic_load_acquire32(const volatile uint32_t *p)
+{
+    uint32_t v;
+    __asm__ volatile("ldar %w0, [%1]" : "=r"(v) : "r"(p) : "memory");
+    return v;
+}
+
+/******************************************************************************
+* Function: atomic_store_release32
+* Description: STLR — earlier loads/stores complete before this write is seen
+*****************************************************************************/
+static inline void atomic_store_release32(volatile uint32_t *p, uint32_t v)
+{
+    __asm__ volatile("stlr %w0, [%1]" :: "r"(v), "r"(p) : "memory");
+}
+
+/******************************************************************************
+* Function: atomic_load_acquire64 / atomic_store_release64
+* Description: 64-bit LDAR / STLR (pointers, counters)
+*****************************************************************************/
+static inline uint64_t atomic_load_acquire64(const volatile uint64_t *p)
+{
+    uint64_t v;
+    __asm__ volatile("ldar %0, [%1]" : "=r"(v) : "r"(p) : "memory");
+    return v;
+}
+
+static inline void atomic_store_release64(volatile uint64_t *p, uint64_t v)
+{
+    __asm__ volatile("stlr %0, [%1]" :: "r"(v), "r"(p) : "memory");
+}
+
+/******************************************************************************
+* Function: atomic_cas32
+* Description: Compare-and-swap with acquire+release semantics
+*              (CASAL with LSE, LDAXR/STLXR loop otherwise)
+* Returns: 1 if *p held 'expected' and now holds 'desired', 0 otherwise
+*****************************************************************************/
+static inline int atomic_cas32(volatile uint32_t *p, uint32_t expected, uint32_t desired)
+{
+    uint32_t old, fail;
+
+    if (atomic_use_lse) {
+        old = expected;
+        __asm__ volatile(
+            ".arch_extension lse        \n"
+            "   casal  %w0, %w2, [%1]   \n"
+            : "+r" (old)
+            : "r" (p), "r" (desired)
+            : "memory"
+        );
+        return old == expected;
+    }
+
+    __asm__ volatile(
+        "1: ldaxr  %w0, [%2]        \n"  // Load exclusive
+        "   cmp    %w0, %w3         \n"
+        "   b.ne   2f               \n"  // Someone else moved it — give up
+        "   stlxr  %w1, %w4, [%2]   \n"  // Store exclusive
+        "   cbnz   %w1, 1b          \n"  // Lost the reservation — retry
+        "2:                         \n"
+        : "=&r" (old), "=&r" (fail)
+        : "r" (p), "r" (expected), "r" (desired)
+        : "cc", "memory"
+    );
+    return old == expected;
+}
+
+/******************************************************************************
+* Function: atomic_cas64
+* Description: 64-bit compare-and-swap, acquire+release
+* Returns: 1 on success, 0 if *p did not hold 'expected'
+*****************************************************************************/
+static inline int atomic_cas64(volatile uint64_t *p, uint64_t expected, uint64_t desired)
+{
+    uint64_t old;
+    uint32_t fail;
+
+    if (atomic_use_lse) {
+        old = expected;
+        __asm__ volatile(
+            ".arch_extension lse        \n"
+            "   casal  %0, %2, [%1]     \n"
+            : "+r" (old)
+            : "r" (p), "r" (desired)
+            : "memory"
+        );
+        return old == expected;
+    }
+
+    __asm__ volatile(
+        "1: ldaxr  %0, [%2]         \n"
+        "   cmp    %0, %3           \n"
+        "   b.ne   2f               \n"
+        "   stlxr  %w1, %4, [%2]    \n"
+        "   cbnz   %w1, 1b          \n"
+        "2:                         \n"
+        : "=&r" (old), "=&r" (fail)
+        : "r" (p), "r" (expected), "r" (desired)
+        : "cc", "memory"
+    );
+    return old == expected;
+}
+
+/******************************************************************************
+* Function: atomic_fetch_add32
+* Description: *p += v, acquire+release (LDADDAL with LSE)
+* Returns: the value of *p before the add
+*****************************************************************************/
+static inline uint32_t atomic_fetch_add32(volatile uint32_t *p, uint32_t v)
+{
+    uint32_t old, tmp, fail;
+
+    if (atomic_use_lse) {
+        __asm__ volatile(
+            ".arch_extension lse        \n"
+            "   ldaddal %w2, %w0, [%1]  \n"
+            : "=r" (old)
+            : "r" (p), "r" (v)
+            : "memory"
+        );
+        return old;
+    }
+
+    __asm__ volatile(
+        "1: ldaxr  %w0, [%3]        \n"
+        "   add    %w1, %w0, %w4    \n"
+        "   stlxr  %w2, %w1, [%3]   \n"
+        "   cbnz   %w2, 1b          \n"
+        : "=&r" (old), "=&r" (tmp), "=&r" (fail)
+        : "r" (p), "r" (v)
+        : "memory"
+    );
+    return old;
+}
+
+/******************************************************************************
+* Function: atomic_xchg64
+* Description: Swap in 'v', acquire+release (SWPAL with LSE)
+* Returns: the previous value of *p
+*****************************************************************************/
+static inline uint64_t atomic_xchg64(volatile uint64_t *p, uint64_t v)
+{
+    uint64_t old;
+    uint32_t fail;
+
+    if (atomic_use_lse) {
+        __asm__ volatile(
+            ".arch_extension lse        \n"
+            "   swpal  %2, %0, [%1]     \n"
+            : "=r" (old)
+            : "r" (p), "r" (v)
+            : "memory"
+        );
+        return old;
+    }
+
+    __asm__ volatile(
+        "1: ldaxr  %0, [%2]         \n"
+        "   stlxr  %w1, %3, [%2]    \n"
+        "   cbnz   %w1, 1b          \n"
+        : "=&r" (old), "=&r" (fail)
+        : "r" (p), "r" (v)
+        : "memory"
+    );
+    return old;
+}
+
+/******************************************************************************
+* Function: atomic_wait_while32 / atomic_wait_while64
+* Description: Sleep in WFE while *p == val. LDAXR arms the exclusive
+*              monitor, so the other core's store to the line wakes us
+*              without it having to issue SEV.
+* Returns: the first value observed != val (with acquire semantics)
+*****************************************************************************/
+static inline uint32_t atomic_wait_while32(const volatile uint32_t *p, uint32_t val)
+{
+    uint32_t cur;
+    __asm__ volatile(
+        "   sevl                    \n"  // first WFE falls straight through
+        "1: wfe                     \n"
+        "   ldaxr  %w0, [%1]        \n"
+        "   cmp    %w0, %w2         \n"
+        "   b.eq   1b               \n"
+        : "=&r" (cur)
+        : "r" (p), "r" (val)
+        : "cc", "memory"
+    );
+    return cur;
+}
+
+static inline uint64_t atomic_wait_while64(const volatile uint64_t *p, uint64_t val)
+{
+    uint64_t cur;
+    __asm__ volatile(
+        "   sevl                    \n"
+        "1: wfe                     \n"
+        "   ldaxr  %0, [%1]         \n"
+        "   cmp    %0, %2           \n"
+        "   b.eq   1b               \n"
+        : "=&r" (cur)
+        : "r" (p), "r" (val)
+        : "cc", "memory"
+    );
+    return cur;
+}
+
+#endif /* ATOMIC_H */
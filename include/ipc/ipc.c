@@ -10,163 +10,237 @@
 #include "ipc/ipc.h"
 #include "crypto/hmac_sha256.h"
 #include "uart/uart0.h"
+#include "pmu/pmu.h"
+#include "alloc/arena.h"
+#include "alloc/slab.h"
 
 /**************************************************
  * MACRO DEFINTIONS
  ***************************************************/
 
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+static unsigned int tx_counter[MAILBOX_CORES];  // indexed by sender core
+mailbox_inbox_t *mailbox_inboxes;               // MAILBOX_CORES, in the arena
+
 /**************************************************
  * HELPER FUNCTIONS
  ***************************************************/
 
 /******************************************************************************
-* Function: spinlock_init
-* Description: Initialize the global spinlock
+* Function: mailbox_init
+* Description: Initialize a core's inbox (empty MPSC queue). Core 0 calls
+*              it for every core at boot; the first call carves all
+*              MAILBOX_CORES inboxes out of the shared arena. If the arena
+*              is exhausted it reports it on the UART and halts the core.
 *****************************************************************************/
-void spinlock_init(void) {
-    *SPINLOCK_ADDR = 0;
+void mailbox_init(int core_id) {
+    if (!mailbox_inboxes) {
+        mailbox_inboxes = arena_alloc(MAILBOX_CORES * sizeof(mailbox_inbox_t),
+                                      _Alignof(mailbox_inbox_t));
+        if (!mailbox_inboxes) {
+            uart_puts("[MAILBOX] Shared arena exhausted, halting\n");
+            while (1) { __asm__ volatile("wfe"); }
+        }
+    }
+    mailbox_inbox_init(GET_MAILBOX(core_id));
 }
 
 /******************************************************************************
-* Function: spinlock_acquire
-* Description: Acquire spinlock using ARM exclusive instructions (LDXR/STXR)
-* This provides proper atomic lock acquisition
+* Function: msg_payload
+* Description: Locate a message's payload and check it fits its buffer
+* Parameters: msg     - message (fields not yet trusted)
+*             payload - receives the first payload byte, 0 without buffer
+* Returns: 0, or -1 if the handle is invalid or off + len overruns it
 *****************************************************************************/
-void spinlock_acquire(volatile unsigned int *lock) {
-    unsigned int tmp, val;
-    
-    __asm__ volatile(
-        "   mov   %w1, #1           \n"  // Prepare lock value
-        "1: ldxr  %w0, [%2]         \n"  // Load exclusive
-        "   cbnz  %w0, 1b           \n"  // If locked, retry
-        "   stxr  %w0, %w1, [%2]    \n"  // Store exclusive
-        "   cbnz  %w0, 1b           \n"  // If store failed, retry
-        "   dmb   sy                \n"  // Data memory barrier
-        : "=&r" (tmp), "=&r" (val)
-        : "r" (lock)
-        : "memory"
-    );
-}
+static int msg_payload(const mailbox_msg_t *msg, const uint8_t **payload) {
+    slab_pool_t *pool;
+    uint8_t     *obj;
 
-/******************************************************************************
-* Function: spinlock_release
-* Description: Release spinlock with memory barrier
-*****************************************************************************/
-void spinlock_release(volatile unsigned int *lock) {
-    __asm__ volatile("dmb sy" ::: "memory");  // Memory barrier
-    *lock = 0;
-    __asm__ volatile("dsb sy" ::: "memory");  // Data synchronization barrier
-    __asm__ volatile("sev"    ::: "memory");  // Signal event (wake WFE cores)
+    *payload = 0;
+    if (msg->buf_handle == MSG_BUF_NONE) {
+        return (msg->buf_off == 0 && msg->buf_len == 0) ? 0 : -1;
+    }
+
+    obj = slab_handle_obj(msg->buf_handle, &pool);
+    if (!obj || (uint32_t)msg->buf_off + msg->buf_len > pool->obj_size) {
+        return -1;
+    }
+    *payload = obj + msg->buf_off;
+    return 0;
 }
 
 /******************************************************************************
-* Function: mailbox_init
-* Description: Initialize a core's mailbox
+* Function: mailbox_send
+* Description: Authenticate a message and append it to another core's inbox.
+*              Lock-free: the tag is computed on the sender's stack, then a
+*              single CAS claims a slot. Never waits on the receiver.
+* Returns: 0 on success, -1 if the inbox is full
 *****************************************************************************/
-void mailbox_init(int core_id) {
-    volatile mailbox_t *mb = GET_MAILBOX(core_id);
-    mb->lock = 0;
-    mb->msg_type = MSG_NONE;
-    mb->msg_data = 0;
-    mb->sender_id = 0xFF;
-    mb->status = 0;
-    mb->counter = 0;
+int mailbox_send(int dest_core, int msg_type, unsigned int data) {
+    return mailbox_send_buf(dest_core, msg_type, data, MSG_BUF_NONE, 0, 0);
 }
 
 /******************************************************************************
-* Function: mailbox_send
-* Description: Send message to another core's mailbox
-* Returns: 0 on success, -1 if mailbox full
+* Function: mailbox_send_buf
+* Description: mailbox_send() with a pool buffer attached by handle. The
+*              tag covers the payload, which is read in place; on success
+*              the buffer belongs to the receiver and the sender must not
+*              touch it again.
+* Parameters: handle - from mailbox_buf_alloc() / slab_handle(), or
+*                      MSG_BUF_NONE
+*             off    - payload offset in the buffer
+*             len    - payload bytes, off + len within the object
+* Returns: 0 on success; -1 if the inbox is full or the buffer range is
+*          invalid (the sender still owns the buffer)
 *****************************************************************************/
-int mailbox_send(int dest_core, int msg_type, unsigned int data) {
-    volatile mailbox_t *mb = GET_MAILBOX(dest_core);
-    
-    spinlock_acquire((volatile unsigned int*)&mb->lock);
-    
-    if (mb->status == 1) {
-        spinlock_release((volatile unsigned int*)&mb->lock);
-        return -1; 
-    }
+int mailbox_send_buf(int dest_core, int msg_type, unsigned int data,
+                     uint32_t handle, unsigned int off, unsigned int len) {
+    mailbox_msg_t msg;
+    const uint8_t *payload;
 
+    PMU_PROBE_BEGIN(PMU_PROBE_MAILBOX_SEND);
     // Write message
     unsigned int sender;
     __asm__ volatile("mrs %0, mpidr_el1" : "=r"(sender));
     sender = sender & 0xFF;
-    
-    mb->sender_id = sender;
-    mb->msg_type = msg_type;
-    mb->msg_data = data;
-    mb->counter++;
-    //Compute the HMAC tag[]
-    hmac_tag_compute(mb,(uint8_t*)mb->tag);
-    
-    //Mark as Ready
-    mb->status = 1;
-    spinlock_release((volatile unsigned int*)&mb->lock);
-    
+
+    msg.sender_id  = sender;
+    msg.msg_type   = msg_type;
+    msg.msg_data   = data;
+    msg.buf_handle = handle;
+    msg.buf_off    = (uint16_t)off;
+    msg.buf_len    = (uint16_t)len;
+    if (off > 0xFFFFu || len > 0xFFFFu || msg_payload(&msg, &payload) != 0) {
+        PMU_PROBE_END(PMU_PROBE_MAILBOX_SEND);
+        return -1;
+    }
+    msg.counter   = ++tx_counter[sender];   // only this core writes its slot
+    //Compute the HMAC tag[] over header + payload
+    hmac_tag_compute(&msg, payload, msg.tag);
+
+    if (mailbox_inbox_push(GET_MAILBOX(dest_core), &msg) != 0) {
+        PMU_PROBE_END(PMU_PROBE_MAILBOX_SEND);
+        return -1;
+    }
+
     // Wake up destination core
     __asm__ volatile("sev" ::: "memory");
-    
+
+    PMU_PROBE_END(PMU_PROBE_MAILBOX_SEND);
     return 0;
 }
 
+/******************************************************************************
+* Function: mailbox_receive_msg
+* Description: Take the oldest message from own inbox (non-blocking) and
+*              verify its tag, payload included. A verified message with a
+*              buffer is now owned by the caller: read it through
+*              mailbox_payload(), then mailbox_release() it.
+* Returns: 1 if a message was received, 0 if the inbox is empty, -1 if
+*          the HMAC check failed (the message is dropped and its buffer,
+*          whose handle cannot be trusted, is not freed)
+*****************************************************************************/
+int mailbox_receive_msg(int core_id, mailbox_msg_t *out) {
+    const uint8_t *payload;
+
+    if (mailbox_inbox_pop(GET_MAILBOX(core_id), out) != 0) {
+        return 0;   // empty polls are not counted
+    }
+
+    PMU_PROBE_BEGIN(PMU_PROBE_MAILBOX_RECV);
+    if (msg_payload(out, &payload) != 0 || !hmac_tag_verify(out, payload)) {
+        PMU_PROBE_END(PMU_PROBE_MAILBOX_RECV);
+        // tag mismatch — tampered or replayed
+        uart_puts("[CRYPTO] HMAC verify FAILED - message rejected\n");
+        return -1;
+    }
+    PMU_PROBE_END(PMU_PROBE_MAILBOX_RECV);
+    return 1;
+}
+
 /******************************************************************************
 * Function: mailbox_receive
-* Description: Receive message from own mailbox (non-blocking)
-* Returns: 1 if message received, 0 if no message, -1 on error
+* Description: Receive the oldest message from own inbox (non-blocking).
+*              For callers that only want the data word: an attached
+*              buffer is released unread.
+* Returns: 1 if message received, 0 if no message, -1 if HMAC check failed
 *****************************************************************************/
 int mailbox_receive(int core_id, unsigned int *sender, unsigned int *msg_type, unsigned int *data) {
-    volatile mailbox_t *mb = GET_MAILBOX(core_id);
-    int result = 0;
-    unsigned long shared_key1 = 0x0000000000000000;
-    unsigned long shared_key2 = 0x0000000000000000;
-    
-    spinlock_acquire((volatile unsigned int*)&mb->lock);
-    
-    if (mb->status == 1 && hmac_tag_verify(mb)) {
-        // Message available
-        *sender = mb->sender_id;
-        *msg_type = mb->msg_type;
-        *data = mb->msg_data;
-        mb->status = 2;  // Mark as being processed
-        result = 1;
-        uart_puts("[CRYPTO] HMAC pass with key\n");
-        for(unsigned i = 0 ; i < 16; i++) {
-            shared_key1 |= mb->tag[i];
-            //uart_puthex(shared_key1);
-            //uart_putc('\n');
-            shared_key1 = shared_key1 << 8;
-        }
-        uart_puthex(shared_key1);
-        uart_putc('\n');
-        for(unsigned i = 16 ; i < 32; i++) {
-            shared_key2 |= mb->tag[i];
-            //uart_puthex(shared_key2);
-            //uart_putc('\n');
-            shared_key2 = shared_key2 << 8;
+    mailbox_msg_t msg;
+    int rc = mailbox_receive_msg(core_id, &msg);
+
+    if (rc != 1) return rc;
+    mailbox_release(&msg);
+
+    *sender   = msg.sender_id;
+    *msg_type = msg.msg_type;
+    *data     = msg.msg_data;
+    return 1;
+}
+
+/******************************************************************************
+* Function: mailbox_receive_batch
+* Description: Drain up to 'max' messages from own inbox in one call.
+*              Messages that fail HMAC verification are dropped. The
+*              caller owns the buffers of the returned messages and must
+*              mailbox_release() each one.
+* Parameters: core_id - own core
+*             out     - array of at least 'max' messages
+*             max     - batch size
+* Returns: number of verified messages written to out[]
+*****************************************************************************/
+unsigned int mailbox_receive_batch(int core_id, mailbox_msg_t *out, unsigned int max) {
+    mailbox_inbox_t *inbox = GET_MAILBOX(core_id);
+    const uint8_t *payload;
+    unsigned int n = 0;
+
+    while (n < max && mailbox_inbox_pop(inbox, &out[n]) == 0) {
+        if (msg_payload(&out[n], &payload) == 0 && hmac_tag_verify(&out[n], payload)) {
+            n++;
+        } else {
+            uart_puts("[CRYPTO] HMAC verify FAILED - message rejected\n");
         }
-        uart_puthex(shared_key1);
-        uart_putc('\n');
-    } else if (mb->status == 1) {
-        // tag mismatch — tampered or replayed
-        uart_puts("[CRYPTO] HMAC verify FAILED - message rejected\n");
-        mb->status = 2;
-        result = 0;
     }
-    
-    spinlock_release((volatile unsigned int*)&mb->lock);
-    return result;
+    return n;
+}
+
+/******************************************************************************
+* Function: mailbox_buf_alloc
+* Description: A message buffer of at least 'len' bytes from the smallest
+*              message pool that fits (slab_msg_small / slab_msg_large)
+* Parameters: len    - payload bytes needed
+*             handle - receives the handle for mailbox_send_buf()
+* Returns: the buffer, or 0 if 'len' is too large or the pool is empty
+*****************************************************************************/
+void *mailbox_buf_alloc(unsigned int len, uint32_t *handle) {
+    slab_pool_t *pool = (len <= SLAB_MSG_SMALL_SIZE) ? slab_msg_small :
+                        (len <= SLAB_MSG_LARGE_SIZE) ? slab_msg_large : 0;
+    void *buf = pool ? slab_alloc(pool) : 0;
+
+    *handle = buf ? slab_handle(pool, buf) : MSG_BUF_NONE;
+    return buf;
 }
 
 /******************************************************************************
-* Function: mailbox_clear
-* Description: Clear mailbox after processing message
+* Function: mailbox_payload
+* Description: First payload byte of a received (verified) message
+* Returns: the payload in the pool buffer, or 0 if there is none
 *****************************************************************************/
-void mailbox_clear(int core_id) {
-    volatile mailbox_t *mb = GET_MAILBOX(core_id);
-    
-    spinlock_acquire((volatile unsigned int*)&mb->lock);
-    mb->status = 0;
-    mb->msg_type = MSG_NONE;
-    spinlock_release((volatile unsigned int*)&mb->lock);
+const uint8_t *mailbox_payload(const mailbox_msg_t *msg) {
+    const uint8_t *payload;
+
+    return (msg_payload(msg, &payload) == 0) ? payload : 0;
+}
+
+/******************************************************************************
+* Function: mailbox_release
+* Description: Give a received message's buffer back to its pool (onto the
+*              calling core's free list). No-op without a buffer.
+*****************************************************************************/
+void mailbox_release(const mailbox_msg_t *msg) {
+    if (msg->buf_handle != MSG_BUF_NONE) {
+        slab_handle_free(msg->buf_handle);
+    }
 }
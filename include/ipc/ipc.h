@@ -9,47 +9,80 @@
  * INCLUDE FILES
  ***************************************************/
 #include <stdint.h>
+#include "queue/queue.h"
+#include "ipc/spinlock.h"
 /**************************************************
  * MACRO DEFINTIONS
  ***************************************************/
 #ifndef IPC_H
 #define IPC_H
-// Shared memory layout - placed after stacks
-// Stacks: 0x40200000 - 0x40210000 (4 cores × 16KB)
-#define SHARED_MEM_BASE     0x40220000
-#define SPINLOCK_ADDR       ((volatile unsigned int*)0x40220000)
-#define MAILBOX_BASE        0x40220100
+// Shared objects live in the linker-defined arena (alloc/arena.h); each is
+// carved out by its init function on Core 0 before the secondaries start
+#define SPINLOCK_ADDR       ipc_lock            // global ticket lock, spinlock_init()
+#define MAILBOX_CORES       4
 #define MSG_NONE            0
 #define MSG_PING            1
 #define MSG_DATA            2
 #define MSG_ACK             3
 #define MSG_SHUTDOWN        4
 
+#define MSG_BUF_NONE        0u                  // buf_handle: no payload
+
+/* Messages each core's inbox can hold before mailbox_send() reports full.
+ * Must be a power of two. Override with -DMAILBOX_DEPTH=n.                */
+#ifndef MAILBOX_DEPTH
+#define MAILBOX_DEPTH       8
+#endif
+
 /**************************************************
  * GLOBAL VARIABLES
  ***************************************************/
+/*
+ * A message can carry a pool buffer by handle (alloc/slab.h) instead of
+ * by value: the payload is buf_len bytes at buf_off in that object. The
+ * sender gives up the buffer with mailbox_send_buf(); the receiver owns
+ * it from mailbox_receive_msg() until mailbox_release(). No byte of the
+ * payload is copied on the way.
+ */
 typedef struct {
-    volatile unsigned int lock;         // Spinlock for this mailbox
-    volatile unsigned int msg_type;     // Message type
-    volatile unsigned int msg_data;     // Message payload
-    volatile unsigned int sender_id;    // Source core ID
-    volatile unsigned int status;       // 0=empty, 1=ready, 2=processed
-    volatile unsigned int counter;      // Message counter
-    volatile uint8_t      tag[32];      //expansion with tag[32]
-                                        //exactly 32 bytes, matching HMAC_TAG_SIZE
-} mailbox_t;
-
-#define GET_MAILBOX(core_id) ((volatile mailbox_t*)(MAILBOX_BASE + (core_id) * sizeof(mailbox_t)))
+    unsigned int sender_id;    // Source core ID
+    unsigned int msg_type;     // Message type
+    unsigned int msg_data;     // Message payload
+    unsigned int counter;      // Per-sender message counter (in the MAC)
+    uint32_t     buf_handle;   // slab handle, MSG_BUF_NONE = no buffer
+    uint16_t     buf_off;      // payload offset in the buffer
+    uint16_t     buf_len;      // payload bytes (in the MAC)
+    uint8_t      tag[32];      // HMAC-SHA256 over the fields above and,
+                               // with a buffer, the payload (HMAC_TAG_SIZE)
+} mailbox_msg_t;
+
+/*
+ * Per-core inbox: bounded MPSC queue of authenticated messages.
+ * Any core may push (one CAS on enq_pos), only the owner core pops.
+ * Size with depth 8: 2 x 64 + 8 x 60 = 608 -> 640 bytes per core;
+ * the MAILBOX_CORES inboxes are one arena block (mailbox_init).
+ */
+QUEUE_MPSC_DECLARE(mailbox_inbox, mailbox_msg_t, MAILBOX_DEPTH)
+
+extern spinlock_t      *ipc_lock;
+extern mailbox_inbox_t *mailbox_inboxes;
+
+#define GET_MAILBOX(core_id) (&mailbox_inboxes[(core_id)])
 
 /**************************************************
  * HELPER FUNCTIONS
  ***************************************************/
-void spinlock_init(void);
-void spinlock_acquire(volatile unsigned int *lock);
-void spinlock_release(volatile unsigned int *lock);
 void mailbox_init(int core_id);
 int  mailbox_send(int dest_core, int msg_type, unsigned int data);
 int  mailbox_receive(int core_id, unsigned int *sender, unsigned int *msg_type, unsigned int *data);
-void mailbox_clear(int core_id);
+unsigned int mailbox_receive_batch(int core_id, mailbox_msg_t *out, unsigned int max);
+
+/* Zero-copy payloads */
+void *mailbox_buf_alloc(unsigned int len, uint32_t *handle);
+int   mailbox_send_buf(int dest_core, int msg_type, unsigned int data,
+                       uint32_t handle, unsigned int off, unsigned int len);
+int   mailbox_receive_msg(int core_id, mailbox_msg_t *out);
+const uint8_t *mailbox_payload(const mailbox_msg_t *msg);
+void  mailbox_release(const mailbox_msg_t *msg);
 
 #endif
@@ -0,0 +1,200 @@
+/******************************************************************************
+* File: spinlock.c
+* Description: Ticket and MCS spinlocks with WFE waiting and contention stats
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "ipc/spinlock.h"
+#include "ipc/ipc.h"
+#include "uart/uart0.h"
+#include "alloc/arena.h"
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+int atomic_use_lse;     /* .bss — exclusives until spinlock_init() probes */
+spinlock_t *ipc_lock;   /* SPINLOCK_ADDR, carved from the shared arena    */
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+/* PMCCNTR_EL0 — started on every core by boot.S */
+static inline uint64_t read_cycles(void)
+{
+    uint64_t v;
+    __asm__ volatile("mrs %0, pmccntr_el0" : "=r"(v) :: "memory");
+    return v;
+}
+
+static inline void stats_wait(lock_stats_t *st, uint64_t waited)
+{
+    st->contended++;
+    st->wait_cycles += waited;
+    if (waited > st->max_wait_cycles) st->max_wait_cycles = waited;
+}
+
+/******************************************************************************
+* Function: spinlock_init
+* Description: Probe ID_AA64ISAR0_EL1 for LSE atomics, then carve the
+*              global spinlock out of the shared arena (own cache line) and
+*              initialize it. Core 0 only, before secondaries start.
+*              Halts the core if the arena cannot hold it: this runs before
+*              uart_init(), and nothing after it works without the lock.
+*****************************************************************************/
+void spinlock_init(void) {
+    uint64_t isar0;
+
+    /* ID_AA64ISAR0_EL1.Atomic [23:20]: 0b0010 = LDADD/SWP/CAS present */
+    __asm__ volatile("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+    atomic_use_lse = (((isar0 >> 20) & 0xF) >= 2);
+
+    ipc_lock = arena_alloc(sizeof(spinlock_t), CACHE_LINE_SIZE);
+    if (!ipc_lock) {
+        while (1) { __asm__ volatile("wfe"); }  /* .shared_arena too small */
+    }
+    spinlock_lock_init(SPINLOCK_ADDR);
+}
+
+/******************************************************************************
+* Function: spinlock_lock_init
+* Description: Reset a ticket lock and its counters
+*****************************************************************************/
+void spinlock_lock_init(spinlock_t *lock) {
+    lock->ticket   = 0;
+    lock->reserved = 0;
+    lock->stats.acquires        = 0;
+    lock->stats.contended       = 0;
+    lock->stats.wait_cycles     = 0;
+    lock->stats.max_wait_cycles = 0;
+    __asm__ volatile("dmb sy" ::: "memory");
+}
+
+/******************************************************************************
+* Function: spinlock_acquire
+* Description: Take a ticket (one atomic add on the 'next' half), then sleep
+*              in WFE until 'now serving' reaches it. Cores are served in
+*              arrival order, so no core can be starved.
+*****************************************************************************/
+void spinlock_acquire(spinlock_t *lock) {
+    uint32_t old    = atomic_fetch_add32(&lock->ticket, 1u << 16);
+    uint32_t ticket = old >> 16;
+
+    if ((old & 0xFFFFu) != ticket) {
+        uint64_t start = read_cycles();
+        uint32_t cur;
+
+        __asm__ volatile(
+            "   sevl                    \n"  // first WFE falls through
+            "1: wfe                     \n"  // sleep until the line is written
+            "   ldaxrh %w0, [%1]        \n"  // now-serving half, arms monitor
+            "   cmp    %w0, %w2         \n"
+            "   b.ne   1b               \n"
+            : "=&r" (cur)
+            : "r" (&lock->ticket), "r" (ticket)
+            : "cc", "memory"
+        );
+        stats_wait(&lock->stats, read_cycles() - start);
+    }
+    lock->stats.acquires++;
+}
+
+/******************************************************************************
+* Function: spinlock_release
+* Description: Hand the lock to the next ticket. The STLRH to the lock word
+*              clears the waiters' exclusive monitors, which wakes them.
+*****************************************************************************/
+void spinlock_release(spinlock_t *lock) {
+    uint32_t next_owner = (lock->ticket + 1u) & 0xFFFFu;   /* only we write it */
+    __asm__ volatile("stlrh %w0, [%1]" :: "r"(next_owner), "r"(&lock->ticket) : "memory");
+}
+
+/******************************************************************************
+* Function: spinlock_acquire_irqsave / spinlock_release_irqrestore
+* Description: spinlock_acquire with IRQs masked on this core until the
+*              matching release, which puts DAIF back as it was. The holder
+*              can be neither interrupted nor preempted.
+* Returns: the DAIF value to pass to spinlock_release_irqrestore
+*****************************************************************************/
+uint64_t spinlock_acquire_irqsave(spinlock_t *lock) {
+    uint64_t daif;
+
+    __asm__ volatile("mrs %0, daif\n msr daifset, #2" : "=r"(daif) :: "memory");
+    spinlock_acquire(lock);
+    return daif;
+}
+
+void spinlock_release_irqrestore(spinlock_t *lock, uint64_t daif) {
+    spinlock_release(lock);
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+}
+
+/******************************************************************************
+* Function: mcs_lock_init
+* Description: Reset an MCS lock and its counters
+*****************************************************************************/
+void mcs_lock_init(mcs_lock_t *lock) {
+    lock->tail = 0;
+    lock->stats.acquires        = 0;
+    lock->stats.contended       = 0;
+    lock->stats.wait_cycles     = 0;
+    lock->stats.max_wait_cycles = 0;
+    __asm__ volatile("dmb sy" ::: "memory");
+}
+
+/******************************************************************************
+* Function: mcs_lock_acquire
+* Description: Append 'node' to the waiter queue with one swap. If there was
+*              a predecessor, link behind it and WFE on our own node until
+*              it hands over. 'node' must stay valid until release.
+*****************************************************************************/
+void mcs_lock_acquire(mcs_lock_t *lock, mcs_node_t *node) {
+    node->next   = 0;
+    node->locked = 1;
+
+    mcs_node_t *prev = (mcs_node_t *)atomic_xchg64((volatile uint64_t *)&lock->tail,
+                                                   (uint64_t)node);
+    if (prev) {
+        uint64_t start = read_cycles();
+        atomic_store_release64((volatile uint64_t *)&prev->next, (uint64_t)node);
+        atomic_wait_while32(&node->locked, 1);
+        stats_wait(&lock->stats, read_cycles() - start);
+    }
+    lock->stats.acquires++;
+}
+
+/******************************************************************************
+* Function: mcs_lock_release
+* Description: Pass the lock to our successor, or mark it free if we are the
+*              last in the queue. If a successor is mid-enqueue, wait for its
+*              link to appear.
+*****************************************************************************/
+void mcs_lock_release(mcs_lock_t *lock, mcs_node_t *node) {
+    mcs_node_t *next = (mcs_node_t *)atomic_load_acquire64((volatile uint64_t *)&node->next);
+
+    if (!next) {
+        if (atomic_cas64((volatile uint64_t *)&lock->tail, (uint64_t)node, 0)) {
+            return;     /* nobody waiting */
+        }
+        next = (mcs_node_t *)atomic_wait_while64((volatile uint64_t *)&node->next, 0);
+    }
+    atomic_store_release32(&next->locked, 0);
+}
+
+/******************************************************************************
+* Function: lock_stats_print
+* Description: One line per lock: acquires, contended, wait cycles, max wait.
+*              Does not take any lock — wrap in spinlock_acquire if needed.
+*****************************************************************************/
+void lock_stats_print(const char *name, const lock_stats_t *stats) {
+    uart_puts("[LOCK] ");
+    uart_puts(name);
+    uart_puts(" acq=");     uart_puthex(stats->acquires);
+    uart_puts(" cont=");    uart_puthex(stats->contended);
+    uart_puts(" wait=");    uart_puthex(stats->wait_cycles);
+    uart_puts(" max=");     uart_puthex(stats->max_wait_cycles);
+    uart_puts("\n");
+}
@@ -0,0 +1,75 @@
+/******************************************************************************
+* File: spinlock.h
+* Description: Fair spinlocks — ticket lock and MCS queue lock
+*
+*   spinlock_t  : ticket lock, one 32-bit word (owner [15:0], next [31:16]).
+*                 FIFO handoff, waiters sleep in WFE on the lock word.
+*                 Best for short sections with few waiters (UART, logging).
+*   mcs_lock_t  : MCS queue lock. Each waiter spins on its own mcs_node_t
+*                 (usually on its stack), so a release only touches the
+*                 next waiter's line. Best for heavily contended locks.
+*
+* Both use LSE atomics (LDADD/SWP/CAS) when ID_AA64ISAR0_EL1 reports them
+* and fall back to LDAXR/STLXR otherwise (see atomic_use_lse).
+* Both keep lock_stats_t counters, updated by the holder only.
+*
+* A task that shares a ticket lock with other tasks of a preemptive core
+* (the console lock, SPINLOCK_ADDR) takes it with the _irqsave pair: IRQs
+* stay masked while it is held, so no handler and no preemption
+* (sched_irq_exit) can switch the holder out and leave the lock taken.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#ifndef SPINLOCK_H
+#define SPINLOCK_H
+
+#include <stdint.h>
+#include "ipc/atomic.h"
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+typedef struct {
+    uint64_t acquires;          /* total successful acquisitions           */
+    uint64_t contended;         /* acquisitions that had to wait           */
+    uint64_t wait_cycles;       /* PMCCNTR_EL0 cycles spent waiting        */
+    uint64_t max_wait_cycles;   /* worst single wait                       */
+} lock_stats_t;
+
+typedef struct {
+    volatile uint32_t ticket;   /* [15:0] now serving, [31:16] next ticket */
+    uint32_t          reserved;
+    lock_stats_t      stats;
+} spinlock_t;
+
+typedef struct mcs_node {
+    struct mcs_node * volatile next;    /* successor in the queue          */
+    volatile uint32_t          locked;  /* 1 while we must keep waiting    */
+} mcs_node_t;
+
+typedef struct {
+    mcs_node_t * volatile tail;         /* last waiter, NULL = free        */
+    lock_stats_t          stats;
+} mcs_lock_t;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+void spinlock_init(void);
+void spinlock_lock_init(spinlock_t *lock);
+void spinlock_acquire(spinlock_t *lock);
+void spinlock_release(spinlock_t *lock);
+uint64_t spinlock_acquire_irqsave(spinlock_t *lock);
+void     spinlock_release_irqrestore(spinlock_t *lock, uint64_t daif);
+
+void mcs_lock_init(mcs_lock_t *lock);
+void mcs_lock_acquire(mcs_lock_t *lock, mcs_node_t *node);
+void mcs_lock_release(mcs_lock_t *lock, mcs_node_t *node);
+
+void lock_stats_print(const char *name, const lock_stats_t *stats);
+
+#endif /* SPINLOCK_H */
@@ -0,0 +1,63 @@
+/******************************************************************************
+* File: mem.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+*
+* Built with -fno-tree-loop-distribute-patterns (see Makefile) so GCC does
+* not turn these loops back into calls to themselves. 'used' keeps them
+* alive through LTO, where the calls only appear after code generation.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "libc/mem.h"
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+__attribute__((used))
+void *memcpy(void *dst, const void *src, size_t n)
+{
+    unsigned char *d = (unsigned char *)dst;
+    const unsigned char *s = (const unsigned char *)src;
+
+    while (n--) *d++ = *s++;
+    return dst;
+}
+
+__attribute__((used))
+void *memmove(void *dst, const void *src, size_t n)
+{
+    unsigned char *d = (unsigned char *)dst;
+    const unsigned char *s = (const unsigned char *)src;
+
+    if (d < s) {
+        while (n--) *d++ = *s++;
+    } else {
+        while (n--) d[n] = s[n];            // overlap: copy from the end
+    }
+    return dst;
+}
+
+__attribute__((used))
+void *memset(void *dst, int c, size_t n)
+{
+    unsigned char *d = (unsigned char *)dst;
+
+    while (n--) *d++ = (unsigned char)c;
+    return dst;
+}
+
+__attribute__((used))
+int memcmp(const void *a, const void *b, size_t n)
+{
+    const unsigned char *p = (const unsigned char *)a;
+    const unsigned char *q = (const unsigned char *)b;
+
+    for (; n; n--, p++, q++) {
+        if (*p != *q) return *p - *q;
+    }
+    return 0;
+}
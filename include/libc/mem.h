@@ -0,0 +1,30 @@
+/******************************************************************************
+* File: mem.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: The four memory routines GCC may call on its own
+*
+* Even with -ffreestanding GCC emits calls to memcpy/memmove/memset/memcmp
+* for struct copies and for loops it recognises at -O2 (and LTO may need
+* them after the last object was compiled). The firmware has no libc, so
+* these are the definitions it links against. Plain byte loops: they
+* exist for correctness, hot paths do not depend on them.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef MEM_H
+#define MEM_H
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stddef.h>
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+void *memcpy (void *dst, const void *src, size_t n);
+void *memmove(void *dst, const void *src, size_t n);
+void *memset (void *dst, int c, size_t n);
+int   memcmp (const void *a, const void *b, size_t n);
+
+#endif /* MEM_H */
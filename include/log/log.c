@@ -0,0 +1,157 @@
+/******************************************************************************
+* File: log.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "log/log.h"
+#include "ipc/ipc.h"
+#include "uart/uart0.h"
+#include "pmu/pmu.h"
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+/*
+ * One queue per core: the owning core is the only producer (IRQs are
+ * masked around the push so an ISR cannot interleave with a task), the
+ * logger task is the only consumer. Drop counters live on the producer's
+ * side; 'reported' is private to the logger.
+ */
+static log_queue_t log_queues[LOG_CORES];
+static volatile uint32_t log_drops[LOG_CORES];
+static uint32_t log_reported[LOG_CORES];
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+static inline uint32_t log_core_id(void)
+{
+    uint64_t id;
+    __asm__ volatile("mrs %0, mpidr_el1" : "=r"(id));
+    return (uint32_t)(id & 0xFF);
+}
+
+static inline uint64_t log_timestamp(void)
+{
+    uint64_t v;
+    __asm__ volatile("isb; mrs %0, cntpct_el0" : "=r"(v) :: "memory");
+    return v;
+}
+
+/******************************************************************************
+* Function: log_init
+* Description: Empty every core's queue. Core 0, before secondaries start.
+*****************************************************************************/
+void log_init(void)
+{
+    for (uint32_t i = 0; i < LOG_CORES; i++) {
+        log_queue_init(&log_queues[i]);
+        log_drops[i]    = 0;
+        log_reported[i] = 0;
+    }
+}
+
+/******************************************************************************
+* Function: log_write
+* Description: Append one record to the calling core's queue. Never blocks,
+*              never takes a lock, never touches the UART.
+* Parameters: msg   - static string
+*             value - optional value (see LOG_F_VALUE)
+*             flags - LOG_F_* bits
+*****************************************************************************/
+void log_write(const char *msg, uint64_t value, uint32_t flags)
+{
+    uint32_t core = log_core_id();
+    log_record_t rec = {
+        .timestamp = log_timestamp(),
+        .msg       = msg,
+        .value     = value,
+        .flags     = flags,
+        .core      = core,
+    };
+    uint64_t daif;
+
+    if (core >= LOG_CORES) return;
+
+    __asm__ volatile("mrs %0, daif\n msr daifset, #2" : "=r"(daif) :: "memory");
+    if (log_queue_push(&log_queues[core], &rec) != 0) {
+        log_drops[core]++;              /* only this core writes it */
+    }
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+}
+
+/******************************************************************************
+* Function: log_emit
+* Description: Format one record: "[<ticks>][Core N] msg [value]", the
+*              value in hex, or as the character itself for LOG_F_CHAR
+*****************************************************************************/
+static void log_emit(const log_record_t *rec)
+{
+    uart_puts("[");
+    uart_puthex(rec->timestamp);
+    uart_puts("][Core ");
+    uart_putc('0' + rec->core);
+    uart_puts("] ");
+    uart_puts(rec->msg);
+    if (rec->flags & LOG_F_CHAR) {
+        uart_putc((char)rec->value);
+    } else if (rec->flags & LOG_F_VALUE) {
+        uart_puthex(rec->value);
+    }
+    uart_puts("\n");
+}
+
+/******************************************************************************
+* Function: log_flush
+* Description: Drain up to 'max_per_core' records from every core and emit
+*              them, plus a line for any records dropped since last time.
+*              Single consumer — only the logger task (or a halted system)
+*              may call this. The console lock is taken with IRQs masked,
+*              so a preemptive core cannot switch the logger out holding it.
+* Returns: number of records emitted
+*****************************************************************************/
+unsigned int log_flush(unsigned int max_per_core)
+{
+    unsigned int total = 0;
+    log_record_t rec;
+
+    PMU_PROBE_BEGIN(PMU_PROBE_LOG_FLUSH);
+    for (uint32_t core = 0; core < LOG_CORES; core++) {
+        unsigned int n = 0;
+
+        while (n < max_per_core && log_queue_pop(&log_queues[core], &rec) == 0) {
+            uint64_t daif = spinlock_acquire_irqsave(SPINLOCK_ADDR);  /* whole lines */
+            log_emit(&rec);
+            spinlock_release_irqrestore(SPINLOCK_ADDR, daif);
+            n++;
+        }
+        total += n;
+
+        uint32_t drops = log_drops[core];
+        if (drops != log_reported[core]) {
+            uint64_t daif = spinlock_acquire_irqsave(SPINLOCK_ADDR);
+            uart_puts("[LOG] Core ");
+            uart_putc('0' + core);
+            uart_puts(" dropped ");
+            uart_puthex(drops - log_reported[core]);
+            uart_puts(" records\n");
+            spinlock_release_irqrestore(SPINLOCK_ADDR, daif);
+            log_reported[core] = drops;
+        }
+    }
+    PMU_PROBE_END(PMU_PROBE_LOG_FLUSH);
+    return total;
+}
+
+/******************************************************************************
+* Function: log_dropped
+* Description: Total records dropped by 'core' since log_init()
+*****************************************************************************/
+uint32_t log_dropped(unsigned int core)
+{
+    return (core < LOG_CORES) ? log_drops[core] : 0;
+}
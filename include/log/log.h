@@ -0,0 +1,65 @@
+/******************************************************************************
+* File: log.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Per-core lock-free diagnostic log
+*
+* Each core appends fixed-size records to its own SPSC queue; nothing on
+* the logging side takes a lock or touches the UART. A single low-priority
+* task (logger_task in dispatcher.c) calls log_flush() to format and emit
+* them. When a core's queue is full the record is dropped and counted; the
+* logger prints the drop count the next time it drains that core.
+*
+*   LOG("[Core 3] RX from Core ", sender);     // message + one hex value
+*   LOG_CHAR("Got: ", byte);                   // message + one character
+*   LOG_MSG("[Core 1] ring test done");        // message only
+*
+* 'msg' is stored by pointer: pass string literals / static strings only.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include "queue/queue.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define LOG_CORES           4
+#define LOG_DEPTH           64      /* records per core, power of two      */
+#define LOG_FLUSH_BATCH     16      /* records per core per log_flush()    */
+
+#define LOG_F_VALUE         0x1     /* record carries a value              */
+#define LOG_F_CHAR          0x2     /* ... printed as a character          */
+
+#define LOG(msg, value)     log_write((msg), (uint64_t)(value), LOG_F_VALUE)
+#define LOG_CHAR(msg, c)    log_write((msg), (uint64_t)(uint8_t)(c), LOG_F_VALUE | LOG_F_CHAR)
+#define LOG_MSG(msg)        log_write((msg), 0, 0)
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+typedef struct {
+    uint64_t    timestamp;  /* cntpct_el0 when logged                      */
+    const char *msg;        /* static string                               */
+    uint64_t    value;      /* printed if LOG_F_VALUE: hex, or LOG_F_CHAR  */
+    uint32_t    flags;
+    uint32_t    core;
+} log_record_t;
+
+QUEUE_SPSC_DECLARE(log_queue, log_record_t, LOG_DEPTH)
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+void         log_init(void);
+void         log_write(const char *msg, uint64_t value, uint32_t flags);
+unsigned int log_flush(unsigned int max_per_core);
+uint32_t     log_dropped(unsigned int core);
+
+#endif /* LOG_H */
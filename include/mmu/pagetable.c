@@ -0,0 +1,188 @@
+/******************************************************************************
+* File: pagetable.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Builds the L1/L2/L3 identity map described in pagetable.h
+*
+* Runs on the boot core with the MMU and D-cache off, before main(): every
+* access is Device memory, so the object is built with -mstrict-align and
+* without profiling instrumentation (see Makefile), and nothing here may
+* rely on .data having been written through a cache.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "mmu/pagetable.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define PT_ENTRIES          512
+
+#define PTE_VALID           (1ull << 0)
+#define PTE_BLOCK           (1ull << 0)            /* L1/L2: bits[1:0] = 01 */
+#define PTE_TABLE           (3ull << 0)            /* L1/L2: bits[1:0] = 11 */
+#define PTE_PAGE            (3ull << 0)            /* L3:    bits[1:0] = 11 */
+#define PTE_TYPE_MASK       (3ull << 0)
+#define PTE_ATTR(n)         ((uint64_t)(n) << 2)   /* AttrIndx[4:2]         */
+#define PTE_AP_RO           (2ull << 6)            /* AP[2:1] = 10, EL1 RO  */
+#define PTE_SH_INNER        (3ull << 8)
+#define PTE_AF              (1ull << 10)
+#define PTE_PXN             (1ull << 53)
+#define PTE_UXN             (1ull << 54)
+#define PTE_ADDR_MASK       0x0000FFFFFFFFF000ull
+
+#define PTE_XN              (PTE_PXN | PTE_UXN)
+#define PTE_NORMAL          (PTE_ATTR(MMU_ATTR_NORMAL) | PTE_SH_INNER | PTE_AF)
+
+/* Region attributes, without the descriptor type bits */
+#define PROT_DEVICE         (PTE_ATTR(MMU_ATTR_DEVICE) | PTE_AF | PTE_XN)
+#define PROT_RW             (PTE_NORMAL | PTE_XN)
+#define PROT_RX             (PTE_NORMAL | PTE_AP_RO | PTE_UXN)
+#define PROT_RO             (PTE_NORMAL | PTE_AP_RO | PTE_XN)
+#define PROT_NC             (PTE_ATTR(MMU_ATTR_NC) | PTE_SH_INNER | PTE_AF | PTE_XN)
+#define PROT_NONE           0ull                   /* invalid descriptor    */
+
+#define BOOT_STACK_COUNT    4
+#define L1_INDEX(va)        (((uint64_t)(va) >> 30) & (PT_ENTRIES - 1))
+#define L2_INDEX(va)        (((uint64_t)(va) >> 21) & (PT_ENTRIES - 1))
+#define L3_INDEX(va)        (((uint64_t)(va) >> 12) & (PT_ENTRIES - 1))
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+/* Linker script symbols — only their addresses mean anything */
+extern char __text_start[], __text_end[];
+extern char __rodata_start[], __rodata_end[];
+extern char __task_stacks_start[], __task_stacks_end[];
+extern char __nc_start[], __nc_end[];
+extern char __boot_stacks_start[], __boot_stack_slot[];
+
+uint64_t mmu_l1_table[PT_ENTRIES] __attribute__((aligned(MMU_PAGE_SIZE)));
+static uint64_t l2_ram[PT_ENTRIES] __attribute__((aligned(MMU_PAGE_SIZE)));
+static uint64_t l3_pool[MMU_L3_TABLES][PT_ENTRIES] __attribute__((aligned(MMU_PAGE_SIZE)));
+static uint32_t l3_used;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+static void pt_clear(uint64_t *table)
+{
+    for (uint32_t i = 0; i < PT_ENTRIES; i++) table[i] = 0;
+}
+
+/******************************************************************************
+* Function: l3_for
+* Description: L3 table covering the 2 MB slot that holds 'va'. The first
+*              call for a slot splits its L2 block into 512 pages with the
+*              same attributes, so splitting never changes the mapping.
+* Returns: the table, or 0 when the L3 pool is exhausted
+*****************************************************************************/
+static uint64_t *l3_for(uint64_t va)
+{
+    uint64_t *slot = &l2_ram[L2_INDEX(va)];
+    uint64_t  e    = *slot;
+
+    if ((e & PTE_TYPE_MASK) == PTE_TABLE) {
+        return (uint64_t *)(uintptr_t)(e & PTE_ADDR_MASK);
+    }
+    if (l3_used >= MMU_L3_TABLES) return 0;
+
+    uint64_t *l3   = l3_pool[l3_used++];
+    uint64_t  base = va & ~(uint64_t)(MMU_BLOCK_SIZE - 1);
+    uint64_t  prot = e & ~(PTE_ADDR_MASK | PTE_TYPE_MASK);
+
+    for (uint32_t i = 0; i < PT_ENTRIES; i++) {
+        l3[i] = (e & PTE_VALID) ? (base + i * MMU_PAGE_SIZE) | prot | PTE_PAGE : 0;
+    }
+    *slot = (uint64_t)(uintptr_t)l3 | PTE_TABLE;
+    return l3;
+}
+
+/******************************************************************************
+* Function: map_range
+* Description: Give [start, end) the attributes 'prot' (PROT_NONE unmaps).
+*              Whole 2 MB slots that were never split stay blocks; only
+*              the slots the range partially covers get an L3 table.
+*              Bounds are rounded out to 4 KB pages.
+* Returns: 0, or -1 when the L3 pool is exhausted
+*****************************************************************************/
+static int map_range(uint64_t start, uint64_t end, uint64_t prot)
+{
+    uint64_t va = start & ~(uint64_t)(MMU_PAGE_SIZE - 1);
+
+    end = (end + MMU_PAGE_SIZE - 1) & ~(uint64_t)(MMU_PAGE_SIZE - 1);
+
+    while (va < end) {
+        uint64_t *slot = &l2_ram[L2_INDEX(va)];
+
+        if ((va & (MMU_BLOCK_SIZE - 1)) == 0 && end - va >= MMU_BLOCK_SIZE &&
+            (*slot & PTE_TYPE_MASK) != PTE_TABLE) {
+            *slot = prot ? (va | prot | PTE_BLOCK) : 0;
+            va += MMU_BLOCK_SIZE;
+            continue;
+        }
+
+        uint64_t *l3 = l3_for(va);
+        if (!l3) return -1;
+        l3[L3_INDEX(va)] = prot ? (va | prot | PTE_PAGE) : 0;
+        va += MMU_PAGE_SIZE;
+    }
+    return 0;
+}
+
+/******************************************************************************
+* Function: mmu_build_tables
+* Description: Build the whole map from the linker symbols. Called once by
+*              mmu_on (src/mmu.S) before any core enables its MMU; the other
+*              cores only load TTBR0_EL1 with mmu_l1_table.
+* Returns: 0 on success, -1 if the image needs more than MMU_L3_TABLES
+*          split 2 MB slots (mmu_on then hangs instead of enabling a
+*          partial map)
+*****************************************************************************/
+int mmu_build_tables(void)
+{
+    uintptr_t slot = (uintptr_t)__boot_stack_slot;
+    int rc = 0;
+
+    l3_used = 0;
+    pt_clear(mmu_l1_table);
+    pt_clear(l2_ram);
+    for (uint32_t i = 0; i < MMU_L3_TABLES; i++) pt_clear(l3_pool[i]);
+
+    mmu_l1_table[L1_INDEX(MMU_DEVICE_BASE)] = MMU_DEVICE_BASE | PROT_DEVICE | PTE_BLOCK;
+    mmu_l1_table[L1_INDEX(MMU_RAM_BASE)]    = (uint64_t)(uintptr_t)l2_ram | PTE_TABLE;
+
+    /* Default for all RAM: 2 MB Normal RW-XN blocks */
+    rc |= map_range(MMU_RAM_BASE, MMU_RAM_BASE + (1ull << 30), PROT_RW);
+
+    rc |= map_range((uintptr_t)__text_start,   (uintptr_t)__text_end,   PROT_RX);
+    rc |= map_range((uintptr_t)__rodata_start, (uintptr_t)__rodata_end, PROT_RO);
+    rc |= map_range((uintptr_t)__nc_start,     (uintptr_t)__nc_end,     PROT_NC);
+
+    /* Guard page at the bottom of every stack slot: an overflow faults */
+    for (uintptr_t s = (uintptr_t)__task_stacks_start;
+         s < (uintptr_t)__task_stacks_end; s += MMU_TASK_STACK_SLOT) {
+        rc |= map_range(s, s + MMU_PAGE_SIZE, PROT_NONE);
+    }
+    for (uint32_t core = 0; core < BOOT_STACK_COUNT; core++) {
+        uintptr_t s = (uintptr_t)__boot_stacks_start + core * slot;
+        rc |= map_range(s, s + MMU_PAGE_SIZE, PROT_NONE);
+    }
+
+    /* Table writes must reach memory before the first walk */
+    __asm__ volatile("dsb ish" ::: "memory");
+    return rc ? -1 : 0;
+}
+
+/******************************************************************************
+* Function: mmu_l3_tables_used
+* Description: Number of 2 MB slots split into 4 KB pages by the last build
+*****************************************************************************/
+uint32_t mmu_l3_tables_used(void)
+{
+    return l3_used;
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+* File: pagetable.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Stage-1 translation tables built from the linker symbols
+*
+* mmu_on (src/mmu.S) calls mmu_build_tables() once, with the MMU still off,
+* and points TTBR0_EL1 at mmu_l1_table. Identity map, 4 KB granule, 4 GB VA:
+*
+*   L1[dev]   1 GB block   Device-nGnRnE, XN    (GIC, PL011)
+*   L1[ram]   -> L2        512 x 2 MB blocks, Normal WB, RW, XN
+*   L2 slots the image touches are split into 4 KB L3 pages:
+*     .text                 RO, executable
+*     .rodata / .gcov_info  RO, XN
+*     .data / .bss          RW, XN
+*     .noncacheable         RW, XN, Normal non-cacheable (MMU_NONCACHEABLE)
+*     .task_stacks / .boot_stacks   RW, XN, guard page of every slot unmapped
+*
+* Everything outside the image stays a 2 MB block, so the shared arena
+* and free RAM keep one TLB entry per 2 MB. SCTLR_EL1.WXN is set, so no
+* page is ever writable and executable at the same time.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef PAGETABLE_H
+#define PAGETABLE_H
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+/* Also included by src/mmu.S — keep the C-only parts below the guard */
+#define MMU_PAGE_SIZE        0x1000
+#define MMU_BLOCK_SIZE       0x200000      /* one L2 entry                  */
+#define MMU_L3_TABLES        8             /* 2 MB slots that may be split   */
+
+/* MAIR_EL1: Attr0 Normal WB-WA, Attr1 Device-nGnRnE, Attr2 Normal NC */
+#define MMU_ATTR_NORMAL      0
+#define MMU_ATTR_DEVICE      1
+#define MMU_ATTR_NC          2
+#define MMU_MAIR_VAL         0x4400FF
+
+#if defined(TARGET_RPI5)
+#define MMU_RAM_BASE         0x00000000    /* kernel8.img at 0x80000        */
+#define MMU_DEVICE_BASE      0x40000000
+#else
+#define MMU_RAM_BASE         0x40000000    /* QEMU virt RAM                 */
+#define MMU_DEVICE_BASE      0x00000000    /* GIC 0x08000000, UART 0x09000000 */
+#endif
+
+/* Task stack slot: [guard page][TASK_STACK_SIZE stack], see task_stack_t */
+#define MMU_TASK_STACK_SLOT  0x2000
+
+#ifndef __ASSEMBLER__
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stdint.h>
+
+/* Place a buffer shared with a DMA-capable device in the non-cacheable
+ * region: CPU stores reach memory without cache maintenance. Not zeroed
+ * at boot.                                                              */
+#define MMU_NONCACHEABLE     __attribute__((section(".bss.noncacheable"), aligned(64)))
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+extern uint64_t mmu_l1_table[512];
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+int      mmu_build_tables(void);
+uint32_t mmu_l3_tables_used(void);
+
+#endif /* __ASSEMBLER__ */
+#endif /* PAGETABLE_H */
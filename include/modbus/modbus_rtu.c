@@ -0,0 +1,349 @@
+/******************************************************************************
+* File: modbus_rtu.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Modbus RTU master engine, see modbus_rtu.h
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "modbus/modbus_rtu.h"
+#include "alloc/arena.h"
+#include "crc/crc.h"
+#include "libc/mem.h"
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+static inline void put16(uint8_t *p, uint16_t v)       /* big-endian PDU */
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static inline uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/******************************************************************************
+* Function: modbus_crc16
+* Description: CRC-16/MODBUS of an ADU (crc/crc.h, slicing-by-8). The ADU
+*              carries it low byte first.
+*****************************************************************************/
+uint16_t modbus_crc16(const uint8_t *p, uint32_t len)
+{
+    return crc16_modbus(p, len);
+}
+
+/******************************************************************************
+* Function: modbus_master_init
+* Description: Bind an engine to its transport and derive the frame timing
+*              from the port's baud rate and cntfrq. The consumer queue is
+*              carved from the shared arena, so call this at boot.
+* Returns: 0, or -1 for a zero baud rate or an exhausted arena
+*****************************************************************************/
+int modbus_master_init(modbus_master_t *m, const modbus_port_t *port)
+{
+    uint64_t freq;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+
+    if (!port || !port->write || port->baud == 0) return -1;
+
+    memset(m, 0, sizeof(*m));
+    m->port = *port;
+    m->out  = ARENA_NEW(modbus_frame_q_t);
+    if (!m->out) return -1;
+    modbus_frame_q_init(m->out);
+
+    m->char_ticks = freq * MODBUS_CHAR_BITS / port->baud;
+    if (port->baud > MODBUS_FIXED_T_BAUD) {
+        m->t15 = freq * MODBUS_T15_FIXED_US / 1000000u;
+        m->t35 = freq * MODBUS_T35_FIXED_US / 1000000u;
+    } else {
+        m->t15 = m->char_ticks * 3 / 2;
+        m->t35 = m->char_ticks * 7 / 2;
+    }
+    m->timeout = freq / 1000u * MODBUS_TIMEOUT_MS;
+    m->state   = MODBUS_STATE_IDLE;
+
+    return 0;
+}
+
+/* Append the CRC, hand the ADU to the transport and open the transaction */
+static int modbus_send(modbus_master_t *m, uint64_t now)
+{
+    uint16_t crc = modbus_crc16(m->tx, m->tx_len);
+
+    m->tx[m->tx_len++] = (uint8_t)crc;
+    m->tx[m->tx_len++] = (uint8_t)(crc >> 8);
+
+    m->state    = MODBUS_STATE_WAIT;
+    m->rx_len   = 0;
+    m->rx_bad   = 0;
+    m->deadline = now + m->tx_len * m->char_ticks + m->timeout;
+    m->stats.requests++;
+
+    if (m->port.write(m->port.ctx, m->tx, m->tx_len) != 0) {
+        m->state = MODBUS_STATE_IDLE;
+        return -1;
+    }
+    return 0;
+}
+
+static inline int modbus_can_send(const modbus_master_t *m, uint8_t slave)
+{
+    return !modbus_busy(m) && slave >= MODBUS_SLAVE_MIN && slave <= MODBUS_SLAVE_MAX;
+}
+
+/******************************************************************************
+* Function: modbus_read_registers
+* Description: Send FC 3 (holding) or FC 4 (input) for 'count' registers
+* Returns: 0, or -1 if a transaction is open, the bus is busy or the
+*          arguments are out of range
+*****************************************************************************/
+int modbus_read_registers(modbus_master_t *m, uint8_t slave, uint8_t fc,
+                          uint16_t addr, uint16_t count, uint64_t now)
+{
+    if (!modbus_can_send(m, slave) || count == 0 || count > MODBUS_READ_MAX ||
+        (fc != MODBUS_FC_READ_HOLDING && fc != MODBUS_FC_READ_INPUT)) {
+        return -1;
+    }
+
+    m->tx[0] = slave;
+    m->tx[1] = fc;
+    put16(&m->tx[2], addr);
+    put16(&m->tx[4], count);
+    m->tx_len = 6;
+
+    m->req_slave = slave;
+    m->req_fc    = fc;
+    m->req_addr  = addr;
+    m->req_count = count;
+    return modbus_send(m, now);
+}
+
+/******************************************************************************
+* Function: modbus_write_register
+* Description: Send FC 6, one holding register
+* Returns: 0, or -1 (see modbus_read_registers)
+*****************************************************************************/
+int modbus_write_register(modbus_master_t *m, uint8_t slave,
+                          uint16_t addr, uint16_t value, uint64_t now)
+{
+    if (!modbus_can_send(m, slave)) return -1;
+
+    m->tx[0] = slave;
+    m->tx[1] = MODBUS_FC_WRITE_SINGLE;
+    put16(&m->tx[2], addr);
+    put16(&m->tx[4], value);
+    m->tx_len = 6;
+
+    m->req_slave = slave;
+    m->req_fc    = MODBUS_FC_WRITE_SINGLE;
+    m->req_addr  = addr;
+    m->req_count = 1;
+    m->req_value = value;
+    return modbus_send(m, now);
+}
+
+/******************************************************************************
+* Function: modbus_write_registers
+* Description: Send FC 16, 'count' consecutive holding registers
+* Returns: 0, or -1 (see modbus_read_registers)
+*****************************************************************************/
+int modbus_write_registers(modbus_master_t *m, uint8_t slave, uint16_t addr,
+                           uint16_t count, const uint16_t *values, uint64_t now)
+{
+    if (!modbus_can_send(m, slave) || count == 0 || count > MODBUS_WRITE_MAX) return -1;
+
+    m->tx[0] = slave;
+    m->tx[1] = MODBUS_FC_WRITE_MULTIPLE;
+    put16(&m->tx[2], addr);
+    put16(&m->tx[4], count);
+    m->tx[6] = (uint8_t)(count * 2);
+    for (uint32_t i = 0; i < count; i++) put16(&m->tx[7 + 2 * i], values[i]);
+    m->tx_len = (uint16_t)(7 + 2 * count);
+
+    m->req_slave = slave;
+    m->req_fc    = MODBUS_FC_WRITE_MULTIPLE;
+    m->req_addr  = addr;
+    m->req_count = count;
+    return modbus_send(m, now);
+}
+
+/******************************************************************************
+* Function: modbus_check
+* Description: Validate the reply in rx[0..n) against the open request and
+*              parse it into 'f'. The CRC is checked before any field.
+* Returns: modbus_status_t
+*****************************************************************************/
+static modbus_status_t modbus_check(const modbus_master_t *m, uint32_t n,
+                                    int bad, modbus_frame_t *f)
+{
+    const uint8_t *rx = m->rx;
+
+    if (bad || n < 4) return MODBUS_ERR_FRAME;
+    if (modbus_crc16(rx, n - 2) != (uint16_t)(rx[n - 2] | (rx[n - 1] << 8))) {
+        return MODBUS_ERR_CRC;
+    }
+    if (rx[0] != m->req_slave) return MODBUS_ERR_MISMATCH;
+
+    if (rx[1] == (m->req_fc | MODBUS_EXCEPTION)) {
+        if (n != 5) return MODBUS_ERR_FRAME;
+        f->exception = rx[2];
+        return MODBUS_ERR_EXCEPTION;
+    }
+    if (rx[1] != m->req_fc) return MODBUS_ERR_MISMATCH;
+
+    switch (m->req_fc) {
+    case MODBUS_FC_READ_HOLDING:
+    case MODBUS_FC_READ_INPUT:
+        if (n != 5u + 2u * m->req_count || rx[2] != 2 * m->req_count) return MODBUS_ERR_FRAME;
+        for (uint32_t i = 0; i < m->req_count; i++) f->regs[i] = get16(&rx[3 + 2 * i]);
+        return MODBUS_OK;
+
+    case MODBUS_FC_WRITE_SINGLE:
+        if (n != 8) return MODBUS_ERR_FRAME;
+        if (get16(&rx[2]) != m->req_addr || get16(&rx[4]) != m->req_value) {
+            return MODBUS_ERR_MISMATCH;
+        }
+        f->regs[0] = m->req_value;
+        return MODBUS_OK;
+
+    case MODBUS_FC_WRITE_MULTIPLE:
+        if (n != 8) return MODBUS_ERR_FRAME;
+        if (get16(&rx[2]) != m->req_addr || get16(&rx[4]) != m->req_count) {
+            return MODBUS_ERR_MISMATCH;
+        }
+        return MODBUS_OK;
+
+    default:
+        return MODBUS_ERR_MISMATCH;
+    }
+}
+
+/* Close the transaction with 'status' and queue its record */
+static void modbus_emit(modbus_master_t *m, modbus_frame_t *f, modbus_status_t status,
+                        uint64_t stamp)
+{
+    f->stamp  = stamp;
+    f->slave  = m->req_slave;
+    f->fc     = m->req_fc;
+    f->status = (uint8_t)status;
+    f->addr   = m->req_addr;
+    f->count  = m->req_count;
+
+    switch (status) {
+    case MODBUS_OK:            m->stats.frames++;       break;
+    case MODBUS_ERR_TIMEOUT:   m->stats.timeouts++;     break;
+    case MODBUS_ERR_CRC:       m->stats.crc_errors++;   break;
+    case MODBUS_ERR_FRAME:     m->stats.frame_errors++; break;
+    case MODBUS_ERR_MISMATCH:  m->stats.mismatches++;   break;
+    case MODBUS_ERR_EXCEPTION: m->stats.exceptions++;   break;
+    }
+
+    m->state = MODBUS_STATE_IDLE;
+    if (modbus_frame_q_push(m->out, f) != 0) m->stats.dropped++;
+}
+
+/* t3.5 of silence after rx[]: the frame is complete */
+static int modbus_close(modbus_master_t *m, uint64_t stamp)
+{
+    modbus_frame_t f;
+    uint32_t n   = m->rx_len;
+    int      bad = m->rx_bad;
+
+    m->rx_len = 0;
+    m->rx_bad = 0;
+
+    if (m->state != MODBUS_STATE_WAIT) {
+        m->stats.unexpected++;              /* stray traffic on the line */
+        return 0;
+    }
+
+    f.exception = 0;
+    modbus_emit(m, &f, modbus_check(m, n, bad, &f), stamp);
+    return 1;
+}
+
+/******************************************************************************
+* Function: modbus_rx_feed
+* Description: Bytes received at cntpct 'now' (one call per FIFO drain,
+*              'now' taken when the burst was read). The burst's own bytes
+*              took len character times on the wire before 'now', so only
+*              the rest of the gap since the previous burst is silence. A
+*              silence of t3.5 closes the previous frame first; one above
+*              t1.5 marks the frame in progress bad. Bytes beyond
+*              MODBUS_ADU_MAX mark it bad too.
+*****************************************************************************/
+void modbus_rx_feed(modbus_master_t *m, const uint8_t *buf, uint32_t len, uint64_t now)
+{
+    if (!len) return;
+
+    if (m->rx_len) {
+        uint64_t gap  = now - m->last_rx;
+        uint64_t wire = (uint64_t)len * m->char_ticks;
+        uint64_t idle = gap > wire ? gap - wire : 0;
+
+        if (idle >= m->t35)      modbus_close(m, m->last_rx + m->t35);
+        else if (idle > m->t15)  m->rx_bad = 1;
+    }
+
+    uint32_t room = MODBUS_ADU_MAX - m->rx_len;
+    if (len > room) {
+        m->rx_bad = 1;
+        len = room;
+    }
+    memcpy(&m->rx[m->rx_len], buf, len);
+    m->rx_len  = (uint16_t)(m->rx_len + len);
+    m->last_rx = now;
+}
+
+/******************************************************************************
+* Function: modbus_poll
+* Description: Time-driven half of the engine: end the frame once the line
+*              has been silent for t3.5, or fail the open request once its
+*              response timeout has passed with nothing received.
+* Returns: 1 if a transaction finished (a record was queued), else 0
+*****************************************************************************/
+int modbus_poll(modbus_master_t *m, uint64_t now)
+{
+    if (m->rx_len && now - m->last_rx >= m->t35) {
+        return modbus_close(m, m->last_rx + m->t35);
+    }
+    if (m->state == MODBUS_STATE_WAIT && !m->rx_len && now >= m->deadline) {
+        modbus_frame_t f;
+        f.exception = 0;
+        modbus_emit(m, &f, MODBUS_ERR_TIMEOUT, now);
+        return 1;
+    }
+    return 0;
+}
+
+/******************************************************************************
+* Function: modbus_next_deadline
+* Description: When modbus_poll() next has something to do: the end of the
+*              frame being received, else the reply timeout
+* Returns: cntpct, or MODBUS_NO_DEADLINE with no transaction open
+*****************************************************************************/
+uint64_t modbus_next_deadline(const modbus_master_t *m)
+{
+    if (m->rx_len)                      return m->last_rx + m->t35;
+    if (m->state == MODBUS_STATE_WAIT)  return m->deadline;
+    return MODBUS_NO_DEADLINE;
+}
+
+/******************************************************************************
+* Function: modbus_frame_pop
+* Description: Consumer side: take the oldest finished transaction. May run
+*              on another core than the engine (single consumer).
+* Returns: 0, or -1 if there is none
+*****************************************************************************/
+int modbus_frame_pop(modbus_master_t *m, modbus_frame_t *f)
+{
+    return modbus_frame_q_pop(m->out, f);
+}
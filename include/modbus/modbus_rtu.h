@@ -0,0 +1,159 @@
+/******************************************************************************
+* File: modbus_rtu.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Modbus RTU master: framing, CRC and function codes 3/4/6/16
+*
+* The engine owns one serial line and runs one transaction at a time:
+*
+*   modbus_read_registers()  / modbus_write_register() /
+*   modbus_write_registers()     build the request ADU and hand it to the
+*                                port's write() (the transport, e.g. a UART)
+*   modbus_rx_feed()             bytes as they arrive, with their cntpct
+*   modbus_poll()                closes the frame after t3.5 of silence,
+*                                checks it and emits a modbus_frame_t
+*
+* Frame boundaries follow the RTU rules on cntpct_el0 timestamps: a gap
+* longer than t1.5 inside a frame marks it bad, a silence of t3.5 ends it.
+* Both are 1.5 / 3.5 character times (11 bits each) up to 19200 baud and
+* fixed at 750 us / 1750 us above. A UART with a FIFO delivers bytes in
+* bursts stamped when they are read, so the gap between two bursts counts
+* as silence only after the second burst's own wire time is taken off.
+*
+* The reply is checked (length, CRC, slave address, function code or its
+* exception form, echoed fields) and parsed into a fixed-size
+* modbus_frame_t, which goes into an SPSC queue for the consumer core
+* (modbus_frame_pop). Nothing is locked per byte: the byte path belongs to
+* the core that drives the engine, and the queue is the only shared state.
+* Timeouts and bad replies are reported the same way, with a status.
+*
+* modbus_next_deadline() tells the driver when modbus_poll() has work, so
+* it can sleep on a timer (timer/timer_wheel.h) instead of spinning.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef MODBUS_RTU_H
+#define MODBUS_RTU_H
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stdint.h>
+#include "queue/queue.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define MODBUS_ADU_MAX              256     /* address + PDU + CRC         */
+#define MODBUS_READ_MAX             125     /* registers per FC 3 / 4      */
+#define MODBUS_WRITE_MAX            123     /* registers per FC 16         */
+#define MODBUS_SLAVE_MIN            1       /* 0 (broadcast) not supported */
+#define MODBUS_SLAVE_MAX            247
+
+#define MODBUS_FC_READ_HOLDING      0x03
+#define MODBUS_FC_READ_INPUT        0x04
+#define MODBUS_FC_WRITE_SINGLE      0x06
+#define MODBUS_FC_WRITE_MULTIPLE    0x10
+#define MODBUS_EXCEPTION            0x80    /* function code | 0x80        */
+
+#define MODBUS_CHAR_BITS            11      /* start + 8 data + parity/stop + stop */
+#define MODBUS_FIXED_T_BAUD         19200   /* above: fixed t1.5 / t3.5    */
+#define MODBUS_T15_FIXED_US         750
+#define MODBUS_T35_FIXED_US         1750
+#define MODBUS_TIMEOUT_MS           100     /* default response timeout    */
+#define MODBUS_FRAME_QUEUE_DEPTH    16      /* parsed frames in flight     */
+#define MODBUS_NO_DEADLINE          UINT64_MAX
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+typedef enum {
+    MODBUS_OK            = 0,
+    MODBUS_ERR_TIMEOUT   = 1,   /* no reply within the response timeout  */
+    MODBUS_ERR_CRC       = 2,
+    MODBUS_ERR_FRAME     = 3,   /* t1.5 gap, overrun or wrong length     */
+    MODBUS_ERR_MISMATCH  = 4,   /* other slave, function or echoed field */
+    MODBUS_ERR_EXCEPTION = 5    /* slave answered with an exception      */
+} modbus_status_t;
+
+/* One finished transaction, as the consumer core receives it */
+typedef struct {
+    uint64_t stamp;                     /* cntpct when the frame closed  */
+    uint8_t  slave;
+    uint8_t  fc;                        /* request function code         */
+    uint8_t  status;                    /* modbus_status_t               */
+    uint8_t  exception;                 /* exception code, if any        */
+    uint16_t addr;                      /* first register                */
+    uint16_t count;                     /* registers read / written      */
+    uint16_t regs[MODBUS_READ_MAX];     /* FC 3 / 4: values read         */
+} modbus_frame_t;
+
+QUEUE_SPSC_DECLARE(modbus_frame_q, modbus_frame_t, MODBUS_FRAME_QUEUE_DEPTH)
+
+/* Transport: write() queues a whole ADU for transmission, 0 on success */
+typedef struct {
+    int      (*write)(void *ctx, const uint8_t *buf, uint32_t len);
+    void      *ctx;
+    uint32_t   baud;
+} modbus_port_t;
+
+typedef struct {
+    uint64_t requests;
+    uint64_t frames;                    /* replies with MODBUS_OK        */
+    uint64_t timeouts;
+    uint64_t crc_errors;
+    uint64_t frame_errors;
+    uint64_t mismatches;
+    uint64_t exceptions;
+    uint64_t unexpected;                /* frames with no request open   */
+    uint64_t dropped;                   /* consumer queue full           */
+} modbus_stats_t;
+
+typedef enum {
+    MODBUS_STATE_IDLE  = 0,
+    MODBUS_STATE_WAIT  = 1              /* request sent, reply pending   */
+} modbus_state_t;
+
+typedef struct {
+    modbus_port_t     port;
+    modbus_frame_q_t *out;              /* to the consumer core          */
+    uint64_t          char_ticks;       /* cntpct per character          */
+    uint64_t          t15, t35;         /* cntpct                        */
+    uint64_t          timeout;          /* cntpct, after the request     */
+    uint64_t          last_rx;          /* cntpct of the last byte       */
+    uint64_t          deadline;         /* reply timeout                 */
+    uint8_t           state;            /* modbus_state_t                */
+    uint8_t           rx_bad;           /* t1.5 gap or overrun           */
+    uint16_t          rx_len;
+    uint16_t          tx_len;
+    uint8_t           req_slave, req_fc;
+    uint16_t          req_addr, req_count;
+    uint16_t          req_value;        /* FC 6 echo                     */
+    modbus_stats_t    stats;
+    uint8_t           rx[MODBUS_ADU_MAX];
+    uint8_t           tx[MODBUS_ADU_MAX];
+} modbus_master_t;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+int      modbus_master_init(modbus_master_t *m, const modbus_port_t *port);
+uint16_t modbus_crc16(const uint8_t *p, uint32_t len);
+
+int      modbus_read_registers(modbus_master_t *m, uint8_t slave, uint8_t fc,
+                               uint16_t addr, uint16_t count, uint64_t now);
+int      modbus_write_register(modbus_master_t *m, uint8_t slave,
+                               uint16_t addr, uint16_t value, uint64_t now);
+int      modbus_write_registers(modbus_master_t *m, uint8_t slave, uint16_t addr,
+                                uint16_t count, const uint16_t *values, uint64_t now);
+
+void     modbus_rx_feed(modbus_master_t *m, const uint8_t *buf, uint32_t len, uint64_t now);
+int      modbus_poll(modbus_master_t *m, uint64_t now);
+uint64_t modbus_next_deadline(const modbus_master_t *m);
+int      modbus_frame_pop(modbus_master_t *m, modbus_frame_t *f);
+
+static inline int modbus_busy(const modbus_master_t *m)
+{
+    return m->state != MODBUS_STATE_IDLE || m->rx_len != 0;
+}
+
+#endif /* MODBUS_RTU_H */
@@ -0,0 +1,174 @@
+/******************************************************************************
+* File: mqtt.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: MQTT 3.1.1 PUBLISH encoder, see mqtt.h
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "mqtt/mqtt.h"
+#include "uart/uart0.h"
+#include "libc/mem.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define MQTT_QOS_MASK       0x06
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+/******************************************************************************
+* Function: mqtt_uart_writev
+* Description: UART transport: every segment through uart_write(), in
+*              order. Waits (yield) while the TX ring is full.
+* Returns: 0
+*****************************************************************************/
+static int mqtt_uart_writev(void *ctx, const mqtt_iov_t *iov, uint32_t n)
+{
+    (void)ctx;
+
+    for (uint32_t i = 0; i < n; i++) {
+        const uint8_t *p    = iov[i].base;
+        uint32_t       left = iov[i].len;
+
+        while (left) {
+            uint32_t sent = uart_write(p, left);
+            if (!sent) __asm__ volatile("yield");
+            p    += sent;
+            left -= sent;
+        }
+    }
+    return 0;
+}
+
+const mqtt_transport_t mqtt_uart_transport = { mqtt_uart_writev, 0 };
+
+/******************************************************************************
+* Function: mqtt_varint_encode
+* Description: MQTT remaining length: 7 bits per byte, least significant
+*              group first, bit 7 set on every byte but the last
+* Returns: bytes written (1..4), 0 if value exceeds MQTT_REMAINING_MAX
+*****************************************************************************/
+uint32_t mqtt_varint_encode(uint8_t *out, uint32_t value)
+{
+    uint32_t n = 0;
+
+    if (value > MQTT_REMAINING_MAX) return 0;
+    do {
+        uint8_t b = value & 0x7F;
+        value >>= 7;
+        out[n++] = value ? (uint8_t)(b | 0x80) : b;
+    } while (value);
+    return n;
+}
+
+/******************************************************************************
+* Function: mqtt_writer_init
+* Description: Empty batch on transport 'tx', packet identifiers from 1
+*****************************************************************************/
+void mqtt_writer_init(mqtt_writer_t *w, const mqtt_transport_t *tx)
+{
+    memset(w, 0, sizeof(*w));
+    w->tx      = *tx;
+    w->next_id = 1;
+}
+
+/******************************************************************************
+* Function: mqtt_flush
+* Description: Hand the batch to the transport in one writev() call. On
+*              failure the batch is kept as it is, for a retry.
+* Returns: 0 (also for an empty batch), or -1 if the transport failed
+*****************************************************************************/
+int mqtt_flush(mqtt_writer_t *w)
+{
+    if (!w->iov_count) return 0;
+
+    if (w->tx.writev(w->tx.ctx, w->iov, w->iov_count) != 0) {
+        w->stats.tx_errors++;
+        return -1;
+    }
+    w->stats.packets += w->packets;
+    w->stats.batches++;
+    w->stats.bytes   += w->bytes;
+
+    w->packets   = 0;
+    w->iov_count = 0;
+    w->hdr_used  = 0;
+    w->bytes     = 0;
+    return 0;
+}
+
+/******************************************************************************
+* Function: mqtt_publish
+* Description: Append one PUBLISH to the batch. The fixed header, topic and
+*              packet identifier are encoded into the batch's header area;
+*              the 'n' payload segments are referenced, not copied (empty
+*              ones are skipped). Flushes first if the batch is full.
+* Parameters: topic - NUL-terminated topic name, 1..MQTT_TOPIC_MAX bytes,
+*                     no wildcards
+*             flags - MQTT_QOS0/1/2 | MQTT_RETAIN | MQTT_DUP
+* Returns: the packet identifier for QoS 1 / 2, 0 for QoS 0, or -1 for a
+*          bad topic, flags (QoS 3, DUP with QoS 0) or size, or a failed
+*          flush
+*****************************************************************************/
+int mqtt_publish(mqtt_writer_t *w, const char *topic, uint8_t flags,
+                 const mqtt_iov_t *payload, uint32_t n)
+{
+    uint32_t tlen = 0, plen = 0, rem;
+    uint8_t  qos  = flags & MQTT_QOS_MASK;
+    int      id   = 0;
+
+    if ((flags & ~MQTT_FLAGS_MASK) || qos == MQTT_QOS_MASK || n > MQTT_PAYLOAD_IOV_MAX) return -1;
+    if ((flags & MQTT_DUP) && !qos) return -1;         /* [MQTT-3.3.1-2] */
+
+    while (topic[tlen]) {
+        if (tlen == MQTT_TOPIC_MAX || topic[tlen] == '+' || topic[tlen] == '#') return -1;
+        tlen++;
+    }
+    if (!tlen) return -1;
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (payload[i].len > MQTT_REMAINING_MAX - plen) return -1;
+        plen += payload[i].len;
+    }
+    rem = 2 + tlen + (qos ? 2 : 0);
+    if (plen > MQTT_REMAINING_MAX - rem) return -1;
+    rem += plen;
+
+    if (w->packets == MQTT_BATCH_PACKETS || w->iov_count + 1 + n > MQTT_BATCH_IOV) {
+        if (mqtt_flush(w) != 0) return -1;
+    }
+
+    /* Fixed header, topic and packet id, in place */
+    uint8_t *h = &w->hdr[w->hdr_used];
+    uint32_t k = 0;
+
+    h[k++] = (uint8_t)(MQTT_PUBLISH | flags);
+    k += mqtt_varint_encode(&h[k], rem);
+    h[k++] = (uint8_t)(tlen >> 8);
+    h[k++] = (uint8_t)tlen;
+    for (uint32_t i = 0; i < tlen; i++) h[k++] = (uint8_t)topic[i];
+    if (qos) {
+        id = w->next_id;
+        w->next_id = (uint16_t)(w->next_id + 1) ? (uint16_t)(w->next_id + 1) : 1;
+        h[k++] = (uint8_t)(id >> 8);
+        h[k++] = (uint8_t)id;
+    }
+
+    w->iov[w->iov_count].base = h;
+    w->iov[w->iov_count].len  = k;
+    w->iov_count++;
+    for (uint32_t i = 0; i < n; i++) {
+        if (payload[i].len) w->iov[w->iov_count++] = payload[i];
+    }
+
+    w->hdr_used += k;
+    w->bytes    += k + plen;
+    w->packets++;
+    return id;
+}
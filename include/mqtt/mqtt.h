@@ -0,0 +1,106 @@
+/******************************************************************************
+* File: mqtt.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: MQTT 3.1.1 PUBLISH encoder, batched scatter-gather output
+*
+* A writer collects PUBLISH packets into a batch and hands the whole batch
+* to its transport in one writev() call:
+*
+*   mqtt_publish()   encode the fixed header (type, flags, remaining length
+*                    as a 1..4 byte varint), the topic and the packet id
+*                    into the batch's header area, then queue one iovec for
+*                    that header and one per payload segment
+*   mqtt_flush()     writev(iov[], n) to the transport, empty the batch
+*
+* Payloads are never copied by the encoder: the iovecs point at the
+* caller's buffers, which must stay unchanged until the batch is flushed
+* (mqtt_flush() returned, or an mqtt_publish() that flushed a full batch).
+* The transport makes the one copy it needs, e.g. the UART's into its TX
+* ring. A full batch is flushed by mqtt_publish() before it adds a packet.
+*
+* Transports: mqtt_uart_transport writes to the PL011 through uart_write()
+* (interrupt-driven mode, after uart_irq_init()), waiting for room in the
+* TX ring when the wire is behind. Others (a socket, a DMA ring) fill in
+* an mqtt_transport_t.
+*
+* One writer per core / task: nothing here is locked.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef MQTT_H
+#define MQTT_H
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stdint.h>
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define MQTT_PUBLISH            0x30    /* packet type 3 << 4              */
+#define MQTT_RETAIN             0x01    /* PUBLISH flags (fixed header)    */
+#define MQTT_QOS0               0x00
+#define MQTT_QOS1               0x02
+#define MQTT_QOS2               0x04
+#define MQTT_DUP                0x08
+#define MQTT_FLAGS_MASK         0x0F
+
+#define MQTT_REMAINING_MAX      268435455u  /* 4-byte varint limit         */
+#define MQTT_TOPIC_MAX          64
+#define MQTT_HDR_MAX            (1 + 4 + 2 + MQTT_TOPIC_MAX + 2)
+
+#define MQTT_BATCH_PACKETS      16      /* packets per writev()            */
+#define MQTT_BATCH_IOV          64      /* header + payload segments       */
+#define MQTT_PAYLOAD_IOV_MAX    (MQTT_BATCH_IOV - 1)
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+typedef struct {
+    const uint8_t *base;
+    uint32_t       len;
+} mqtt_iov_t;
+
+/* writev() sends all 'n' segments in order: 0, or -1 (batch kept) */
+typedef struct {
+    int   (*writev)(void *ctx, const mqtt_iov_t *iov, uint32_t n);
+    void   *ctx;
+} mqtt_transport_t;
+
+typedef struct {
+    uint64_t packets;                   /* PUBLISH packets sent          */
+    uint64_t batches;                   /* writev() calls that succeeded */
+    uint64_t bytes;
+    uint64_t tx_errors;                 /* writev() calls that failed    */
+} mqtt_stats_t;
+
+typedef struct {
+    mqtt_transport_t tx;
+    uint16_t         next_id;           /* QoS 1 / 2 packet identifier   */
+    uint16_t         packets;           /* in the current batch          */
+    uint32_t         iov_count;
+    uint32_t         hdr_used;
+    uint64_t         bytes;             /* encoded, current batch        */
+    mqtt_stats_t     stats;
+    mqtt_iov_t       iov[MQTT_BATCH_IOV];
+    uint8_t          hdr[MQTT_BATCH_PACKETS * MQTT_HDR_MAX];
+} mqtt_writer_t;
+
+extern const mqtt_transport_t mqtt_uart_transport;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+void     mqtt_writer_init(mqtt_writer_t *w, const mqtt_transport_t *tx);
+int      mqtt_publish(mqtt_writer_t *w, const char *topic, uint8_t flags,
+                      const mqtt_iov_t *payload, uint32_t n);
+int      mqtt_flush(mqtt_writer_t *w);
+uint32_t mqtt_varint_encode(uint8_t *out, uint32_t value);
+
+static inline uint32_t mqtt_batch_packets(const mqtt_writer_t *w)
+{
+    return w->packets;
+}
+
+#endif /* MQTT_H */
@@ -0,0 +1,105 @@
+/******************************************************************************
+* File: pgo.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "pgo/pgo.h"
+#include "semihost/semihost.h"
+#include "uart/uart0.h"
+
+#ifdef PGO_GEN
+#include <stdint.h>
+#include <gcov.h>
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+extern const struct gcov_info *const __gcov_info_start[];
+extern const struct gcov_info *const __gcov_info_end[];
+
+/* libgcov, GCC 13+ (not yet in every toolchain's gcov.h): frames a filename
+ * record in the stream so 'gcov-tool merge-stream' knows where it goes */
+extern void __gcov_filename_to_gcfn(const char *filename,
+                                    void (*dump_fn)(const void *, unsigned, void *),
+                                    void *arg);
+
+/* Bump heap for __gcov_info_to_gcda; reset per object */
+static uint8_t  pgo_heap[PGO_HEAP_SIZE] __attribute__((aligned(16)));
+static uint32_t pgo_heap_used;
+static int      pgo_failed;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+/*
+ * The counter merge routines are referenced from every gcov_info but only
+ * run when libgcov reads an existing .gcda, which never happens on target.
+ * Weak no-ops keep the linker from pulling libgcov's file I/O in.
+ */
+__attribute__((weak)) void __gcov_merge_add(int64_t *c, unsigned n)          { (void)c; (void)n; }
+__attribute__((weak)) void __gcov_merge_ior(int64_t *c, unsigned n)          { (void)c; (void)n; }
+__attribute__((weak)) void __gcov_merge_topn(int64_t *c, unsigned n)         { (void)c; (void)n; }
+__attribute__((weak)) void __gcov_merge_time_profile(int64_t *c, unsigned n) { (void)c; (void)n; }
+
+static void pgo_write(const void *data, unsigned len, void *arg)
+{
+    if (semihost_write(*(long *)arg, data, len) != 0) pgo_failed = 1;
+}
+
+static void pgo_filename(const char *name, void *arg)
+{
+    __gcov_filename_to_gcfn(name, pgo_write, arg);
+}
+
+static void *pgo_alloc(unsigned len, void *arg)
+{
+    (void)arg;
+    len = (len + 15u) & ~15u;
+    if (pgo_heap_used + len > PGO_HEAP_SIZE) {
+        pgo_failed = 1;
+        return 0;
+    }
+    void *p = &pgo_heap[pgo_heap_used];
+    pgo_heap_used += len;
+    return p;
+}
+#endif /* PGO_GEN */
+
+/******************************************************************************
+* Function: pgo_dump
+* Description: Write the counters of every instrumented object as one gcov
+*              stream to PGO_STREAM on the host. Call once, at the end of
+*              the training run, with the other cores quiet.
+* Returns: 0 on success, -1 on failure or in non-instrumented builds
+*****************************************************************************/
+int pgo_dump(void)
+{
+#if defined(PGO_GEN) && SEMIHOST_AVAILABLE
+    long fd = semihost_open(PGO_STREAM, SEMIHOST_MODE_WB);
+    if (fd < 0) {
+        uart_puts("[PGO] cannot open " PGO_STREAM " (run QEMU with -semihosting)\n");
+        return -1;
+    }
+
+    pgo_failed = 0;
+    uint32_t objects = 0;
+    for (const struct gcov_info *const *info = __gcov_info_start;
+         info < __gcov_info_end; info++) {
+        pgo_heap_used = 0;
+        __gcov_info_to_gcda(*info, pgo_filename, pgo_write, pgo_alloc, &fd);
+        objects++;
+    }
+    semihost_close(fd);
+
+    uart_puts("[PGO] wrote " PGO_STREAM ", objects: ");
+    uart_putdec(objects);
+    uart_puts(pgo_failed ? " (FAILED)\n" : "\n");
+    return pgo_failed ? -1 : 0;
+#else
+    return -1;
+#endif
+}
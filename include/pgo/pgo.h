@@ -0,0 +1,36 @@
+/******************************************************************************
+* File: pgo.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: gcov profile export for profile-guided optimisation
+*
+* 'make pgo' builds the bench image with -fprofile-generate
+* -fprofile-info-section (PGO_GEN defined). GCC then puts one pointer per
+* instrumented object into .gcov_info (bracketed by __gcov_info_start /
+* __gcov_info_end in the linker scripts) instead of registering
+* constructors that would need a libc.
+*
+* pgo_dump() serialises every object's counters with libgcov's
+* __gcov_info_to_gcda() into a single gcov stream and writes it to the
+* host over semihosting. On the host, 'gcov-tool merge-stream' turns the
+* stream back into the .gcda files that -fprofile-use reads.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef PGO_H
+#define PGO_H
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#ifndef PGO_STREAM
+#define PGO_STREAM          "gcov.stream"   /* Makefile passes $(BUILD)/gcov.stream */
+#endif
+#define PGO_HEAP_SIZE       (16 * 1024)     /* __gcov_info_to_gcda scratch */
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+/* Returns 0 when the stream was written, -1 otherwise (or not a PGO_GEN build) */
+int pgo_dump(void);
+
+#endif /* PGO_H */
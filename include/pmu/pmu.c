@@ -0,0 +1,193 @@
+/******************************************************************************
+* File: pmu.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "pmu/pmu.h"
+#include "uart/uart0.h"
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+/* [core][probe]: each core only writes its own rows, no sharing on the
+ * hot path (4 x 9 x 72 bytes). Only pmu_dump() reads across cores.     */
+static pmu_stat_t pmu_stats[PMU_CORES][PMU_PROBE_MAX] __attribute__((aligned(64)));
+
+static const char *const pmu_probe_names[PMU_PROBE_MAX] = {
+    [PMU_PROBE_IRQ]             = "irq",
+    [PMU_PROBE_MAILBOX_SEND]    = "mailbox_send",
+    [PMU_PROBE_MAILBOX_RECV]    = "mailbox_receive",
+    [PMU_PROBE_HMAC_TAG]        = "hmac_tag",
+    [PMU_PROBE_SHA256_COMPRESS] = "sha256_compress",
+    [PMU_PROBE_UART_ISR]        = "uart_isr",
+    [PMU_PROBE_LOG_FLUSH]       = "log_flush",
+    [PMU_PROBE_SELFTEST]        = "selftest",
+    [PMU_PROBE_IRQ_LEAN]        = "irq_lean",
+};
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+static inline uint32_t pmu_core_id(void)
+{
+    uint64_t id;
+    __asm__ volatile("mrs %0, mpidr_el1" : "=r"(id));
+    return (uint32_t)(id & 0xFF);
+}
+
+/* Read cycles + the three event counters as close together as possible */
+static inline void pmu_snapshot(uint64_t *cycles, uint32_t evt[3])
+{
+    uint64_t c, e0, e1, e2;
+    __asm__ volatile(
+        "isb                    \n"
+        "mrs %0, pmccntr_el0    \n"
+        "mrs %1, pmevcntr0_el0  \n"
+        "mrs %2, pmevcntr1_el0  \n"
+        "mrs %3, pmevcntr2_el0  \n"
+        : "=r"(c), "=r"(e0), "=r"(e1), "=r"(e2) :: "memory");
+    *cycles = c;
+    evt[0] = (uint32_t)e0;
+    evt[1] = (uint32_t)e1;
+    evt[2] = (uint32_t)e2;
+}
+
+/******************************************************************************
+* Function: pmu_init
+* Description: Program event counters 0-2 on the calling core and clear its
+*              probe table. Every core calls this once at boot.
+*****************************************************************************/
+void pmu_init(void)
+{
+    uint32_t core = pmu_core_id();
+
+    __asm__ volatile("msr pmevtyper0_el0, %0" :: "r"((uint64_t)PMU_EVT_L1D_CACHE_REFILL));
+    __asm__ volatile("msr pmevtyper1_el0, %0" :: "r"((uint64_t)PMU_EVT_BR_MIS_PRED));
+    __asm__ volatile("msr pmevtyper2_el0, %0" :: "r"((uint64_t)PMU_EVT_INST_RETIRED));
+
+    /* PMCR_EL0: E (enable), P (reset event counters) — C left alone so
+     * PMCCNTR keeps counting for the other users */
+    uint64_t pmcr;
+    __asm__ volatile("mrs %0, pmcr_el0" : "=r"(pmcr));
+    __asm__ volatile("msr pmcr_el0, %0" :: "r"(pmcr | (1u << 0) | (1u << 1)));
+    __asm__ volatile("msr pmcntenset_el0, %0" :: "r"((uint64_t)((1u << 31) | 0x7u)));
+    __asm__ volatile("isb");
+
+    if (core < PMU_CORES) {
+        for (uint32_t i = 0; i < PMU_PROBE_MAX; i++) {
+            pmu_stat_t *st = &pmu_stats[core][i];
+            st->calls = st->cycles = st->max_cycles = 0;
+            st->l1d_refill = st->br_mispred = st->inst = 0;
+        }
+    }
+}
+
+/******************************************************************************
+* Function: pmu_reset
+* Description: Zero the calling core's accumulated probe counts
+*****************************************************************************/
+void pmu_reset(void)
+{
+    uint32_t core = pmu_core_id();
+    if (core >= PMU_CORES) return;
+
+    for (uint32_t i = 0; i < PMU_PROBE_MAX; i++) {
+        pmu_stat_t *st = &pmu_stats[core][i];
+        st->calls = st->cycles = st->max_cycles = 0;
+        st->l1d_refill = st->br_mispred = st->inst = 0;
+    }
+}
+
+/******************************************************************************
+* Function: pmu_probe_begin
+* Description: Open a scope: snapshot the counters into the probe's row
+*****************************************************************************/
+void pmu_probe_begin(uint32_t id)
+{
+    uint32_t core = pmu_core_id();
+    if (id >= PMU_PROBE_MAX || core >= PMU_CORES) return;
+
+    pmu_stat_t *st = &pmu_stats[core][id];
+    pmu_snapshot(&st->start_cycles, st->start_evt);
+}
+
+/******************************************************************************
+* Function: pmu_probe_end
+* Description: Close a scope: accumulate the deltas since pmu_probe_begin.
+*              Event counters are 32-bit; deltas are taken modulo 2^32.
+*****************************************************************************/
+void pmu_probe_end(uint32_t id)
+{
+    uint64_t cycles;
+    uint32_t evt[3];
+
+    pmu_snapshot(&cycles, evt);
+
+    uint32_t core = pmu_core_id();
+    if (id >= PMU_PROBE_MAX || core >= PMU_CORES) return;
+
+    pmu_stat_t *st = &pmu_stats[core][id];
+    uint64_t dc = cycles - st->start_cycles;
+
+    st->calls++;
+    st->cycles     += dc;
+    st->l1d_refill += (uint32_t)(evt[0] - st->start_evt[0]);
+    st->br_mispred += (uint32_t)(evt[1] - st->start_evt[1]);
+    st->inst       += (uint32_t)(evt[2] - st->start_evt[2]);
+    if (dc > st->max_cycles) st->max_cycles = dc;
+}
+
+/******************************************************************************
+* Function: pmu_probe_count
+* Description: Plain event counter — bump the probe's call count only
+*****************************************************************************/
+void pmu_probe_count(uint32_t id)
+{
+    uint32_t core = pmu_core_id();
+    if (id >= PMU_PROBE_MAX || core >= PMU_CORES) return;
+    pmu_stats[core][id].calls++;
+}
+
+/******************************************************************************
+* Function: pmu_probe_stat
+* Description: Read-only view of one row (tests, custom reports)
+*****************************************************************************/
+const pmu_stat_t *pmu_probe_stat(uint32_t core, uint32_t id)
+{
+    if (id >= PMU_PROBE_MAX || core >= PMU_CORES) return 0;
+    return &pmu_stats[core][id];
+}
+
+/******************************************************************************
+* Function: pmu_dump
+* Description: Print every probe that was hit, one line per core:
+*              PMU core=<n> probe=<name> calls= cycles= avg= max= l1d_refill=
+*              br_mispred= inst=
+*              Takes no lock — the caller serialises UART output.
+*****************************************************************************/
+void pmu_dump(void)
+{
+    uart_puts("PMU_BEGIN\n");
+    for (uint32_t core = 0; core < PMU_CORES; core++) {
+        for (uint32_t id = 0; id < PMU_PROBE_MAX; id++) {
+            const pmu_stat_t *st = &pmu_stats[core][id];
+            if (!st->calls || !pmu_probe_names[id]) continue;
+
+            uart_puts("PMU core=");      uart_putdec(core);
+            uart_puts(" probe=");        uart_puts(pmu_probe_names[id]);
+            uart_puts(" calls=");        uart_putdec(st->calls);
+            uart_puts(" cycles=");       uart_putdec(st->cycles);
+            uart_puts(" avg=");          uart_putdec(st->cycles / st->calls);
+            uart_puts(" max=");          uart_putdec(st->max_cycles);
+            uart_puts(" l1d_refill=");   uart_putdec(st->l1d_refill);
+            uart_puts(" br_mispred=");   uart_putdec(st->br_mispred);
+            uart_puts(" inst=");         uart_putdec(st->inst);
+            uart_puts("\n");
+        }
+    }
+    uart_puts("PMU_END\n");
+}
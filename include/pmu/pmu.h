@@ -0,0 +1,103 @@
+/******************************************************************************
+* File: pmu.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: PMU-backed probes for hot-path cost attribution
+*
+* pmu_init() (every core) programs three event counters next to the cycle
+* counter boot.S already started:
+*   PMEVCNTR0  0x03 L1D_CACHE_REFILL
+*   PMEVCNTR1  0x10 BR_MIS_PRED
+*   PMEVCNTR2  0x08 INST_RETIRED
+* (QEMU's PMU model counts cycles and instructions; refills and
+*  mispredicts read 0 there — use the Pi 5 for those.)
+*
+* A probe is a fixed ID below. PMU_PROBE_BEGIN/END bracket a scope and
+* accumulate calls, cycles, max cycles and the three events per probe and
+* per core; PMU_PROBE_COUNT only bumps the call count. The macros compile
+* to nothing unless built with 'make PROBES=1' (-DPMU_PROBES), so the
+* instrumented paths cost nothing in normal builds.
+*
+* The IDs are plain numbers so the .S files can use them too (built through
+* $(CC), and with -DPMU_PROBES in ASFLAGS); src/vector.S brackets the lean
+* IRQ/FIQ handler call that way:
+*   mov x0, #PMU_PROBE_IRQ_LEAN
+*   bl  pmu_probe_begin
+* The full path is measured in irq_dispatch() instead, so it can end
+* before a task switch.
+*
+* A scope must not nest inside itself on the same core; a task preempted
+* inside a scope is charged for the time it was switched out.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef PMU_H
+#define PMU_H
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+/* Probe IDs */
+#define PMU_PROBE_IRQ             0     /* handler only, not the task switch */
+#define PMU_PROBE_MAILBOX_SEND    1
+#define PMU_PROBE_MAILBOX_RECV    2
+#define PMU_PROBE_HMAC_TAG        3
+#define PMU_PROBE_SHA256_COMPRESS 4
+#define PMU_PROBE_UART_ISR        5
+#define PMU_PROBE_LOG_FLUSH       6
+#define PMU_PROBE_SELFTEST        7     /* tests.c only                      */
+#define PMU_PROBE_IRQ_LEAN        8     /* vector.S: lean handler call       */
+#define PMU_PROBE_MAX             9
+
+#define PMU_CORES                 4
+
+/* PMU event numbers (ARMv8 common events) */
+#define PMU_EVT_L1D_CACHE_REFILL  0x03
+#define PMU_EVT_BR_MIS_PRED       0x10
+#define PMU_EVT_INST_RETIRED      0x08
+
+#ifndef __ASSEMBLER__
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stdint.h>
+
+#ifdef PMU_PROBES
+#define PMU_PROBE_BEGIN(id)   pmu_probe_begin(id)
+#define PMU_PROBE_END(id)     pmu_probe_end(id)
+#define PMU_PROBE_COUNT(id)   pmu_probe_count(id)
+#else
+#define PMU_PROBE_BEGIN(id)   ((void)0)
+#define PMU_PROBE_END(id)     ((void)0)
+#define PMU_PROBE_COUNT(id)   ((void)0)
+#endif
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+typedef struct {
+    uint64_t calls;
+    uint64_t cycles;
+    uint64_t max_cycles;
+    uint64_t l1d_refill;
+    uint64_t br_mispred;
+    uint64_t inst;
+    /* snapshot taken by pmu_probe_begin */
+    uint64_t start_cycles;
+    uint32_t start_evt[3];
+    uint32_t reserved;
+} pmu_stat_t;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+void pmu_init(void);
+void pmu_reset(void);
+void pmu_probe_begin(uint32_t id);
+void pmu_probe_end(uint32_t id);
+void pmu_probe_count(uint32_t id);
+const pmu_stat_t *pmu_probe_stat(uint32_t core, uint32_t id);
+void pmu_dump(void);
+
+#endif /* __ASSEMBLER__ */
+#endif /* PMU_H */
@@ -0,0 +1,278 @@
+/******************************************************************************
+* File: prof.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "prof/prof.h"
+#include "interrupts/irq.h"
+#include "semihost/semihost.h"
+#include "uart/uart0.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define CNTV_CTL_ENABLE     (1u << 0)
+#define PROF_HEADER_WORDS   6
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+/* Each core fills only its own buffer, from its own timer IRQ */
+static prof_sample_t     prof_buf[PROF_CORES][PROF_SAMPLES];
+static volatile uint32_t prof_count[PROF_CORES];
+static volatile uint32_t prof_drops[PROF_CORES];
+static volatile uint32_t prof_on[PROF_CORES];
+static uint64_t          prof_period[PROF_CORES];
+static uint32_t          prof_hz;
+
+/* Byte sink for prof_emit(): UART hex lines or a semihosting file */
+typedef int (*prof_sink_t)(const void *buf, uint32_t len, void *ctx);
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+static inline uint32_t prof_core_id(void)
+{
+    uint64_t id;
+    __asm__ volatile("mrs %0, mpidr_el1" : "=r"(id));
+    return (uint32_t)(id & 0xFF);
+}
+
+static inline void prof_arm(uint64_t ticks)
+{
+    __asm__ volatile("msr cntv_tval_el0, %0" :: "r"(ticks));
+    __asm__ volatile("msr cntv_ctl_el0, %0"  :: "r"((uint64_t)CNTV_CTL_ENABLE));
+    __asm__ volatile("isb");
+}
+
+/* A frame record must sit above the last one, inside the same stack */
+static inline int prof_fp_ok(uint64_t fp, uint64_t lo)
+{
+    return fp && !(fp & 0x7) && fp >= lo && fp < lo + PROF_STACK_SPAN;
+}
+
+/******************************************************************************
+* Function: prof_timer_irq
+* Description: INTID 27 handler. Re-arms the virtual timer, then records
+*              PC, LR and the frame-record chain of the interrupted code.
+*              LR is skipped when it equals the first saved return
+*              address (the function had already pushed its frame record).
+*****************************************************************************/
+static void prof_timer_irq(uint32_t irq_id)
+{
+    (void)irq_id;
+    uint32_t core = prof_core_id();
+    if (core >= PROF_CORES || !prof_on[core]) return;
+
+    prof_arm(prof_period[core]);
+
+    exc_frame_t *frame = irq_current_frame();
+    if (!frame) return;
+
+    uint32_t n = prof_count[core];
+    if (n >= PROF_SAMPLES) {
+        prof_drops[core]++;
+        return;
+    }
+
+    prof_sample_t *s = &prof_buf[core][n];
+    uint64_t fp = frame->x[29];
+    uint64_t lo = frame->sp_el1;
+    uint32_t d  = 0;
+
+    s->pc[d++] = frame->elr_el1;
+    if (!prof_fp_ok(fp, lo) || ((uint64_t *)fp)[1] != frame->x[30]) {
+        s->pc[d++] = frame->x[30];          // leaf without a frame record yet
+    }
+
+    while (d < PROF_MAX_DEPTH && prof_fp_ok(fp, lo)) {
+        uint64_t *rec = (uint64_t *)fp;     // rec[0] = caller's x29, rec[1] = x30
+        if (!rec[1]) break;                 // task entry: zeroed initial frame
+        s->pc[d++] = rec[1];
+        lo = fp + 16;
+        fp = rec[0];
+    }
+
+    s->core     = (uint8_t)core;
+    s->depth    = (uint8_t)d;
+    s->reserved = 0;
+    prof_count[core] = n + 1;
+}
+
+/******************************************************************************
+* Function: prof_init
+* Description: Every core back to not sampling, with an empty buffer, like
+*              log_init(). Called once by Core 0 before any core starts
+*              sampling.
+*****************************************************************************/
+void prof_init(void)
+{
+    for (uint32_t c = 0; c < PROF_CORES; c++) {
+        prof_on[c]     = 0;
+        prof_count[c]  = 0;
+        prof_drops[c]  = 0;
+        prof_period[c] = 0;
+    }
+    prof_hz = 0;
+}
+
+/******************************************************************************
+* Function: prof_start
+* Description: Clear the calling core's buffer and start sampling it at
+*              'hz' (0 = PROF_DEFAULT_HZ). The core must take IRQs (DAIF.I
+*              clear) for samples to arrive; cores other than 0 also need
+*              irq_init_cpu() first.
+* Returns: 0 on success, -1 if hz is above PROF_MAX_HZ
+*****************************************************************************/
+int prof_start(uint32_t hz)
+{
+    uint32_t core = prof_core_id();
+    uint64_t freq;
+
+    if (core >= PROF_CORES || hz > PROF_MAX_HZ) return -1;
+    if (hz == 0) hz = PROF_DEFAULT_HZ;
+
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+    prof_period[core] = freq / hz;
+    prof_count[core]  = 0;
+    prof_drops[core]  = 0;
+    prof_hz           = hz;
+
+    irq_register_handler(IRQ_ID_VTIMER, prof_timer_irq);   // PPI: banked enable
+    prof_on[core] = 1;
+    prof_arm(prof_period[core]);
+    return 0;
+}
+
+/******************************************************************************
+* Function: prof_stop
+* Description: Disarm the calling core's sampling timer; samples are kept
+*****************************************************************************/
+void prof_stop(void)
+{
+    uint32_t core = prof_core_id();
+    if (core >= PROF_CORES) return;
+
+    __asm__ volatile("msr cntv_ctl_el0, %0" :: "r"(0UL));
+    __asm__ volatile("isb");
+    prof_on[core] = 0;
+}
+
+/******************************************************************************
+* Function: prof_running
+* Returns: 1 if the calling core is currently being sampled
+*****************************************************************************/
+int prof_running(void)
+{
+    uint32_t core = prof_core_id();
+    return (core < PROF_CORES) ? (int)prof_on[core] : 0;
+}
+
+uint32_t prof_sample_count(uint32_t core)
+{
+    return (core < PROF_CORES) ? prof_count[core] : 0;
+}
+
+uint32_t prof_dropped(uint32_t core)
+{
+    return (core < PROF_CORES) ? prof_drops[core] : 0;
+}
+
+const prof_sample_t *prof_sample(uint32_t core, uint32_t idx)
+{
+    if (core >= PROF_CORES || idx >= prof_count[core]) return 0;
+    return &prof_buf[core][idx];
+}
+
+/******************************************************************************
+* Function: prof_emit
+* Description: Serialise header, every sample and the end marker through
+*              'sink' (format in prof.h)
+* Returns: 0, or the first non-zero sink result
+*****************************************************************************/
+static int prof_emit(prof_sink_t sink, void *ctx)
+{
+    uint32_t hdr[PROF_HEADER_WORDS] = { PROF_MAGIC, prof_hz, PROF_CORES, PROF_MAX_DEPTH, 0, 0 };
+    int rc;
+
+    for (uint32_t c = 0; c < PROF_CORES; c++) {
+        hdr[4] += prof_count[c];
+        hdr[5] += prof_drops[c];
+    }
+    if ((rc = sink(hdr, sizeof(hdr), ctx)) != 0) return rc;
+
+    for (uint32_t c = 0; c < PROF_CORES; c++) {
+        for (uint32_t i = 0; i < prof_count[c]; i++) {
+            const prof_sample_t *s = &prof_buf[c][i];
+            /* core, depth, reserved, then the used part of pc[] */
+            if ((rc = sink(s, 4, ctx)) != 0) return rc;
+            if ((rc = sink(s->pc, s->depth * sizeof(uint64_t), ctx)) != 0) return rc;
+        }
+    }
+
+    const uint8_t end[4] = { PROF_END_CORE, 0, 0, 0 };
+    return sink(end, sizeof(end), ctx);
+}
+
+/* UART sink: each sink call becomes one "PROF <hex>" line */
+static int prof_sink_uart(const void *buf, uint32_t len, void *ctx)
+{
+    static const char hex[] = "0123456789abcdef";
+    const uint8_t *p = (const uint8_t *)buf;
+    uint32_t *pending = (uint32_t *)ctx;    // sample header waits for its pcs
+
+    if (!*pending) uart_puts("PROF ");
+    for (uint32_t i = 0; i < len; i++) {
+        uart_putc(hex[p[i] >> 4]);
+        uart_putc(hex[p[i] & 0xF]);
+    }
+
+    /* a 4-byte sample header is followed by its addresses on the same line */
+    *pending = (len == 4 && p[0] != PROF_END_CORE);
+    if (!*pending) uart_puts("\n");
+    return 0;
+}
+
+static int prof_sink_semihost(const void *buf, uint32_t len, void *ctx)
+{
+    return semihost_write(*(long *)ctx, buf, len) ? -1 : 0;
+}
+
+/******************************************************************************
+* Function: prof_dump_uart
+* Description: Print all samples as hex between PROF_BEGIN and PROF_END.
+*              Takes no lock — the caller serialises UART output.
+*****************************************************************************/
+void prof_dump_uart(void)
+{
+    uint32_t pending = 0;
+
+    uart_puts("PROF_BEGIN\n");
+    prof_emit(prof_sink_uart, &pending);
+    uart_puts("PROF_END\n");
+}
+
+/******************************************************************************
+* Function: prof_dump_semihost
+* Description: Write the raw dump to 'path' on the host
+* Returns: 0 on success, -1 if semihosting is unavailable or a write failed
+*****************************************************************************/
+int prof_dump_semihost(const char *path)
+{
+#if SEMIHOST_AVAILABLE
+    long fd = semihost_open(path, SEMIHOST_MODE_WB);
+    if (fd < 0) return -1;
+
+    int rc = prof_emit(prof_sink_semihost, &fd);
+    semihost_close(fd);
+    return rc;
+#else
+    (void)path;
+    (void)prof_sink_semihost;
+    return -1;
+#endif
+}
@@ -0,0 +1,75 @@
+/******************************************************************************
+* File: prof.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Timer-driven PC sampling profiler
+*
+* prof_start(hz) arms the calling core's virtual timer (CNTV, PPI 27), so
+* it does not touch the physical timer used by the scheduler. Each tick
+* records one sample into that core's buffer. A sample holds the
+* interrupted PC (ELR_EL1 from the exc_frame_t vector.S built), then LR,
+* then the return addresses found by walking the x29 frame-record chain.
+* Every profile builds with -fno-omit-frame-pointer and
+* -mno-omit-leaf-frame-pointer (Makefile), so x29 always points at a frame
+* record, at -O2 and under LTO too. No call site needs editing.
+*
+* When the buffer fills, further ticks only count as dropped.
+* prof_stop() disarms the timer. Cores are started and stopped
+* independently. Only dump once every profiled core has stopped.
+*
+* Dump format: one byte stream, all fields little-endian:
+*   header  "PRF1" u32 hz, u32 cores, u32 max_depth, u32 samples, u32 dropped
+*   sample  u8 core, u8 depth, u16 0, depth x u64 address (leaf first)
+*   end     u8 0xFF, u8 0, u16 0
+* prof_dump_uart() sends it as hex text, one record per line, between
+* PROF_BEGIN / PROF_END. prof_dump_semihost() writes the raw bytes to a
+* host file (SEMIHOST=1 builds). scripts/prof_fold.py reads either form,
+* symbolizes against build/<profile>-<cpu>/kernel.elf and prints folded stacks for
+* flamegraph.pl / speedscope.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef PROF_H
+#define PROF_H
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stdint.h>
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define PROF_CORES          4
+#define PROF_SAMPLES        1024    /* per core                          */
+#define PROF_MAX_DEPTH      12      /* PC + LR + up to 10 frame records  */
+#define PROF_DEFAULT_HZ     2000
+#define PROF_MAX_HZ         20000
+#define PROF_STACK_SPAN     0x10000 /* frame walk stays within 64 KB     */
+#define PROF_MAGIC          0x31465250u     /* "PRF1" */
+#define PROF_END_CORE       0xFF
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+typedef struct {
+    uint8_t  core;
+    uint8_t  depth;
+    uint16_t reserved;
+    uint32_t pad;
+    uint64_t pc[PROF_MAX_DEPTH];
+} prof_sample_t;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+void     prof_init(void);
+int      prof_start(uint32_t hz);
+void     prof_stop(void);
+int      prof_running(void);
+uint32_t prof_sample_count(uint32_t core);
+uint32_t prof_dropped(uint32_t core);
+const prof_sample_t *prof_sample(uint32_t core, uint32_t idx);
+void     prof_dump_uart(void);
+int      prof_dump_semihost(const char *path);
+
+#endif /* PROF_H */
@@ -0,0 +1,186 @@
+/******************************************************************************
+* File: queue.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Typed lock-free record queues for inter-core traffic
+*
+* Three flavours, each generated for a concrete record type and a
+* compile-time capacity (power of two):
+*
+*   QUEUE_SPSC_DECLARE(name, type, cap)  one producer core, one consumer core
+*   QUEUE_MPSC_DECLARE(name, type, cap)  any producer core,  one consumer core
+*   QUEUE_MPMC_DECLARE(name, type, cap)  any producer core,  any consumer core
+*
+* Each expands to a 'name_t' struct plus static inline name_init(),
+* name_push() and name_pop(). push/pop return 0 on success, -1 when the
+* queue is full / empty. Nothing ever blocks or takes a spinlock.
+*
+* The queues hold no pointers and no addresses of their own, so they can
+* live in .bss or in the shared arena (alloc/arena.h):
+*
+*   QUEUE_SPSC_DECLARE(frame_q, modbus_frame_t, 32)
+*   frame_q_t *fq = ARENA_NEW(frame_q_t);
+*
+* SPSC uses free-running head/tail counters on separate cache lines.
+* MPSC/MPMC use per-slot sequence numbers (Vyukov bounded queue): a slot
+* is free for ticket t when seq == t and full when seq == t + 1, so
+* producers only race on one CAS and never on the payload.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include <stdint.h>
+#include "ipc/atomic.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define QUEUE_AT(name, addr)  ((name##_t *)(addr))
+
+#define QUEUE_CHECK_CAPACITY(cap) \
+    _Static_assert((cap) >= 2 && ((cap) & ((cap) - 1)) == 0, \
+                   "queue capacity must be a power of two")
+
+/*************************************************
+ *  SPSC — single producer, single consumer
+ ************************************************/
+#define QUEUE_SPSC_DECLARE(name, type, cap)                                    \
+QUEUE_CHECK_CAPACITY(cap);                                                     \
+typedef struct {                                                               \
+    volatile uint32_t head;           /* producer: next ticket to write */     \
+    uint32_t          tail_cache;     /* producer's last view of tail   */     \
+    uint8_t           pad0[CACHE_LINE_SIZE - 2 * sizeof(uint32_t)];            \
+    volatile uint32_t tail;           /* consumer: next ticket to read  */     \
+    uint32_t          head_cache;     /* consumer's last view of head   */     \
+    uint8_t           pad1[CACHE_LINE_SIZE - 2 * sizeof(uint32_t)];            \
+    type              slots[cap];                                              \
+} __attribute__((aligned(CACHE_LINE_SIZE))) name##_t;                          \
+                                                                               \
+static inline void name##_init(name##_t *q)                                    \
+{                                                                              \
+    q->head = 0; q->tail_cache = 0;                                            \
+    q->tail = 0; q->head_cache = 0;                                            \
+    __asm__ volatile("dmb sy" ::: "memory");                                   \
+}                                                                              \
+                                                                               \
+static inline int name##_push(name##_t *q, const type *item)                   \
+{                                                                              \
+    uint32_t head = q->head;                                                   \
+    if (head - q->tail_cache == (cap)) {                                       \
+        q->tail_cache = atomic_load_acquire32(&q->tail);                       \
+        if (head - q->tail_cache == (cap)) return -1;   /* full  */            \
+    }                                                                          \
+    q->slots[head & ((cap) - 1)] = *item;                                      \
+    atomic_store_release32(&q->head, head + 1);                                \
+    return 0;                                                                  \
+}                                                                              \
+                                                                               \
+static inline int name##_pop(name##_t *q, type *item)                          \
+{                                                                              \
+    uint32_t tail = q->tail;                                                   \
+    if (tail == q->head_cache) {                                               \
+        q->head_cache = atomic_load_acquire32(&q->head);                       \
+        if (tail == q->head_cache) return -1;           /* empty */            \
+    }                                                                          \
+    *item = q->slots[tail & ((cap) - 1)];                                      \
+    atomic_store_release32(&q->tail, tail + 1);                                \
+    return 0;                                                                  \
+}
+
+/*************************************************
+ *  Sequence-numbered slot shared by MPSC / MPMC
+ ************************************************/
+#define QUEUE_SEQ_STRUCT(name, type, cap)                                      \
+QUEUE_CHECK_CAPACITY(cap);                                                     \
+typedef struct {                                                               \
+    volatile uint32_t seq;                                                     \
+    type              data;                                                    \
+} name##_cell_t;                                                               \
+                                                                               \
+typedef struct {                                                               \
+    volatile uint32_t enq_pos;        /* producers CAS this   */               \
+    uint8_t           pad0[CACHE_LINE_SIZE - sizeof(uint32_t)];                \
+    volatile uint32_t deq_pos;        /* consumer(s) own this */               \
+    uint8_t           pad1[CACHE_LINE_SIZE - sizeof(uint32_t)];                \
+    name##_cell_t     cells[cap];                                              \
+} __attribute__((aligned(CACHE_LINE_SIZE))) name##_t;                          \
+                                                                               \
+static inline void name##_init(name##_t *q)                                    \
+{                                                                              \
+    for (uint32_t i = 0; i < (cap); i++) q->cells[i].seq = i;                  \
+    q->enq_pos = 0;                                                            \
+    q->deq_pos = 0;                                                            \
+    __asm__ volatile("dmb sy" ::: "memory");                                   \
+}                                                                              \
+                                                                               \
+static inline int name##_push(name##_t *q, const type *item)                   \
+{                                                                              \
+    name##_cell_t *cell;                                                       \
+    uint32_t pos = q->enq_pos;                                                 \
+    for (;;) {                                                                 \
+        cell = &q->cells[pos & ((cap) - 1)];                                   \
+        int32_t diff = (int32_t)(atomic_load_acquire32(&cell->seq) - pos);     \
+        if (diff == 0) {                                                       \
+            if (atomic_cas32(&q->enq_pos, pos, pos + 1)) break;                \
+            pos = q->enq_pos;             /* another producer won */           \
+        } else if (diff < 0) {                                                 \
+            return -1;                    /* full — slot not yet drained */    \
+        } else {                                                               \
+            pos = q->enq_pos;             /* we were lapped, reload   */       \
+        }                                                                      \
+    }                                                                          \
+    cell->data = *item;                                                        \
+    atomic_store_release32(&cell->seq, pos + 1);                               \
+    return 0;                                                                  \
+}
+
+/*************************************************
+ *  MPSC — multiple producers, single consumer
+ ************************************************/
+#define QUEUE_MPSC_DECLARE(name, type, cap)                                    \
+QUEUE_SEQ_STRUCT(name, type, cap)                                              \
+                                                                               \
+static inline int name##_pop(name##_t *q, type *item)                          \
+{                                                                              \
+    uint32_t pos = q->deq_pos;                                                 \
+    name##_cell_t *cell = &q->cells[pos & ((cap) - 1)];                        \
+    if (atomic_load_acquire32(&cell->seq) != pos + 1) return -1;  /* empty */  \
+    *item = cell->data;                                                        \
+    atomic_store_release32(&cell->seq, pos + (cap));                           \
+    q->deq_pos = pos + 1;                 /* only we write deq_pos */          \
+    return 0;                                                                  \
+}
+
+/*************************************************
+ *  MPMC — multiple producers, multiple consumers
+ ************************************************/
+#define QUEUE_MPMC_DECLARE(name, type, cap)                                    \
+QUEUE_SEQ_STRUCT(name, type, cap)                                              \
+                                                                               \
+static inline int name##_pop(name##_t *q, type *item)                          \
+{                                                                              \
+    name##_cell_t *cell;                                                       \
+    uint32_t pos = q->deq_pos;                                                 \
+    for (;;) {                                                                 \
+        cell = &q->cells[pos & ((cap) - 1)];                                   \
+        int32_t diff = (int32_t)(atomic_load_acquire32(&cell->seq) - (pos + 1)); \
+        if (diff == 0) {                                                       \
+            if (atomic_cas32(&q->deq_pos, pos, pos + 1)) break;                \
+            pos = q->deq_pos;             /* another consumer won */           \
+        } else if (diff < 0) {                                                 \
+            return -1;                    /* empty */                          \
+        } else {                                                               \
+            pos = q->deq_pos;                                                  \
+        }                                                                      \
+    }                                                                          \
+    *item = cell->data;                                                        \
+    atomic_store_release32(&cell->seq, pos + (cap));                           \
+    return 0;                                                                  \
+}
+
+#endif /* QUEUE_H */
@@ -8,11 +8,68 @@
  * INCLUDE FILES
  ***************************************************/
 #include "ringbuf.h"
+#include "alloc/arena.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define RING_MASK (RING_BUFFER_SIZE - 1)
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+volatile ring_buffer_t *uart_rx_ring;
 
 /**************************************************
  * HELPER FUNCTIONS
  ***************************************************/
 
+/******************************************************************************
+* Function: ring_free_space
+* Description: Producer side — free slots after head. Trusts the cached tail
+*              first and only does the LDAR on the consumer's line when the
+*              cached value cannot satisfy 'want'.
+*****************************************************************************/
+static inline unsigned int ring_free_space(volatile ring_buffer_t *rb,
+                                           unsigned int head, unsigned int want)
+{
+    unsigned int free = (rb->tail_cache - head - 1) & RING_MASK;
+
+    if (free < want) {
+        rb->tail_cache = atomic_load_acquire32(&rb->tail);
+        free = (rb->tail_cache - head - 1) & RING_MASK;
+    }
+    return free;
+}
+
+/******************************************************************************
+* Function: ring_used_space
+* Description: Consumer side — bytes available after tail, same caching idea
+*****************************************************************************/
+static inline unsigned int ring_used_space(volatile ring_buffer_t *rb,
+                                           unsigned int tail, unsigned int want)
+{
+    unsigned int used = (rb->head_cache - tail) & RING_MASK;
+
+    if (used < want) {
+        rb->head_cache = atomic_load_acquire32(&rb->head);
+        used = (rb->head_cache - tail) & RING_MASK;
+    }
+    return used;
+}
+
+/******************************************************************************
+* Function: ring_buffer_create
+* Description: Carve an empty ring buffer out of the shared arena
+* Returns: the ring, or 0 if the arena is exhausted
+*****************************************************************************/
+volatile ring_buffer_t *ring_buffer_create(void) {
+    volatile ring_buffer_t *rb = ARENA_NEW(ring_buffer_t);
+
+    if (rb) ring_buffer_init(rb);
+    return rb;
+}
+
 /******************************************************************************
 * Function: ring_buffer_init
 * Description: Initialise the ring buffer by resetting head and tail to zero
@@ -22,6 +79,8 @@
 void ring_buffer_init(volatile ring_buffer_t *rb) {
     rb->head = 0;
     rb->tail = 0;
+    rb->tail_cache = 0;
+    rb->head_cache = 0;
 }
 
 /******************************************************************************
@@ -32,17 +91,14 @@ void ring_buffer_init(volatile ring_buffer_t *rb) {
 * Returns: 0 on success, -1 if buffer is full
 *****************************************************************************/
 int ring_buffer_put(volatile ring_buffer_t *rb, unsigned char c) {
-    // Do not exceed the 255 buffer size : do the 255 & head 
-    // Example : (0x00000000 + 1) & 255 = 1 
-    unsigned int next_head = (rb->head + 1) & (RING_BUFFER_SIZE - 1);
+    volatile unsigned char *span;
 
-    if (next_head == rb->tail) {
+    if (ring_buffer_reserve(rb, &span, 1) == 0) {
         return -1;  // Buffer full — Core 2 is not keeping up
     }
 
-    rb->data[rb->head] = c;
-    __asm__ volatile("dmb sy" ::: "memory");  // Ensure byte written before head moves
-    rb->head = next_head;
+    span[0] = c;
+    ring_buffer_commit(rb, 1);  // STLR: byte visible before head moves
     return 0;
 }
 
@@ -54,12 +110,117 @@ int ring_buffer_put(volatile ring_buffer_t *rb, unsigned char c) {
 * Returns: 0 on success, -1 if buffer is empty
 *****************************************************************************/
 int ring_buffer_get(volatile ring_buffer_t *rb, unsigned char *c) {
-    if (rb->head == rb->tail) {
+    const volatile unsigned char *span;
+
+    if (ring_buffer_peek(rb, &span, 1) == 0) {
         return -1;  // Buffer empty
     }
 
-    __asm__ volatile("dmb sy" ::: "memory");  // Ensure we read current memory state
-    *c = rb->data[rb->tail];
-    rb->tail = (rb->tail + 1) & (RING_BUFFER_SIZE - 1);
+    *c = span[0];
+    ring_buffer_consume(rb, 1);
     return 0;
 }
+
+/******************************************************************************
+* Function: ring_buffer_reserve
+* Description: Producer side of the bulk API. Hands out a pointer to the
+*              largest contiguous free run starting at head (stops at the
+*              wrap point). Nothing is visible to the consumer until
+*              ring_buffer_commit() is called.
+* Parameters: rb   - pointer to ring buffer
+*             span - out: first writable byte
+*             want - number of bytes the caller would like to write
+* Returns: number of bytes that may be written to *span (0 = full)
+*****************************************************************************/
+unsigned int ring_buffer_reserve(volatile ring_buffer_t *rb,
+                                 volatile unsigned char **span, unsigned int want) {
+    unsigned int head   = rb->head;
+    unsigned int free   = ring_free_space(rb, head, want);
+    unsigned int contig = RING_BUFFER_SIZE - head;
+    unsigned int n      = want;
+
+    if (n > free)   n = free;
+    if (n > contig) n = contig;
+
+    *span = &rb->data[head];
+    return n;
+}
+
+/******************************************************************************
+* Function: ring_buffer_commit
+* Description: Publish 'count' bytes previously written through reserve.
+*              A single store-release orders the whole batch.
+*****************************************************************************/
+void ring_buffer_commit(volatile ring_buffer_t *rb, unsigned int count) {
+    atomic_store_release32(&rb->head, (rb->head + count) & RING_MASK);
+}
+
+/******************************************************************************
+* Function: ring_buffer_peek
+* Description: Consumer side of the bulk API. Returns the largest contiguous
+*              run of readable bytes starting at tail without consuming them.
+* Parameters: rb   - pointer to ring buffer
+*             span - out: first readable byte
+*             want - number of bytes the caller would like to read
+* Returns: number of bytes readable from *span (0 = empty)
+*****************************************************************************/
+unsigned int ring_buffer_peek(volatile ring_buffer_t *rb,
+                              const volatile unsigned char **span, unsigned int want) {
+    unsigned int tail   = rb->tail;
+    unsigned int used   = ring_used_space(rb, tail, want);
+    unsigned int contig = RING_BUFFER_SIZE - tail;
+    unsigned int n      = want;
+
+    if (n > used)   n = used;
+    if (n > contig) n = contig;
+
+    *span = &rb->data[tail];
+    return n;
+}
+
+/******************************************************************************
+* Function: ring_buffer_consume
+* Description: Release 'count' bytes obtained through peek back to the producer
+*****************************************************************************/
+void ring_buffer_consume(volatile ring_buffer_t *rb, unsigned int count) {
+    atomic_store_release32(&rb->tail, (rb->tail + count) & RING_MASK);
+}
+
+/******************************************************************************
+* Function: ring_buffer_write
+* Description: Copy up to 'len' bytes in, handling the wrap point internally.
+*              One acquire (only if needed) and one release for the batch.
+* Returns: number of bytes actually written
+*****************************************************************************/
+unsigned int ring_buffer_write(volatile ring_buffer_t *rb,
+                               const unsigned char *src, unsigned int len) {
+    unsigned int head = rb->head;
+    unsigned int free = ring_free_space(rb, head, len);
+    unsigned int n    = (len < free) ? len : free;
+
+    for (unsigned int i = 0; i < n; i++) {
+        rb->data[(head + i) & RING_MASK] = src[i];
+    }
+
+    if (n) atomic_store_release32(&rb->head, (head + n) & RING_MASK);
+    return n;
+}
+
+/******************************************************************************
+* Function: ring_buffer_read
+* Description: Copy up to 'len' bytes out, handling the wrap point internally.
+* Returns: number of bytes actually read
+*****************************************************************************/
+unsigned int ring_buffer_read(volatile ring_buffer_t *rb,
+                              unsigned char *dst, unsigned int len) {
+    unsigned int tail = rb->tail;
+    unsigned int used = ring_used_space(rb, tail, len);
+    unsigned int n    = (len < used) ? len : used;
+
+    for (unsigned int i = 0; i < n; i++) {
+        dst[i] = rb->data[(tail + i) & RING_MASK];
+    }
+
+    if (n) atomic_store_release32(&rb->tail, (tail + n) & RING_MASK);
+    return n;
+}
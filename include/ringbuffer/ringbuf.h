@@ -10,28 +10,51 @@
 #ifndef RINGBUF_H
 #define RINGBUF_H
 
+#include "ipc/atomic.h"
+
 /**************************************************
  * MACRO DEFINTIONS
  ***************************************************/
-#define RING_BUFFER_BASE 0x40220200   // Right after your mailboxes (end at 0x4022015F)
 #define RING_BUFFER_SIZE 256
 
 /**************************************************
  * GLOBAL VARIABLES
  ***************************************************/
+/*
+ * head and tail each own a full cache line so the producer core and the
+ * consumer core never write the same line. Each side also keeps a private
+ * copy of the other side's index and only re-reads the shared one when the
+ * copy says there is no room / no data.
+ * Total size: 2 x 64 + 256 = 384 bytes.
+ */
 typedef struct {
     volatile unsigned int  head;             // Core 1 writes here
+    volatile unsigned int  tail_cache;       // Core 1's last view of tail
+    unsigned char          pad0[CACHE_LINE_SIZE - 2 * sizeof(unsigned int)];
     volatile unsigned int  tail;             // Core 2 reads here
+    volatile unsigned int  head_cache;       // Core 2's last view of head
+    unsigned char          pad1[CACHE_LINE_SIZE - 2 * sizeof(unsigned int)];
     volatile unsigned char data[RING_BUFFER_SIZE];
-} ring_buffer_t;
+} __attribute__((aligned(CACHE_LINE_SIZE))) ring_buffer_t;
 
-#define UART_RX_BUFFER ((volatile ring_buffer_t*)RING_BUFFER_BASE)
+/* Core 1 -> Core 2 test ring and dispatcher RX ring, ring_buffer_create() */
+extern volatile ring_buffer_t *uart_rx_ring;
+#define UART_RX_BUFFER uart_rx_ring
 
 /**************************************************
  * HELPER FUNCTIONS
  ***************************************************/
+volatile ring_buffer_t *ring_buffer_create(void);
 void ring_buffer_init(volatile ring_buffer_t *rb);
 int  ring_buffer_put (volatile ring_buffer_t *rb, unsigned char c);
 int  ring_buffer_get (volatile ring_buffer_t *rb, unsigned char *c);
 
+/* Bulk API — one acquire + one release per batch instead of per byte */
+unsigned int ring_buffer_reserve(volatile ring_buffer_t *rb, volatile unsigned char **span, unsigned int want);
+void         ring_buffer_commit (volatile ring_buffer_t *rb, unsigned int count);
+unsigned int ring_buffer_peek   (volatile ring_buffer_t *rb, const volatile unsigned char **span, unsigned int want);
+void         ring_buffer_consume(volatile ring_buffer_t *rb, unsigned int count);
+unsigned int ring_buffer_write  (volatile ring_buffer_t *rb, const unsigned char *src, unsigned int len);
+unsigned int ring_buffer_read   (volatile ring_buffer_t *rb, unsigned char *dst, unsigned int len);
+
 #endif
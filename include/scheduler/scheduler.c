@@ -1,6 +1,9 @@
 /******************************************************************************
  * File: scheduler.c
- * Description: None
+ * Description: Per-core priority scheduler (O(1) ready bitmaps, optional
+ *              timer preemption, work stealing for migratable tasks,
+ *              tickless idle on one-shot timer deadlines, sleeps on
+ *              the per-core timer wheel)
  * Copyright (c) 2026 Maior Cristian
  ******************************************************************************/
 
@@ -9,18 +12,69 @@
  ***************************************************/
 #include "scheduler/scheduler.h"
 #include "uart/uart0.h"
+#include "queue/queue.h"
 
  /**************************************************
  * MACRO DEFINITIONS
  ***************************************************/
+#define SCHED_NO_DEADLINE   TIMER_NO_DEADLINE   /* next_wake with no timer */
+
+_Static_assert(TIMER_CORES >= CORE_COUNT, "one timer wheel per core");
 
  /**************************************************
  * GLOBAL VARIABLES
  ***************************************************/
 static tcb_t task_pool[CORE_COUNT][MAX_TASKS]; // Maximum amount of tasks per core is undefined for now
+static task_stack_t task_stacks[CORE_COUNT][MAX_TASKS] TASK_STACK_SECTION;
 static uint32_t task_count[CORE_COUNT];
-static uint32_t current_task[CORE_COUNT];
-static volatile uint64_t tick_count[CORE_COUNT]; // ms counter / core
+static tcb_t   *current[CORE_COUNT];               // running task (or idle_tcb)
+static tcb_t    idle_tcb[CORE_COUNT];              // sched_run() context
+static uint64_t tick_period[CORE_COUNT];           // cntpct ticks per ms
+static uint64_t next_wake[CORE_COUNT];             // timer wheel's next deadline
+static volatile uint32_t idle_waiting;             // bit c: core c in WFI
+
+/* Preemption state — each core only touches its own slot */
+static uint8_t  preempt_on[CORE_COUNT];
+static uint8_t  sched_running[CORE_COUNT];
+static volatile uint8_t need_resched[CORE_COUNT];
+static uint64_t quantum[CORE_COUNT];            // cntpct ticks per slice
+static uint64_t slice_end[CORE_COUNT];          // cntpct deadline of the slice
+static uint64_t preemptions[CORE_COUNT];
+
+/*
+ * Ready queues: one FIFO of task indices per priority level, plus a bitmap
+ * with bit N set while level N is non-empty. The running task is never in
+ * a queue. Only touched with IRQs masked on the owning core.
+ */
+_Static_assert((MAX_TASKS & (MAX_TASKS - 1)) == 0, "MAX_TASKS must be a power of two");
+_Static_assert(SCHED_PRIO_LEVELS <= 32, "one ready bit per level");
+
+static uint32_t ready_mask[CORE_COUNT];
+static uint8_t  rq_slot[CORE_COUNT][SCHED_PRIO_LEVELS][MAX_TASKS];
+static uint8_t  rq_head[CORE_COUNT][SCHED_PRIO_LEVELS];
+static uint8_t  rq_count[CORE_COUNT][SCHED_PRIO_LEVELS];
+
+/*
+ * Migratable class: one shared pool, slots claimed with a CAS on mig_used.
+ * wsq[c] holds the pool slots of tasks ready on core c; the owner and the
+ * thieves all dequeue from the head, so the owner round-robins and thieves
+ * take the task that has waited longest. mig_allowed[c] counts live tasks
+ * whose mask includes c, so cores nobody wants never touch a queue.
+ */
+_Static_assert(SCHED_MIG_TASKS <= 32, "one mig_used bit per slot");
+_Static_assert(SCHED_WSQ_DEPTH >= SCHED_MIG_TASKS, "a push must never fail");
+
+QUEUE_MPMC_DECLARE(sched_wsq, uint8_t, SCHED_WSQ_DEPTH)
+
+static tcb_t             mig_pool[SCHED_MIG_TASKS];
+static task_stack_t      mig_stacks[SCHED_MIG_TASKS] TASK_STACK_SECTION;
+static volatile uint32_t mig_used;
+static volatile uint32_t mig_allowed[CORE_COUNT];
+static sched_wsq_t       wsq[CORE_COUNT];
+static tcb_t            *switch_prev[CORE_COUNT];   // see sched_switch_finish
+static uint8_t           mig_turn[CORE_COUNT];      // tie-break at SCHED_MIG_PRIO
+static uint64_t          task_daif[CORE_COUNT];     // DAIF tasks start with
+static uint64_t          steals[CORE_COUNT];
 
  /**************************************************
  * HELPER FUNCTIONS
@@ -33,143 +87,750 @@ static inline uint32_t get_core_id(void)
     return (uint32_t)(id & 0xFF);
 }
 
+static inline uint64_t read_daif(void)
+{
+    uint64_t daif;
+    __asm__ volatile("mrs %0, daif" : "=r"(daif));
+    return daif;
+}
+
+static inline uint64_t read_cntpct(void)
+{
+    uint64_t v;
+    __asm__ volatile("isb; mrs %0, cntpct_el0" : "=r"(v) :: "memory");
+    return v;
+}
+
 /******************************************************************************
- * Function: sched_add_task
- * Description: Registers one task into the scheduler (basically save the state with SP)
- * Parameters: *entry (function) , task description
- * Returns: None
+ * Function: sched_timer_arm
+ * Description: Program this core's EL1 physical timer (INTID 30) for the
+ *              next event only: the timer wheel's, or the end of the
+ *              running task's slice when preemption is on. With neither
+ *              the timer is switched off, so an idle core takes no IRQs.
+ *              IRQs masked.
  *****************************************************************************/
-void sched_add_task(jobContext_t *job)
+static void sched_timer_arm(uint32_t core)
+{
+    uint64_t next = next_wake[core];
+
+    if (preempt_on[core] && current[core] && !(current[core]->flags & TCB_IDLE) &&
+        slice_end[core] < next) {
+        next = slice_end[core];
+    }
+    if (next == SCHED_NO_DEADLINE) {
+        __asm__ volatile("msr cntp_ctl_el0, %0" :: "r"(0UL));
+        return;
+    }
+    __asm__ volatile("msr cntp_cval_el0, %0" :: "r"(next));
+    __asm__ volatile("msr cntp_ctl_el0, %0" :: "r"(1UL));      /* ENABLE */
+}
+
+/* Highest non-empty level — one CLZ regardless of MAX_TASKS */
+static inline uint32_t rq_top(uint32_t core)
 {
+    return 31u - (uint32_t)__builtin_clz(ready_mask[core]);
+}
+
+static void rq_push(uint32_t core, uint32_t idx)
+{
+    uint32_t prio = task_pool[core][idx].priority;
+    uint32_t tail = (rq_head[core][prio] + rq_count[core][prio]) & (MAX_TASKS - 1);
+
+    rq_slot[core][prio][tail] = (uint8_t)idx;
+    rq_count[core][prio]++;
+    ready_mask[core] |= (1u << prio);
+}
+
+static uint32_t rq_pop(uint32_t core, uint32_t prio)
+{
+    uint32_t idx = rq_slot[core][prio][rq_head[core][prio]];
+
+    rq_head[core][prio] = (rq_head[core][prio] + 1) & (MAX_TASKS - 1);
+    if (--rq_count[core][prio] == 0)
+        ready_mask[core] &= ~(1u << prio);
+    return idx;
+}
+
+/* Lock-free hint: does the queue look non-empty? (the pop decides) */
+static inline int wsq_nonempty(sched_wsq_t *q)
+{
+    uint32_t pos = q->deq_pos;
+    return atomic_load_acquire32(&q->cells[pos & (SCHED_WSQ_DEPTH - 1)].seq) == pos + 1;
+}
+
+/* Make a migratable task visible to 'core' and any thief. IRQs masked. */
+static void mig_enqueue(uint32_t core, tcb_t *t)
+{
+    uint8_t slot = t->slot;
+
+    sched_wsq_push(&wsq[core], &slot);
+    __asm__ volatile("dmb ish\n sev" ::: "memory"); /* push before the read */
+
+    /* Cores in WFI only wake for an interrupt (pairs with sched_idle) */
+    uint32_t idle = atomic_load_acquire32(&idle_waiting) & t->affinity &
+                    ~(1u << get_core_id());
+    if (idle) irq_send_sgi(SCHED_WAKE_SGI, idle);
+}
+
+/* Dequeue a task allowed on 'core' from 'victim'. A task masked off for
+ * this core goes back to the tail; give up after one lap of the queue. */
+static tcb_t *mig_take(uint32_t core, uint32_t victim)
+{
+    uint8_t slot;
+
+    for (uint32_t n = 0; n < SCHED_WSQ_DEPTH; n++) {
+        if (sched_wsq_pop(&wsq[victim], &slot) != 0) return 0;
+
+        tcb_t *t = &mig_pool[slot];
+        if (t->affinity & (1u << core)) return t;
+        sched_wsq_push(&wsq[victim], &slot);
+    }
+    return 0;
+}
+
+static int mig_stealable(uint32_t core)
+{
+    if (!atomic_load_acquire32(&mig_allowed[core])) return 0;
+    for (uint32_t v = 0; v < CORE_COUNT; v++) {
+        if (v != core && wsq_nonempty(&wsq[v])) return 1;
+    }
+    return 0;
+}
+
+static tcb_t *mig_steal(uint32_t core)
+{
+    if (!atomic_load_acquire32(&mig_allowed[core])) return 0;
+    for (uint32_t i = 1; i < CORE_COUNT; i++) {
+        tcb_t *t = mig_take(core, (core + i) % CORE_COUNT);
+        if (t) {
+            steals[core]++;
+            return t;
+        }
+    }
+    return 0;
+}
+
+/* The running task cannot go on: only then is it worth stealing */
+static inline int sched_blocked(const tcb_t *t)
+{
+    return t->state != TASK_RUNNING || (t->flags & TCB_IDLE);
+}
+
+/* Highest level with work for 'core', -1 if none */
+static int32_t sched_top(uint32_t core, int blocked)
+{
+    int32_t top = ready_mask[core] ? (int32_t)rq_top(core) : -1;
+
+    if (top < SCHED_MIG_PRIO &&
+        (wsq_nonempty(&wsq[core]) || (blocked && mig_stealable(core)))) {
+        top = SCHED_MIG_PRIO;
+    }
+    return top;
+}
+
+/* Would task_yield() switch away from the running task right now? */
+static inline int sched_should_switch(uint32_t core)
+{
+    tcb_t  *cur = current[core];
+    int32_t top = sched_top(core, sched_blocked(cur));
+
+    if (cur->state == TASK_DEAD) return 1;  /* to idle if nothing else */
+    if (top < 0) return cur->state == TASK_SLEEPING;    /* sleep in idle */
+    if (sched_blocked(cur)) return 1;
+    return top >= (int32_t)cur->priority;   /* equal level = round-robin */
+}
+
+/******************************************************************************
+ * Function: sched_pick
+ * Description: Dequeue the next task for 'core': pinned tasks above
+ *              SCHED_MIG_PRIO first, then this core's steal queue (taking
+ *              turns with pinned tasks at the same level), then, if
+ *              'blocked', another core's queue, then pinned tasks below.
+ * Returns: the task, or 0 if there is nothing (a thief may have won)
+ *****************************************************************************/
+static tcb_t *sched_pick(uint32_t core, int blocked)
+{
+    int32_t top = ready_mask[core] ? (int32_t)rq_top(core) : -1;
+    tcb_t  *t;
+
+    if (top > SCHED_MIG_PRIO || (top == SCHED_MIG_PRIO && (mig_turn[core] ^= 1))) {
+        return &task_pool[core][rq_pop(core, (uint32_t)top)];
+    }
+    if ((t = mig_take(core, core)) != 0) return t;
+    if (blocked && (t = mig_steal(core)) != 0) return t;
+    if (top >= 0) return &task_pool[core][rq_pop(core, (uint32_t)top)];
+    return 0;
+}
+
+/* Return a finished migratable task's slot to the pool */
+static void mig_release(tcb_t *t)
+{
+    uint32_t used;
+
+    for (uint32_t c = 0; c < CORE_COUNT; c++) {
+        if (t->affinity & (1u << c)) atomic_fetch_add32(&mig_allowed[c], (uint32_t)-1);
+    }
+    do {
+        used = atomic_load_acquire32(&mig_used);
+    } while (!atomic_cas32(&mig_used, used, used & ~(1u << t->slot)));
+}
+
+/******************************************************************************
+ * Function: sched_sleep_expired
+ * Description: Callback of a task's sleep_timer, from timer_run() on the
+ *              core the task fell asleep on, IRQs masked. The task goes
+ *              back to its run queue (a migratable one to this core's steal
+ *              queue: it is off its stack, sleeping tasks are never
+ *              published by sched_switch_finish). A task that has not
+ *              switched away yet simply keeps running. Waking a task that
+ *              outranks the running one requests a reschedule.
+ *****************************************************************************/
+static void sched_sleep_expired(sw_timer_t *tm)
+{
+    tcb_t   *t    = TIMER_CONTAINER(tm, tcb_t, sleep_timer);
     uint32_t core = get_core_id();
-    uint32_t idx  = task_count[core];
-    tcb_t *t      = &task_pool[core][idx];
+    tcb_t   *cur  = current[core];
+
+    if (t->state != TASK_SLEEPING) return;
+    if (t == cur) {
+        t->state = TASK_RUNNING;
+        return;
+    }
+
+    t->state = TASK_READY;
+    if (t->flags & TCB_MIGRATABLE) mig_enqueue(core, t);
+    else                           rq_push(core, t->slot);
+    if (cur && t->priority > cur->priority) need_resched[core] = 1;
+}
+
+/* Initial-frame slots popped by sched_context_switch (see sched.S) */
+#define FRAME_SLOT_X30  1
+#define FRAME_SLOT_X19  10
+#define FRAME_SLOT_X20  11
+
+/******************************************************************************
+ * Function: tcb_init
+ * Description: Fill a TCB and build its first frame on 'stack'
+ *****************************************************************************/
+static void tcb_init(tcb_t *t, const jobContext_t *job, uint8_t *stack)
+{
     t->id    = job->id;
+    t->priority = (job->priority < SCHED_PRIO_LEVELS) ? job->priority
+                                                      : SCHED_PRIO_LEVELS - 1;
     t->entry = job->entry;
     t->name  = job->task_name;
     t->state = TASK_READY;
-    t->wake_tick = 0;
+    timer_setup(&t->sleep_timer, sched_sleep_expired);
+    t->irq_frame = 0;
+    t->affinity  = 0;
+    t->flags     = 0;
+    t->stack = stack;
 
     /*
      * Build the initial stack frame that sched_context_switch expects.
      * It saves/restores 6 register pairs (x19-x30) = 12 x uint64_t = 96 bytes.
-     * We pre-fill them as zeroes except x30 = entry address, so the very
-     * first 'ret' in sched_context_switch jumps into entry().
+     * We pre-fill them as zeroes except x30 = sched_task_start, x19 = entry
+     * and x20 = DAIF, so the very first 'ret' in sched_context_switch lands
+     * in the trampoline, which unmasks as needed and calls entry().
      */
     uint64_t *stack_top = (uint64_t *)(t->stack + TASK_STACK_SIZE);
     stack_top -= 12;
     for (int i = 0; i < 12; i++) stack_top[i] = 0;
-    stack_top[1] = (uint64_t)job->entry;   // ← slot 11 = x30
+    stack_top[FRAME_SLOT_X30] = (uint64_t)sched_task_start;
+    stack_top[FRAME_SLOT_X19] = (uint64_t)job->entry;
+    stack_top[FRAME_SLOT_X20] = read_daif();
     t->sp = (uint64_t)stack_top;
+}
 
-    task_count[core]++;
-
+static void sched_log_add(uint32_t core, const jobContext_t *job, const char *what)
+{
     uart_puts("[SCHEDULE] Core ");
     uart_putc('0' + core);
-    uart_puts(": registered '");
+    uart_puts(what);
     uart_puts(job->task_name);
     uart_puts("'\n");
 }
 
+/******************************************************************************
+ * Function: sched_add_migratable
+ * Description: Claim a shared-pool slot and queue the task on the lowest
+ *              core its mask allows. Any core in the mask may steal it.
+ * Returns: 0, or -1 if all SCHED_MIG_TASKS slots are in use
+ *****************************************************************************/
+static int sched_add_migratable(const jobContext_t *job, uint32_t affinity)
+{
+    uint32_t used, slot;
+
+    do {
+        used = atomic_load_acquire32(&mig_used);
+        if (used == (uint32_t)((1ull << SCHED_MIG_TASKS) - 1)) return -1;
+        slot = (uint32_t)__builtin_ctz(~used);
+    } while (!atomic_cas32(&mig_used, used, used | (1u << slot)));
+
+    tcb_t *t = &mig_pool[slot];
+    tcb_init(t, job, mig_stacks[slot].stack);
+    t->priority = SCHED_MIG_PRIO;
+    t->affinity = (uint8_t)affinity;
+    t->slot     = (uint8_t)slot;
+    t->flags    = TCB_MIGRATABLE;
+
+    for (uint32_t c = 0; c < CORE_COUNT; c++) {
+        if (affinity & (1u << c)) atomic_fetch_add32(&mig_allowed[c], 1);
+    }
+
+    uint64_t daif = read_daif();
+    __asm__ volatile("msr daifset, #2" ::: "memory");
+    mig_enqueue((uint32_t)__builtin_ctz(affinity), t);
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+    return 0;
+}
+
+/******************************************************************************
+ * Function: sched_add_task
+ * Description: Registers one task into the scheduler (basically save the state with SP).
+ *              job->affinity 0 pins the task to this core; a non-zero
+ *              mask makes it migratable between the cores it names.
+ * Parameters: *entry (function) , task description
+ * Returns: 0, or -1 if the core's (or the shared) task pool is full
+ *****************************************************************************/
+int sched_add_task(jobContext_t *job)
+{
+    uint32_t core = get_core_id();
+    uint32_t affinity = job->affinity & SCHED_AFFINITY_ALL;
+
+    if (affinity) {
+        if (sched_add_migratable(job, affinity) != 0) return -1;
+        sched_log_add(core, job, ": registered migratable '");
+        return 0;
+    }
+
+    uint32_t idx  = task_count[core];
+    if (idx >= MAX_TASKS) return -1;
+
+    tcb_t *t = &task_pool[core][idx];
+    tcb_init(t, job, task_stacks[core][idx].stack);
+    t->affinity = (uint8_t)(1u << core);
+    t->slot     = (uint8_t)idx;
+
+    uint64_t daif = read_daif();
+    __asm__ volatile("msr daifset, #2" ::: "memory");
+    if (idx == 0) {                 /* first task on this core: reset queues */
+        ready_mask[core] = 0;
+        for (uint32_t p = 0; p < SCHED_PRIO_LEVELS; p++) {
+            rq_head[core][p]  = 0;
+            rq_count[core][p] = 0;
+        }
+    }
+    task_count[core]++;
+    rq_push(core, idx);
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+
+    sched_log_add(core, job, ": registered '");
+    return 0;
+}
+
 
+/******************************************************************************
+ * Function: sched_tick
+ * Description: Run this core's timer wheel up to now (expired sleepers are
+ *              made ready by sched_sleep_expired, other software timers run
+ *              their callbacks), then re-arm the one-shot timer for the
+ *              wheel's next deadline. O(1) per expired timer, independent
+ *              of the number of tasks. Runs from the timer IRQ and from
+ *              task_yield(), IRQs masked.
+ *****************************************************************************/
 void sched_tick(void)
 {
     uint32_t core = get_core_id();
-    tick_count[core]++;
 
-    for (uint32_t i = 0; i < task_count[core]; i++) {
-        tcb_t *t = &task_pool[core][i];
-        if (t->state == TASK_SLEEPING && tick_count[core] >= t->wake_tick)
-            t->state = TASK_READY;
+    timer_run(read_cntpct());
+    next_wake[core] = timer_next_deadline();
+    sched_timer_arm(core);
+}
+
+/* timer_arm() hook: a timer armed outside timer_run() may come first */
+static void sched_timer_notify(uint64_t deadline)
+{
+    uint32_t core = get_core_id();
+
+    next_wake[core] = deadline;
+    if (sched_running[core]) sched_timer_arm(core);
+}
+
+/******************************************************************************
+ * Function: sched_timer_irq
+ * Description: INTID 30 handler, every core in sched_run(). The timer is
+ *              one-shot: it fires at a sleeper's deadline or at the end of
+ *              the running task's slice. An expired slice asks for a
+ *              reschedule and starts the next one (so the deadline never
+ *              stays in the past), then due sleepers wake and the timer is
+ *              re-armed for whatever comes next. Masks IRQs itself: a
+ *              higher-priority handler may call sched_wake().
+ *****************************************************************************/
+static void sched_timer_irq(uint32_t irq_id)
+{
+    (void)irq_id;
+    uint64_t daif = read_daif();
+    __asm__ volatile("msr daifset, #2" ::: "memory");
+
+    uint32_t core = get_core_id();
+    uint64_t now  = read_cntpct();
+
+    if (preempt_on[core] && !(current[core]->flags & TCB_IDLE) &&
+        now >= slice_end[core]) {
+        need_resched[core] = 1;
+        slice_end[core]    = now + quantum[core];
     }
+    sched_tick();
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+}
+
+/* SCHED_WAKE_SGI: nothing to do, taking it is what ends the WFI */
+static void sched_wake_sgi(uint32_t irq_id)
+{
+    (void)irq_id;
 }
 
 /******************************************************************************
- * Function: pick_next
- * Description: Return the first task which occurs to be ready to be executed
- * Parameters: core
- * Returns: task
+ * Function: sched_preempt_enable
+ * Description: Turn on time slicing for the calling core. Takes effect in
+ *              sched_run(), which unmasks IRQs for the tasks; every switch
+ *              then arms the timer for the end of the new task's slice.
+ * Parameters: quantum_ms - slice length in ms (0 = SCHED_QUANTUM_MS)
  *****************************************************************************/
-static uint32_t pick_next(uint32_t core)
+void sched_preempt_enable(uint32_t quantum_ms)
 {
-    uint32_t count = task_count[core];
-    uint32_t cur   = current_task[core];
+    uint32_t core = get_core_id();
+    uint64_t freq;
+
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
 
-    for (uint32_t i = 1; i <= count; i++) {
-        uint32_t candidate = (cur + i) % count;
-        if (task_pool[core][candidate].state == TASK_READY)
-            return candidate;
+    tick_period[core] = freq / SCHED_TICK_HZ;
+    quantum[core]     = (uint64_t)(quantum_ms ? quantum_ms : SCHED_QUANTUM_MS) *
+                        tick_period[core];
+    need_resched[core] = 0;
+    preemptions[core] = 0;
+    preempt_on[core]  = 1;
+}
+
+/******************************************************************************
+ * Function: sched_irq_exit
+ * Description: Called by common_trap_handler after EOI. If the tick asked
+ *              for it, switch tasks right here, still inside the exception:
+ *              the preempted task's frame stays on its stack and it resumes
+ *              through restore_regs/ERET when it is picked again.
+ * Parameters: frame - exception frame of the interrupted task
+ *****************************************************************************/
+void sched_irq_exit(exc_frame_t *frame)
+{
+    uint32_t core = get_core_id();
+
+    if (!sched_running[core] || !need_resched[core]) return;
+
+    need_resched[core] = 0;
+    slice_end[core]    = read_cntpct() + quantum[core];
+
+    tcb_t *t = current[core];
+    if (!sched_should_switch(core)) {         /* nothing of equal/higher prio */
+        sched_timer_arm(core);                /* the new slice */
+        return;
     }
-    return cur;   /* nobody else ready — stay on current */
+
+    preemptions[core]++;
+    t->irq_frame = frame;
+    task_yield();
+    t->irq_frame = 0;                   /* running again */
+}
+
+/******************************************************************************
+ * Function: sched_preempt_count
+ * Description: Number of tick-driven switches on 'core' since enable
+ *****************************************************************************/
+uint64_t sched_preempt_count(uint32_t core)
+{
+    return (core < CORE_COUNT) ? preemptions[core] : 0;
+}
+
+/******************************************************************************
+ * Function: sched_steal_count
+ * Description: Number of migratable tasks 'core' took from another core
+ *****************************************************************************/
+uint64_t sched_steal_count(uint32_t core)
+{
+    return (core < CORE_COUNT) ? steals[core] : 0;
+}
+
+/******************************************************************************
+ * Function: sched_mig_live
+ * Description: Migratable tasks registered and not yet released. A task
+ *              that exited is released by the next switch on its core.
+ *****************************************************************************/
+uint32_t sched_mig_live(void)
+{
+    return (uint32_t)__builtin_popcount(atomic_load_acquire32(&mig_used));
+}
+
+/******************************************************************************
+ * Function: sched_switch_finish
+ * Description: Runs on the core that just switched, on the new task's
+ *              stack (end of task_yield, or sched_task_start for a fresh
+ *              task), IRQs masked. Only now is the previous migratable
+ *              task's SP saved and its stack unused, so only now may it be
+ *              queued where a thief can see it, or its slot be reused.
+ *****************************************************************************/
+void sched_switch_finish(void)
+{
+    uint32_t core = get_core_id();
+    tcb_t   *prev = switch_prev[core];
+
+    if (!prev) return;
+    switch_prev[core] = 0;
+
+    if (prev->state == TASK_DEAD) mig_release(prev);
+    else                          mig_enqueue(core, prev);
 }
 
 /******************************************************************************
  * Function: task_yield
- * Description: Pick the next task when and switch contexts (SP switch)
+ * Description: Give the core to the highest-priority ready task. The caller
+ *              goes to the tail of its level's FIFO, so equal priorities
+ *              round-robin; if every ready task is of lower priority the
+ *              caller simply keeps running. O(1): one CLZ + one dequeue.
  * Parameters: 
  * Returns: None
  *****************************************************************************/
 void task_yield(void)
 {
+    /* The tick may preempt us: pick + switch must not be interrupted. Each
+     * task gets its own DAIF back from 'daif' when it is resumed here. */
+    uint64_t daif    = read_daif();
+    __asm__ volatile("msr daifset, #2" ::: "memory");
+
     uint32_t core    = get_core_id();
-    uint32_t old_idx = current_task[core];
-    uint32_t new_idx = pick_next(core);
+    tcb_t   *old_tcb = current[core];
+
+    /* Cooperative cores run tasks masked: wake due sleepers here too */
+    if (read_cntpct() >= next_wake[core]) sched_tick();
 
-    if (old_idx == new_idx) return;   /* only one ready task — nothing to do */
+    int      blocked = sched_blocked(old_tcb);
 
-    tcb_t *old_tcb = &task_pool[core][old_idx];
-    tcb_t *new_tcb = &task_pool[core][new_idx];
+    if (!sched_should_switch(core)) {
+        /* Nothing else ready; a sleeper always switches (to idle) */
+        old_tcb->state = TASK_RUNNING;
+        __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+        return;
+    }
+
+    /* keep TASK_SLEEPING / TASK_DEAD as is; migratable tasks are queued
+     * by sched_switch_finish, once we are off their stack */
+    if (old_tcb->state == TASK_RUNNING && !(old_tcb->flags & TCB_IDLE)) {
+        old_tcb->state = TASK_READY;
+        if (!(old_tcb->flags & TCB_MIGRATABLE)) rq_push(core, old_tcb->slot);
+    }
+
+    tcb_t *new_tcb = sched_pick(core, blocked);
+    if (!new_tcb) {                           /* a thief got there first */
+        new_tcb = (old_tcb->state == TASK_DEAD || old_tcb->state == TASK_SLEEPING)
+                ? &idle_tcb[core] : old_tcb;
+    }
+
+    if (new_tcb == old_tcb) {
+        old_tcb->state = TASK_RUNNING;
+        __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+        return;
+    }
+
+    if ((new_tcb->flags & (TCB_MIGRATABLE | TCB_STARTED)) == TCB_MIGRATABLE) {
+        /* First run: start with this core's task DAIF (see sched_run) */
+        ((uint64_t *)new_tcb->sp)[FRAME_SLOT_X20] = task_daif[core];
+        new_tcb->flags |= TCB_STARTED;
+    }
+    /* a sleeping migratable task is queued again by its sleep_timer */
+    if ((old_tcb->flags & TCB_MIGRATABLE) && old_tcb->state != TASK_SLEEPING) {
+        switch_prev[core] = old_tcb;
+    }
 
-    old_tcb->state     = TASK_READY;
     new_tcb->state     = TASK_RUNNING;
-    current_task[core] = new_idx;
+    current[core]      = new_tcb;
+    slice_end[core]    = read_cntpct() + quantum[core];
+    sched_timer_arm(core);
 
     sched_context_switch(old_tcb, new_tcb);
+    sched_switch_finish();                    /* may be another core now */
+
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
 }
 
 
+/******************************************************************************
+ * Function: task_sleep_ms
+ * Description: Block the calling task for 'ms' milliseconds on its
+ *              sleep_timer, rounded up to the wheel's 100 us jiffy. Arming
+ *              it re-arms the one-shot timer if it is now the earliest
+ *              deadline (sched_timer_notify). With nothing else to run the
+ *              core waits in WFI (sched_idle).
+ *****************************************************************************/
 void task_sleep_ms(uint32_t ms)
 {
+    /* Masked so the tick cannot move us to another core in between */
+    uint64_t daif = read_daif();
+    __asm__ volatile("msr daifset, #2" ::: "memory");
+
     uint32_t core = get_core_id();
-    uint32_t current_task_core = current_task[core];
-    tcb_t   *t    = &task_pool[core][current_task_core];
+    tcb_t   *t    = current[core];
 
-    t->state     = TASK_SLEEPING;
-    t->wake_tick = tick_count[core] + (uint64_t)ms;
+    if (t->flags & TCB_WAKEUP) {            /* woken before we got here */
+        t->flags &= (uint8_t)~TCB_WAKEUP;
+        __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+        return;
+    }
+
+    t->state = TASK_SLEEPING;
+    timer_arm(&t->sleep_timer, (uint64_t)ms * 1000u, 0);
     task_yield();
     /* returns here ~ms milliseconds later */
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+}
+
+/******************************************************************************
+ * Function: sched_wake
+ * Description: End a sleep early, e.g. from the IRQ handler of the device
+ *              the task waits on: cancel its sleep_timer and make it ready.
+ *              Same core as the sleeping task (the wheel is per-core); from
+ *              another core the call has no effect. A task that is awake
+ *              (e.g. between finding nothing to do and going to sleep)
+ *              keeps the wake-up for its next sleep.
+ *****************************************************************************/
+void sched_wake(tcb_t *t)
+{
+    uint64_t daif = read_daif();
+    __asm__ volatile("msr daifset, #2" ::: "memory");
+
+    uint32_t core = get_core_id();
+
+    if (t && t->state == TASK_SLEEPING && t != current[core]) {
+        if (timer_cancel(&t->sleep_timer) >= 0) {
+            sched_sleep_expired(&t->sleep_timer);
+            next_wake[core] = timer_next_deadline();
+            sched_timer_arm(core);
+        }
+    } else if (t && t->state != TASK_DEAD) {
+        t->flags |= TCB_WAKEUP;
+    }
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
 }
 
+/******************************************************************************
+ * Function: sched_self
+ * Description: The calling task's TCB (the idle context outside tasks)
+ *****************************************************************************/
+tcb_t *sched_self(void)
+{
+    return current[get_core_id()];
+}
+
+/******************************************************************************
+ * Function: task_exit
+ * Description: Finish the calling task; it is never picked again. A
+ *              migratable task's pool slot is freed once its core has
+ *              switched away. Also reached when a task's entry returns.
+ * Returns: never
+ *****************************************************************************/
+void task_exit(void)
+{
+    __asm__ volatile("msr daifset, #2" ::: "memory");
+    current[get_core_id()]->state = TASK_DEAD;
+    task_yield();
+    for (;;) { __asm__ volatile("wfe"); }
+}
+
+
+/******************************************************************************
+ * Function: sched_idle
+ * Description: The per-core idle context: sched_run's own stack. Runs
+ *              whatever becomes runnable here, steals when allowed, and in
+ *              between waits in WFI with the timer armed for the earliest
+ *              sleeper (or off). WFI ends on a pending interrupt even while
+ *              masked, so the check-then-sleep below cannot lose a wake-up:
+ *              a timer that fires after the check is still pending, and a
+ *              core queueing a migratable task for us sees our
+ *              idle_waiting bit and sends SCHED_WAKE_SGI. The interrupt is
+ *              then taken in the short unmasked window.
+ *****************************************************************************/
+static void sched_idle(void)
+{
+    uint32_t core = get_core_id();          /* the idle context never moves */
+
+    for (;;) {
+        __asm__ volatile("msr daifset, #2" ::: "memory");
+        task_yield();                       /* run whatever is ready */
+
+        atomic_fetch_add32(&idle_waiting, 1u << core);
+        __asm__ volatile("dmb ish" ::: "memory");      /* bit before the check */
+        if (!sched_should_switch(core)) {
+            sched_timer_arm(core);
+            __asm__ volatile("wfi" ::: "memory");
+        }
+        atomic_fetch_add32(&idle_waiting, (uint32_t)-(1u << core));
+
+        __asm__ volatile("msr daifclr, #2\n isb\n msr daifset, #2" ::: "memory");
+    }
+}
 
 /******************************************************************************
  * Function: sched_run
- * Description: Enter first function from the scheduler on X core
+ * Description: Enter first function from the scheduler on X core. The
+ *              caller's context becomes this core's idle context, so a core
+ *              without pinned tasks still runs (steals) migratable ones.
  * Parameters: None
  * Returns: None
  *****************************************************************************/
 void sched_run(void)
 {
     uint32_t core = get_core_id();
+    tcb_t   *idle = &idle_tcb[core];
 
+    uart_puts("[SCHEDULE] Core ");
+    uart_putc('0' + core);
     if (task_count[core] == 0) {
-        uart_puts("[SCHED] Core ");
-        uart_putc('0' + core);
-        uart_puts(": no tasks - wait for event\n");
-        while (1) { __asm__ volatile("wfe"); }
+        uart_puts(": no pinned tasks - idle, stealing\n");
+    } else {
+        uart_puts(": starting ");
+        uart_putc('0' + task_count[core]);
+        uart_puts(" task(s)\n");
     }
 
-    uart_puts("[SCHEDULE] Core ");
-    uart_putc('0' + core);
-    uart_puts(": starting ");
-    uart_putc('0' + task_count[core]);
-    uart_puts(" task(s)\n");
+    /* Stay masked until the first task's trampoline installs its DAIF */
+    uint64_t daif = read_daif();
+    uint64_t freq;
+    __asm__ volatile("msr daifset, #2" ::: "memory");
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
 
-    current_task[core] = 0;
-    task_pool[core][0].state = TASK_RUNNING;
+    /* One-shot timer on every core, armed at each switch (sched_timer_arm) */
+    tick_period[core] = freq / SCHED_TICK_HZ;
+    next_wake[core]   = SCHED_NO_DEADLINE;
+    timer_init();                                   /* this core's wheel */
+    timer_set_notify(sched_timer_notify);
+    irq_init_cpu();                                 /* banked GICC + PPIs */
+    irq_register_handler(IRQ_ID_TIMER, sched_timer_irq);
+    irq_register_handler(SCHED_WAKE_SGI, sched_wake_sgi);
+
+    if (preempt_on[core]) {
+        daif &= ~(1UL << 7);                            /* tasks run with IRQs on */
+    }
+
+    /* Tasks added before this point snapshotted the boot-time DAIF */
+    for (uint32_t i = 0; i < task_count[core]; i++) {
+        ((uint64_t *)task_pool[core][i].sp)[FRAME_SLOT_X20] = daif;
+    }
+    task_daif[core] = daif;
 
-    //Using a boot temp as entry to make the switch 
-    static tcb_t boot_temp[CORE_COUNT];
-    sched_context_switch(&boot_temp[core], &task_pool[core][0]);
+    idle->name     = "idle";
+    idle->priority = TASK_PRIO_IDLE;
+    idle->flags    = TCB_IDLE;
+    idle->state    = TASK_RUNNING;
+    current[core]  = idle;
+    sched_running[core] = 1;
 
-    while (1) { __asm__ volatile("wfe"); }
+    sched_idle();                           /* first yield picks the top task */
 }
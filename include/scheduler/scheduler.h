@@ -2,11 +2,46 @@
  * File: sched.h
  * Project: RPi5-Industrial-Gateway Bare Metal Development
  *
- * Cooperative round-robin task scheduler for AArch64 bare metal.
+ * Priority task scheduler for AArch64 bare metal.
  * Each core maintains its own independent task list.
+ * Each priority level has a FIFO run queue and a bit in a per-core ready
+ * bitmap; the next task is the head of the highest set bit (one CLZ), so
+ * yield cost does not depend on MAX_TASKS. Equal priorities round-robin.
+ * Lower-priority tasks only run while every higher one sleeps, so
+ * polling tasks should task_sleep_ms() when idle.
  * Tasks call task_yield() to give up the CPU voluntarily.
- * task_sleep_ms() suspends a task for N milliseconds using the
- * ARM generic timer tick driven by sched_tick().
+ * task_sleep_ms() suspends a task on a timer of its core's timer wheel
+ * (timer/timer_wheel.h), so sleeps cost O(1) however many tasks and
+ * software timers the core has.
+ *
+ * Tickless: there is no periodic tick. The EL1 physical timer (INTID 30)
+ * is one-shot, armed at every switch for the next event only: the wheel's
+ * next deadline (a sleeper or any other software timer), or the end of the
+ * running task's slice when preemption is on. When nothing can run, the
+ * per-core idle context (sched_run's stack) waits in WFI with the timer
+ * armed for the earliest sleeper, or off. Any interrupt ends the WFI; a
+ * device handler can end a sleep early with sched_wake(), and a core
+ * queueing a migratable task wakes idle cores that may run it with
+ * SCHED_WAKE_SGI.
+ *
+ * Optional preemption: sched_preempt_enable(quantum_ms) before sched_run()
+ * unmasks IRQs for that core's tasks. When a task has used its quantum,
+ * or a sleeping task wakes, the IRQ exit path (sched_irq_exit, called
+ * after EOI) switches tasks. The preempted task's exc_frame_t stays on its
+ * own stack and is restored by the normal restore_regs/ERET once the task
+ * is picked again. A task that wakes therefore waits one IRQ exit,
+ * regardless of what the running task is doing. Without preemption tasks
+ * run masked and due sleepers wake at the next task_yield().
+ *
+ * Work stealing (opt-in): a job with a non-zero affinity mask is
+ * migratable. Migratable tasks come from a shared pool and run at
+ * SCHED_MIG_PRIO. Each core keeps its ready migratable tasks in a
+ * lock-free work-stealing queue (queue.h MPMC). The owner takes from it
+ * like any run queue. A core whose running task cannot continue (sleeping,
+ * dead, or the per-core idle context) steals from the other cores' queues,
+ * but only tasks whose mask includes it. A task is published to a queue
+ * only after the core has switched off its stack (sched_switch_finish).
+ * Pinned tasks (affinity 0, the default) never leave their core.
  *
  * Copyright (c) 2026 Maior Cristian
  ******************************************************************************/
@@ -19,13 +54,32 @@
  ***************************************************/
 #include <stdint.h>
 #include "dispatcher.h"
+#include "interrupts/irq.h"
+#include "mmu/pagetable.h"
+#include "timer/timer_wheel.h"
 
 /**************************************************
  * MACRO DEFINTIONS
  ***************************************************/
 #define MAX_TASKS        8      /* max tasks per core                        */
-#define TASK_STACK_SIZE  2048   /* 2 KB private stack per task               */
+#define TASK_STACK_SIZE  4096   /* one page of private stack per task        */
 #define CORE_COUNT       4      /* BCM2712 quad-core                         */
+#define SCHED_TICK_HZ    1000   /* time unit of sleeps and quanta: 1 ms      */
+#define SCHED_PRIO_LEVELS 8     /* 0 = lowest … 7 = highest (TASK_PRIO_*)    */
+#ifndef SCHED_QUANTUM_MS
+#define SCHED_QUANTUM_MS 10     /* default time slice                        */
+#endif
+#define SCHED_MIG_TASKS  16     /* migratable tasks alive at once (<= 32)    */
+#define SCHED_WSQ_DEPTH  16     /* per-core steal queue, >= SCHED_MIG_TASKS  */
+#define SCHED_MIG_PRIO   TASK_PRIO_LOW  /* level of the migratable class     */
+#define SCHED_AFFINITY_ALL ((1u << CORE_COUNT) - 1)
+#define SCHED_WAKE_SGI   15u    /* SGI 15: wakes an idle core for a new task */
+
+/* tcb_t.flags */
+#define TCB_MIGRATABLE   0x1    /* lives in the shared pool, may move cores  */
+#define TCB_IDLE         0x2    /* per-core idle context (sched_run caller)  */
+#define TCB_STARTED      0x4    /* migratable: initial frame already used    */
+#define TCB_WAKEUP       0x8    /* sched_wake() while awake: skip next sleep */
 
 /*************************************************
  *  TYPEDEF STRUCTS UNIONS ENUMS
@@ -33,25 +87,55 @@
 typedef enum {
     TASK_READY    = 0,   /* runnable, waiting for its turn                  */
     TASK_RUNNING  = 1,   /* currently executing on this core                */
-    TASK_SLEEPING = 2,   /* blocked until wake_tick is reached              */
+    TASK_SLEEPING = 2,   /* blocked until sleep_timer fires                 */
     TASK_DEAD     = 3    /* finished (future use)                           */
 } task_state_t;
 
+/*
+ * Task stacks live in the linker's .task_stacks region, one slot per task:
+ * the guard page below the stack is left unmapped by mmu_build_tables(),
+ * so an overflow takes a data abort instead of corrupting the neighbour.
+ */
+typedef struct {
+    uint8_t guard[MMU_PAGE_SIZE];         /* unmapped                       */
+    uint8_t stack[TASK_STACK_SIZE];       /* grows downward from the top    */
+} __attribute__((aligned(MMU_PAGE_SIZE))) task_stack_t;
+
+_Static_assert(sizeof(task_stack_t) == MMU_TASK_STACK_SLOT,
+               "task_stack_t must match the slot mmu_build_tables() guards");
+
+#define TASK_STACK_SECTION  __attribute__((section(".bss.task_stacks")))
+
 typedef struct {
     uint64_t      sp;                     /* saved SP */
     uint16_t      id;                       /* the task ID for dispatcher */
-    uint8_t       stack[TASK_STACK_SIZE]; /* private stack, grows downward  */
+    uint8_t       priority;               /* 0..SCHED_PRIO_LEVELS-1         */
+    uint8_t       affinity;               /* cores it may run on (migratable) */
+    uint8_t       slot;                   /* index in its core's / shared pool */
+    uint8_t       flags;                  /* TCB_*                          */
+    uint8_t      *stack;                  /* task_stack_t.stack, TASK_STACK_SIZE */
     task_state_t  state;
-    uint64_t      wake_tick;              /* wake when tick_count >= this   */
+    sw_timer_t    sleep_timer;            /* ends task_sleep_ms()           */
     void        (*entry)(void);           /* task entry function            */
     const char   *name;                   /* debug label                    */
+    exc_frame_t  *irq_frame;              /* frame on our stack if preempted */
 } tcb_t;
 
-void sched_add_task(jobContext_t *job);
+int  sched_add_task(jobContext_t *job);
 void sched_run(void);
 void task_yield(void);
 void task_sleep_ms(uint32_t ms);
+void task_exit(void);
+void sched_wake(tcb_t *t);
+tcb_t *sched_self(void);
+void sched_switch_finish(void);
 void sched_tick(void);
+void sched_preempt_enable(uint32_t quantum_ms);
+void sched_irq_exit(exc_frame_t *frame);
+uint64_t sched_preempt_count(uint32_t core);
+uint64_t sched_steal_count(uint32_t core);
+uint32_t sched_mig_live(void);
 extern void sched_context_switch(tcb_t *old_tcb, tcb_t *new_tcb);
+extern void sched_task_start(void);
 
 #endif /* SCHED_H */
@@ -0,0 +1,68 @@
+/******************************************************************************
+* File: semihost.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "semihost/semihost.h"
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+/******************************************************************************
+* Function: semihost_call
+* Description: Trap to the host: w0 = operation, x1 = parameter block.
+*              The debugger / QEMU writes the result back into x0.
+*****************************************************************************/
+static long semihost_call(uint32_t op, const uint64_t *args)
+{
+    register uint64_t x0 __asm__("x0") = op;
+    register const uint64_t *x1 __asm__("x1") = args;
+
+    __asm__ volatile("hlt #0xf000" : "+r"(x0) : "r"(x1) : "memory");
+    return (long)x0;
+}
+
+static uint64_t semihost_strlen(const char *s)
+{
+    uint64_t n = 0;
+    while (s[n]) n++;
+    return n;
+}
+
+/******************************************************************************
+* Function: semihost_open
+* Description: Open 'path' on the host (relative to QEMU's working dir)
+* Returns: host file handle, or -1 on error
+*****************************************************************************/
+long semihost_open(const char *path, uint32_t mode)
+{
+    uint64_t args[3] = { (uint64_t)path, mode, semihost_strlen(path) };
+    return semihost_call(SYS_OPEN, args);
+}
+
+/******************************************************************************
+* Function: semihost_write
+* Description: Write 'len' bytes to an open host file
+* Returns: 0 when everything was written, else the number of bytes NOT
+*          written (semihosting convention)
+*****************************************************************************/
+long semihost_write(long fd, const void *buf, uint64_t len)
+{
+    uint64_t args[3] = { (uint64_t)fd, (uint64_t)buf, len };
+    return semihost_call(SYS_WRITE, args);
+}
+
+/******************************************************************************
+* Function: semihost_close
+* Returns: 0 on success, -1 on error
+*****************************************************************************/
+long semihost_close(long fd)
+{
+    uint64_t args[1] = { (uint64_t)fd };
+    return semihost_call(SYS_CLOSE, args);
+}
@@ -0,0 +1,48 @@
+/******************************************************************************
+* File: semihost.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Minimal ARM semihosting (AArch64 HLT #0xF000) file output
+*
+* Lets the firmware write raw files on the host when QEMU runs with
+* '-semihosting-config enable=on,target=native'. Without a debugger or
+* that option the HLT traps as an undefined instruction, so callers must
+* only use it when SEMIHOST_AVAILABLE is set: QEMU builds made with
+* 'make SEMIHOST=1' (-DSEMIHOSTING), which also adds the QEMU option.
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef SEMIHOST_H
+#define SEMIHOST_H
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stdint.h>
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#if defined(TARGET_QEMU) && defined(SEMIHOSTING)
+#define SEMIHOST_AVAILABLE  1
+#else
+#define SEMIHOST_AVAILABLE  0
+#endif
+
+/* Operation numbers (ARM semihosting spec v2) */
+#define SYS_OPEN            0x01
+#define SYS_CLOSE           0x02
+#define SYS_WRITE           0x05
+
+/* SYS_OPEN modes (fopen() strings in spec order) */
+#define SEMIHOST_MODE_RB    1
+#define SEMIHOST_MODE_WB    5
+#define SEMIHOST_MODE_AB    9
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+long semihost_open(const char *path, uint32_t mode);
+long semihost_write(long fd, const void *buf, uint64_t len);
+long semihost_close(long fd);
+
+#endif /* SEMIHOST_H */
@@ -0,0 +1,395 @@
+/******************************************************************************
+* File: timer_wheel.c
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Hierarchical timer wheel, see timer_wheel.h
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "timer/timer_wheel.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define TIMER_SLOT_MASK     (TIMER_SLOTS - 1)
+#define TIMER_SPAN          (1ull << (TIMER_LEVEL_BITS * TIMER_LEVELS))
+#define TIMER_US_PER_JIFFY  (1000000u / TIMER_WHEEL_HZ)
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+typedef struct {
+    timer_link_t slot[TIMER_LEVELS][TIMER_SLOTS];   /* list heads          */
+    uint64_t     occupied[TIMER_LEVELS];            /* bit s: slot s used  */
+    uint64_t     now;               /* next jiffy to process               */
+    uint8_t      ready;
+    uint8_t      running;           /* inside timer_run()                  */
+    timer_stats_t st;
+} timer_wheel_t;
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+static timer_wheel_t  wheels[TIMER_CORES];
+static uint64_t       timer_freq;           /* cntfrq_el0                  */
+static uint64_t       jiffy_ticks;          /* cntpct ticks per jiffy      */
+static void         (*timer_notify)(uint64_t deadline);
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+static inline uint32_t timer_core_id(void)
+{
+    uint64_t mpidr;
+    __asm__ volatile("mrs %0, mpidr_el1" : "=r"(mpidr));
+    return (uint32_t)(mpidr & 0xFF) % TIMER_CORES;
+}
+
+static inline uint64_t timer_read_cntpct(void)
+{
+    uint64_t v;
+    __asm__ volatile("isb; mrs %0, cntpct_el0" : "=r"(v) :: "memory");
+    return v;
+}
+
+static inline uint64_t timer_irq_save(void)
+{
+    uint64_t daif;
+    __asm__ volatile("mrs %0, daif\n msr daifset, #2" : "=r"(daif) :: "memory");
+    return daif;
+}
+
+static inline void timer_irq_restore(uint64_t daif)
+{
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+}
+
+static inline void list_init(timer_link_t *head)
+{
+    head->next = head->prev = head;
+}
+
+static inline void list_unlink(timer_link_t *n)
+{
+    n->prev->next = n->next;
+    n->next->prev = n->prev;
+    n->next = n->prev = 0;
+}
+
+/* Move every entry of 'from' to the (empty) list 'to' */
+static inline void list_splice(timer_link_t *from, timer_link_t *to)
+{
+    to->next = from->next;
+    to->prev = from->prev;
+    to->next->prev = to;
+    to->prev->next = to;
+    list_init(from);
+}
+
+/******************************************************************************
+* Function: wheel_reset
+* Description: Empty a wheel and start it at the current jiffy. Timers that
+*              were armed on it are forgotten, not fired.
+*****************************************************************************/
+static void wheel_reset(timer_wheel_t *w)
+{
+    if (!jiffy_ticks) {
+        __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(timer_freq));
+        jiffy_ticks = timer_freq / TIMER_WHEEL_HZ;
+        if (!jiffy_ticks) jiffy_ticks = 1;
+    }
+    for (uint32_t k = 0; k < TIMER_LEVELS; k++) {
+        for (uint32_t s = 0; s < TIMER_SLOTS; s++) list_init(&w->slot[k][s]);
+        w->occupied[k] = 0;
+    }
+    w->now         = timer_read_cntpct() / jiffy_ticks;
+    w->running     = 0;
+    w->st.pending  = 0;
+    w->st.fired    = 0;
+    w->st.cascaded = 0;
+    w->ready       = 1;
+}
+
+/* This core's wheel, set up on first use */
+static inline timer_wheel_t *wheel_self(void)
+{
+    timer_wheel_t *w = &wheels[timer_core_id()];
+    if (!w->ready) wheel_reset(w);
+    return w;
+}
+
+/******************************************************************************
+* Function: wheel_add
+* Description: File an armed timer by its distance from 'now': level k holds
+*              distances below 64^(k+1), in the slot of its expiry's level-k
+*              digit. That slot comes round (jiffy index a multiple of 64^k
+*              with that digit) before the expiry and after 'now', so
+*              nothing is cascaded early or missed. Expired timers go into
+*              the slot of 'now'; distances beyond TIMER_SPAN are clamped
+*              and filed again on every cascade until they are in range.
+*****************************************************************************/
+static void wheel_add(timer_wheel_t *w, sw_timer_t *t)
+{
+    uint64_t e = (t->expires < w->now) ? w->now : t->expires;
+    uint64_t d = e - w->now;
+    uint32_t k = 0;
+
+    if (d >= TIMER_SPAN) {
+        d = TIMER_SPAN - 1;
+        e = w->now + d;
+    }
+    while (d >> (TIMER_LEVEL_BITS * (k + 1))) k++;
+
+    uint32_t      s    = (uint32_t)(e >> (TIMER_LEVEL_BITS * k)) & TIMER_SLOT_MASK;
+    timer_link_t *head = &w->slot[k][s];
+
+    t->link.next       = head;
+    t->link.prev       = head->prev;
+    head->prev->next   = &t->link;
+    head->prev         = &t->link;
+    t->level           = (uint8_t)k;
+    t->slot            = (uint8_t)s;
+    w->occupied[k]    |= 1ull << s;
+    w->st.pending++;
+}
+
+/* Take an armed timer off its slot list (or the list timer_run detached) */
+static void wheel_del(timer_wheel_t *w, sw_timer_t *t)
+{
+    timer_link_t *head = &w->slot[t->level][t->slot];
+
+    list_unlink(&t->link);
+    if (head->next == head) w->occupied[t->level] &= ~(1ull << t->slot);
+    t->level = TIMER_LEVEL_NONE;
+    w->st.pending--;
+}
+
+/******************************************************************************
+* Function: wheel_next_event
+* Description: The first jiffy >= now with work: for each level, the first
+*              occupied slot at or after the slot that comes round next
+*              (one rotate + CTZ of the level's bitmap). Level 0 gives an
+*              expiry, higher levels give a cascade.
+* Returns: the jiffy, or TIMER_NO_DEADLINE if the wheel is empty
+*****************************************************************************/
+static uint64_t wheel_next_event(const timer_wheel_t *w)
+{
+    uint64_t best = TIMER_NO_DEADLINE;
+
+    if (!w->st.pending) return best;
+
+    for (uint32_t k = 0; k < TIMER_LEVELS; k++) {
+        uint64_t occ = w->occupied[k];
+        if (!occ) continue;
+
+        uint32_t shift = TIMER_LEVEL_BITS * k;
+        uint64_t block = (w->now + (1ull << shift) - 1) >> shift;
+        uint32_t s     = (uint32_t)block & TIMER_SLOT_MASK;
+        uint64_t rot   = (occ >> s) | (occ << ((TIMER_SLOTS - s) & TIMER_SLOT_MASK));
+        uint64_t when  = (block + (uint64_t)__builtin_ctzll(rot)) << shift;
+
+        if (when < best) best = when;
+    }
+    return best;
+}
+
+/******************************************************************************
+* Function: wheel_process
+* Description: Handle jiffy 'j': cascade the higher-level slots that come
+*              round at 'j' (top level first), then fire everything in the
+*              level-0 slot. The slot is detached first and 'now' moves past
+*              'j', so a callback that re-arms for "now" lands in the next
+*              jiffy instead of the list being walked.
+*****************************************************************************/
+static void wheel_process(timer_wheel_t *w, uint64_t j)
+{
+    timer_link_t list;
+
+    w->now = j;
+
+    for (uint32_t k = TIMER_LEVELS - 1; k > 0; k--) {
+        uint32_t shift = TIMER_LEVEL_BITS * k;
+        uint32_t s     = (uint32_t)(j >> shift) & TIMER_SLOT_MASK;
+
+        if ((j & ((1ull << shift) - 1)) || !(w->occupied[k] & (1ull << s))) continue;
+
+        list_splice(&w->slot[k][s], &list);
+        w->occupied[k] &= ~(1ull << s);
+        while (list.next != &list) {
+            sw_timer_t *t = TIMER_CONTAINER(list.next, sw_timer_t, link);
+            list_unlink(&t->link);
+            w->st.pending--;
+            wheel_add(w, t);
+            w->st.cascaded++;
+        }
+    }
+
+    uint32_t s = (uint32_t)j & TIMER_SLOT_MASK;
+    w->now = j + 1;
+    if (!(w->occupied[0] & (1ull << s))) return;
+
+    list_splice(&w->slot[0][s], &list);
+    w->occupied[0] &= ~(1ull << s);
+    while (list.next != &list) {
+        sw_timer_t *t = TIMER_CONTAINER(list.next, sw_timer_t, link);
+        wheel_del(w, t);
+        if (t->period) {
+            t->expires += t->period;
+            wheel_add(w, t);
+        }
+        w->st.fired++;
+        t->fn(t);
+    }
+}
+
+/******************************************************************************
+* Function: timer_init
+* Description: Empty the calling core's wheel and start it at the current
+*              time (the scheduler does this in sched_run). Optional: a
+*              wheel sets itself up on first use.
+*****************************************************************************/
+void timer_init(void)
+{
+    uint64_t daif = timer_irq_save();
+    wheel_reset(&wheels[timer_core_id()]);
+    timer_irq_restore(daif);
+}
+
+/******************************************************************************
+* Function: timer_setup
+* Description: Initialise a timer, not armed, with its callback
+*****************************************************************************/
+void timer_setup(sw_timer_t *t, timer_fn_t fn)
+{
+    t->link.next = t->link.prev = 0;
+    t->expires   = 0;
+    t->fn        = fn;
+    t->period    = 0;
+    t->core      = 0;
+    t->level     = TIMER_LEVEL_NONE;
+    t->slot      = 0;
+    t->reserved  = 0;
+}
+
+/******************************************************************************
+* Function: timer_set_notify
+* Description: Register the hook told when timer_arm() may have moved the
+*              calling core's next deadline earlier (the scheduler re-arms
+*              its one-shot timer there). Not called from inside timer_run().
+*****************************************************************************/
+void timer_set_notify(void (*fn)(uint64_t deadline))
+{
+    timer_notify = fn;
+}
+
+/******************************************************************************
+* Function: timer_arm
+* Description: (Re)arm a timer on the calling core's wheel to fire
+*              'delay_us' from now, rounded up to the next jiffy, and then
+*              every 'period_us' if that is not 0. An armed timer is moved.
+*              O(1). Masks IRQs itself, so tasks may call it.
+* Returns: 0, or -1 if the timer is armed on another core
+*****************************************************************************/
+int timer_arm(sw_timer_t *t, uint64_t delay_us, uint32_t period_us)
+{
+    uint64_t daif = timer_irq_save();
+    uint32_t core = timer_core_id();
+    timer_wheel_t *w = wheel_self();
+
+    if (timer_pending(t)) {
+        if (t->core != core) {
+            timer_irq_restore(daif);
+            return -1;
+        }
+        wheel_del(w, t);
+    }
+
+    uint64_t delay = (delay_us / 1000000u) * timer_freq +
+                     (delay_us % 1000000u) * timer_freq / 1000000u;
+    uint64_t due   = timer_read_cntpct() + delay;
+
+    t->expires = (due + jiffy_ticks - 1) / jiffy_ticks;
+    t->period  = (period_us + TIMER_US_PER_JIFFY - 1) / TIMER_US_PER_JIFFY;
+    t->core    = (uint8_t)core;
+    wheel_add(w, t);
+
+    if (timer_notify && !w->running) timer_notify(timer_next_deadline());
+    timer_irq_restore(daif);
+    return 0;
+}
+
+/******************************************************************************
+* Function: timer_cancel
+* Description: Disarm a timer, O(1). A periodic timer may cancel itself
+*              from its callback.
+* Returns: 1 if it was armed, 0 if not, -1 if it is armed on another core
+*****************************************************************************/
+int timer_cancel(sw_timer_t *t)
+{
+    uint64_t daif = timer_irq_save();
+    int      ret  = 0;
+
+    if (timer_pending(t)) {
+        if (t->core != timer_core_id()) {
+            ret = -1;
+        } else {
+            wheel_del(&wheels[t->core], t);
+            ret = 1;
+        }
+    }
+    timer_irq_restore(daif);
+    return ret;
+}
+
+/******************************************************************************
+* Function: timer_run
+* Description: Bring the calling core's wheel up to cntpct 'now': process
+*              every jiffy with work up to and including now's, jumping
+*              over the empty ones. IRQs masked; callbacks run here.
+* Returns: number of callbacks run
+*****************************************************************************/
+uint32_t timer_run(uint64_t now)
+{
+    timer_wheel_t *w      = wheel_self();
+    uint64_t       target = now / jiffy_ticks;
+    uint64_t       fired  = w->st.fired;
+    uint64_t       j;
+
+    w->running = 1;
+    while ((j = wheel_next_event(w)) <= target) {
+        wheel_process(w, j);
+    }
+    if (target >= w->now) w->now = target + 1;
+    w->running = 0;
+
+    return (uint32_t)(w->st.fired - fired);
+}
+
+/******************************************************************************
+* Function: timer_next_deadline
+* Description: cntpct of the calling core's next jiffy with work: the
+*              earliest expiry, or a cascade that comes before it
+* Returns: the cntpct value, or TIMER_NO_DEADLINE if nothing is armed
+*****************************************************************************/
+uint64_t timer_next_deadline(void)
+{
+    uint64_t j = wheel_next_event(wheel_self());
+    return (j == TIMER_NO_DEADLINE) ? j : j * jiffy_ticks;
+}
+
+/******************************************************************************
+* Function: timer_stats
+* Description: Counters of one core's wheel. Written by that core only.
+*****************************************************************************/
+void timer_stats(uint32_t core, timer_stats_t *out)
+{
+    const timer_wheel_t *w = &wheels[core % TIMER_CORES];
+
+    out->pending  = w->st.pending;
+    out->fired    = w->st.fired;
+    out->cascaded = w->st.cascaded;
+}
@@ -0,0 +1,107 @@
+/******************************************************************************
+* File: timer_wheel.h
+* Project: RPi5-Industrial-Gateway Bare Metal Development
+* Description: Per-core hierarchical timer wheel for software timers
+*
+* Time is counted in jiffies of 1 / TIMER_WHEEL_HZ seconds (100 us), derived
+* from cntpct. Every core owns one wheel of TIMER_LEVELS levels with
+* TIMER_SLOTS slots each; a slot at level k spans 64^k jiffies:
+*
+*   level 0   1 jiffy per slot       expiries   0 .. 6.3 ms ahead
+*   level 1   64                                .. 409 ms
+*   level 2   4096                              .. 26 s
+*   level 3   262144                            .. 28 min (further: clamped
+*                                               and re-filed on cascade)
+*
+* A slot is an intrusive doubly-linked list and every level keeps a bitmap
+* of its non-empty slots, so:
+*
+*   timer_arm()     O(1)  pick the level from the distance, link at tail
+*   timer_cancel()  O(1)  unlink, clear the slot bit if it emptied
+*   timer_run()     O(1)  amortised per timer: each timer is moved down at
+*                   most TIMER_LEVELS - 1 times before it fires, and idle
+*                   jiffies are skipped by a CTZ over each level's bitmap
+*
+* timer_next_deadline() gives the cntpct of the next jiffy with work (an
+* expiry or a cascade), which the scheduler programs into its one-shot
+* timer; nothing runs between events.
+*
+* A timer belongs to the wheel of the core that armed it. Arm, cancel and
+* run it on that core only, with IRQs masked (the scheduler calls
+* timer_run() from its timer IRQ). Callbacks run from timer_run(), IRQs
+* masked, and may arm or cancel any timer of their own core, including
+* their own. A periodic timer is re-armed, one period after its previous
+* expiry, before its callback runs. The callback receives the timer; embed
+* it in a larger object and recover that with TIMER_CONTAINER().
+*
+* Copyright (c) 2026 Maior Cristian
+*****************************************************************************/
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define TIMER_CORES         4
+#define TIMER_WHEEL_HZ      10000u          /* jiffy = 100 us              */
+#define TIMER_LEVEL_BITS    6
+#define TIMER_SLOTS         (1u << TIMER_LEVEL_BITS)
+#define TIMER_LEVELS        4
+#define TIMER_LEVEL_NONE    0xFF            /* sw_timer_t.level: not armed */
+#define TIMER_NO_DEADLINE   UINT64_MAX
+
+/* The object a timer is embedded in, from the timer a callback receives */
+#define TIMER_CONTAINER(t, type, member) \
+    ((type *)((uint8_t *)(t) - offsetof(type, member)))
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+typedef struct timer_link {
+    struct timer_link *next, *prev;
+} timer_link_t;
+
+struct sw_timer;
+typedef void (*timer_fn_t)(struct sw_timer *t);
+
+typedef struct sw_timer {
+    timer_link_t link;          /* in a slot list while armed              */
+    uint64_t     expires;       /* jiffy                                   */
+    timer_fn_t   fn;
+    uint32_t     period;        /* jiffies, 0 = one-shot                   */
+    uint8_t      core;          /* wheel it is armed on                    */
+    uint8_t      level;         /* TIMER_LEVEL_NONE while not armed        */
+    uint8_t      slot;
+    uint8_t      reserved;
+} sw_timer_t;
+
+typedef struct {
+    uint32_t pending;           /* armed timers                            */
+    uint64_t fired;             /* callbacks run                           */
+    uint64_t cascaded;          /* timers moved down a level               */
+} timer_stats_t;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+void     timer_init(void);
+void     timer_setup(sw_timer_t *t, timer_fn_t fn);
+void     timer_set_notify(void (*fn)(uint64_t deadline));
+int      timer_arm(sw_timer_t *t, uint64_t delay_us, uint32_t period_us);
+int      timer_cancel(sw_timer_t *t);
+uint32_t timer_run(uint64_t now);
+uint64_t timer_next_deadline(void);
+void     timer_stats(uint32_t core, timer_stats_t *out);
+
+static inline int timer_pending(const sw_timer_t *t)
+{
+    return t->level != TIMER_LEVEL_NONE;
+}
+
+#endif /* TIMER_WHEEL_H */
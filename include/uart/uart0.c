@@ -8,6 +8,10 @@
  * INCLUDE FILES
  ***************************************************/
 #include "uart/uart0.h"
+#include "ipc/spinlock.h"
+#include "ringbuffer/ringbuf.h"
+#include "interrupts/irq.h"
+#include "pmu/pmu.h"
 
 /**************************************************
  * GLOBAL VARIABLES
@@ -17,10 +21,29 @@ volatile unsigned int* const uart0_fr = (volatile unsigned int*)(UART0_BASE + UA
 
 static const char hex_chars[] = "0123456789ABCDEF";
 
+#define UART_REG(off)   (*(volatile unsigned int*)(UART0_BASE + (off)))
+
+/*
+ * Interrupt-driven mode state. Before uart_irq_init() every call polls the
+ * FIFO as before (boot banners, fatal paths).
+ *   rx_ring : ISR (Core 0) produces, uart_read() consumes — lock-free SPSC
+ *   tx_ring : any core produces, ISR or the producer itself drains it;
+ *             both sides hold tx_lock with local IRQs masked
+ */
+static int          uart_irq_mode;
+static unsigned int rx_dropped;
+static unsigned int tx_irqs;            // TX refills done by the ISR
+static spinlock_t   tx_lock;
+static ring_buffer_t rx_ring;
+static ring_buffer_t tx_ring;
+static void        (*rx_notify)(void);  // called by the ISR after an RX burst
+
 /**************************************************
  * HELPER FUNCTIONS
  ***************************************************/
 void uart_init() {
+    uart_irq_mode = 0;
+
     #if defined(TARGET_QEMU)
         (void)0; // No configuration needed
 
@@ -69,10 +92,51 @@ void uart_init() {
     #endif
 }
 
+/* Mask IRQs on this core; returns the previous DAIF for irq_restore() */
+static inline unsigned long irq_save(void) {
+    unsigned long daif;
+    __asm__ volatile("mrs %0, daif\n msr daifset, #2" : "=r"(daif) :: "memory");
+    return daif;
+}
+
+static inline void irq_restore(unsigned long daif) {
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+}
+
+/******************************************************************************
+* Function: uart_tx_pump
+* Description: Move bytes from tx_ring into the TX FIFO until one of them is
+*              full/empty. Unmasks TXIM while bytes remain so the ISR keeps
+*              the FIFO fed, masks it once the ring is drained.
+*              Caller holds tx_lock with IRQs masked.
+*****************************************************************************/
+static void uart_tx_pump(void) {
+    unsigned char c;
+
+    while (!(*uart0_fr & UART_FR_TXFF) && ring_buffer_get(&tx_ring, &c) == 0) {
+        *uart0_dr = c;
+    }
+
+    if (tx_ring.head != tx_ring.tail) {
+        UART_REG(UART_IMSC_OFFSET) |= UART_INT_TX;
+    } else {
+        UART_REG(UART_IMSC_OFFSET) &= ~UART_INT_TX;
+    }
+}
+
 void uart_putc(char c) {
-    // Wait while transmit FIFO is full (bit 5 of FR register)
-    while (*uart0_fr & (1 << 5));
-    *uart0_dr = c;
+    if (!uart_irq_mode) {
+        // Wait while transmit FIFO is full (bit 5 of FR register)
+        while (*uart0_fr & UART_FR_TXFF);
+        *uart0_dr = c;
+        return;
+    }
+
+    /* Ring full means the wire is the bottleneck — push what the FIFO will
+     * take ourselves (also covers callers running with IRQs masked). */
+    while (uart_write((const unsigned char *)&c, 1) == 0) {
+        __asm__ volatile("yield");
+    }
 }
 
 void uart_puts(const char* str) {
@@ -89,9 +153,25 @@ void uart_puthex(unsigned long val) {
     }
 }
 
+void uart_putdec(unsigned long val) {
+    char digits[20];                    // 2^64 - 1 has 20 digits
+    int n = 0;
+
+    do {
+        digits[n++] = (char)('0' + (val % 10));
+        val /= 10;
+    } while (val);
+
+    while (n) uart_putc(digits[--n]);
+}
+
 bool uart_has_data(void) {
+    if (uart_irq_mode) {
+        const volatile unsigned char *span;
+        return ring_buffer_peek(&rx_ring, &span, 1) != 0;
+    }
     // RXFE (Receive FIFO Empty) bit 4: 0 = data available, 1 = empty
-    return (*uart0_fr & (1 << 4)) == 0;
+    return (*uart0_fr & UART_FR_RXFE) == 0;
 }
 
 const unsigned int uart_special_chars(unsigned char *receiveChar) {
@@ -104,6 +184,13 @@ const unsigned int uart_special_chars(unsigned char *receiveChar) {
 }
 
 unsigned uart_getc(void) {
+    if (uart_irq_mode) {
+        unsigned char c;
+        while (ring_buffer_get(&rx_ring, &c) != 0) {
+            __asm__ volatile("wfi");    // next RX/RT interrupt wakes us
+        }
+        return c;
+    }
     // FR = 0 -> FIFO has data => while(true) => "WAIT"
     // i.e if bit 4 is up => FR = 1 => empty => while(false)
     while(! uart_has_data()); // Empty means FR = 1
@@ -114,5 +201,148 @@ key_event_t uart_key_event(unsigned char byte)
 {
     if (byte == 0x03)                    return KEY_CTRL_C;
     if (byte == 0x0D || byte == 0x0A)   return KEY_ENTER;
+    if (byte == 0x10)                    return KEY_CTRL_P;
+    if (byte == 0x12)                    return KEY_CTRL_R;
     return KEY_NONE;
 }
+
+/******************************************************************************
+* Function: uart_irq_init
+* Description: Switch the driver to interrupt-driven mode. Sets the FIFO
+*              watermarks (RX at 1/2, TX at 1/4), unmasks RX + RX-timeout
+*              and registers the ISR on INTID 33 at IRQ_PRIO_HIGH, so RX
+*              preempts the tick and other default-priority handlers.
+*              Must run after irq_init() on Core 0 (SPIs are routed to
+*              CPU0). TXIM is only unmasked while tx_ring holds data.
+*****************************************************************************/
+void uart_irq_init(void) {
+    ring_buffer_init(&rx_ring);
+    ring_buffer_init(&tx_ring);
+    spinlock_lock_init(&tx_lock);
+    rx_dropped = 0;
+    tx_irqs    = 0;
+
+    UART_REG(UART_LCRH_OFFSET) |= (1 << 4);    /* FEN — watermarks need FIFOs */
+    UART_REG(UART_IFLS_OFFSET) = UART_IFLS_TX_1_4 | UART_IFLS_RX_1_2;
+    UART_REG(UART_ICR_OFFSET)  = 0x7FF;
+    UART_REG(UART_IMSC_OFFSET) = UART_INT_RX | UART_INT_RT;
+
+    __asm__ volatile("dmb sy" ::: "memory");
+    uart_irq_mode = 1;
+    irq_set_priority(IRQ_ID_UART0, IRQ_PRIO_HIGH);
+    irq_register_handler(IRQ_ID_UART0, uart_irq_handler);
+}
+
+/******************************************************************************
+* Function: uart_irq_handler
+* Description: INTID 33. RX/RT: drain the whole RX FIFO into rx_ring and
+*              publish it with one commit. TX: refill the TX FIFO from
+*              tx_ring. Error bits are cleared and the byte is kept.
+*              The RX FIFO is read until empty (at most UART_FIFO_DEPTH).
+*****************************************************************************/
+void uart_irq_handler(unsigned int irq_id) {
+    (void)irq_id;
+    PMU_PROBE_BEGIN(PMU_PROBE_UART_ISR);
+    unsigned int mis = UART_REG(UART_MIS_OFFSET);
+
+    if (mis & (UART_INT_RX | UART_INT_RT)) {
+        unsigned char burst[UART_FIFO_DEPTH];
+        unsigned int n = 0;
+
+        while (n < UART_FIFO_DEPTH && !(*uart0_fr & UART_FR_RXFE)) {
+            burst[n++] = (unsigned char)(*uart0_dr & 0xFF);
+        }
+        /* One release for the whole burst; the rest is lost if the
+         * consumer is not keeping up */
+        unsigned int put = ring_buffer_write(&rx_ring, burst, n);
+        rx_dropped += n - put;
+        if (put) __asm__ volatile("sev" ::: "memory");
+        if (put && rx_notify) rx_notify();
+    }
+
+    if (mis & UART_INT_TX) {
+        unsigned long daif = irq_save();    // handlers run unmasked (nesting)
+        spinlock_acquire(&tx_lock);
+        uart_tx_pump();
+        tx_irqs++;
+        spinlock_release(&tx_lock);
+        irq_restore(daif);
+    }
+
+    UART_REG(UART_ICR_OFFSET) = mis & (UART_INT_RX | UART_INT_RT | UART_INT_ERR);
+    PMU_PROBE_END(PMU_PROBE_UART_ISR);
+}
+
+/******************************************************************************
+* Function: uart_write
+* Description: Queue up to 'len' bytes for transmission and start the FIFO.
+*              Never waits on the wire; callable from any core.
+* Returns: number of bytes accepted (less than len if tx_ring is full)
+*****************************************************************************/
+unsigned int uart_write(const unsigned char *src, unsigned int len) {
+    unsigned long daif = irq_save();
+    spinlock_acquire(&tx_lock);
+
+    unsigned int n = ring_buffer_write(&tx_ring, src, len);
+    uart_tx_pump();
+
+    spinlock_release(&tx_lock);
+    irq_restore(daif);
+    return n;
+}
+
+/******************************************************************************
+* Function: uart_tx_queue
+* Description: Like uart_write() but never touches the FIFO: the bytes only
+*              go into tx_ring and TXIM is unmasked, so the ISR sends all
+*              of them. Constant cost for the caller, whatever the wire.
+* Returns: number of bytes accepted (less than len if tx_ring is full)
+*****************************************************************************/
+unsigned int uart_tx_queue(const unsigned char *src, unsigned int len) {
+    unsigned long daif = irq_save();
+    spinlock_acquire(&tx_lock);
+
+    unsigned int n = ring_buffer_write(&tx_ring, src, len);
+    if (n) UART_REG(UART_IMSC_OFFSET) |= UART_INT_TX;
+
+    spinlock_release(&tx_lock);
+    irq_restore(daif);
+    return n;
+}
+
+/******************************************************************************
+* Function: uart_read
+* Description: Copy up to 'len' received bytes out of rx_ring (non-blocking).
+*              Single consumer — only one task may read the UART.
+* Returns: number of bytes copied
+*****************************************************************************/
+unsigned int uart_read(unsigned char *dst, unsigned int len) {
+    return ring_buffer_read(&rx_ring, dst, len);
+}
+
+/******************************************************************************
+* Function: uart_set_rx_notify
+* Description: Have the ISR call 'fn' (IRQ context, Core 0) each time it
+*              queued received bytes, e.g. to wake the reading task.
+*              0 turns it off.
+*****************************************************************************/
+void uart_set_rx_notify(void (*fn)(void)) {
+    rx_notify = fn;
+}
+
+/******************************************************************************
+* Function: uart_tx_pending / uart_rx_dropped / uart_tx_irqs
+* Description: Bytes still queued for the wire / RX bytes lost to a full ring
+*              / TX interrupts that refilled the FIFO
+*****************************************************************************/
+unsigned int uart_tx_pending(void) {
+    return (tx_ring.head - tx_ring.tail) & (RING_BUFFER_SIZE - 1);
+}
+
+unsigned int uart_rx_dropped(void) {
+    return rx_dropped;
+}
+
+unsigned int uart_tx_irqs(void) {
+    return tx_irqs;
+}
@@ -18,17 +18,35 @@
     #define UART0_BASE 0x09000000
 #elif defined(TARGET_RPI5)
     #define UART0_BASE  0x40030000
-    #define UART_CR_OFFSET    0x30
-    #define UART_IBRD_OFFSET  0x24
-    #define UART_FBRD_OFFSET  0x28
-    #define UART_LCRH_OFFSET  0x2C
-    #define UART_IMSC_OFFSET  0x38
-    #define UART_ICR_OFFSET   0x44
 #else 
     #error "Target undefined! Use an official platform"
 #endif
-#define UART_DR_OFFSET   0x00
-#define UART_FR_OFFSET   0x18
+/* PL011 register map — identical on QEMU virt and the RP1 UART */
+#define UART_DR_OFFSET    0x00
+#define UART_FR_OFFSET    0x18
+#define UART_IBRD_OFFSET  0x24
+#define UART_FBRD_OFFSET  0x28
+#define UART_LCRH_OFFSET  0x2C
+#define UART_CR_OFFSET    0x30
+#define UART_IFLS_OFFSET  0x34
+#define UART_IMSC_OFFSET  0x38
+#define UART_MIS_OFFSET   0x40
+#define UART_ICR_OFFSET   0x44
+
+/* FR bits */
+#define UART_FR_RXFE      (1u << 4)     /* RX FIFO empty                    */
+#define UART_FR_TXFF      (1u << 5)     /* TX FIFO full                     */
+
+/* IMSC / MIS / ICR bits */
+#define UART_INT_RX       (1u << 4)     /* RX FIFO reached IFLS.RXIFLSEL    */
+#define UART_INT_TX       (1u << 5)     /* TX FIFO dropped to IFLS.TXIFLSEL */
+#define UART_INT_RT       (1u << 6)     /* RX timeout: data below watermark */
+#define UART_INT_ERR      (0xFu << 7)   /* FE, PE, BE, OE                   */
+
+/* IFLS watermarks */
+#define UART_FIFO_DEPTH   32            /* PL011 r1p5 (QEMU models 16)      */
+#define UART_IFLS_TX_1_4  (1u << 0)     /* TX irq when <= 1/4 full          */
+#define UART_IFLS_RX_1_2  (2u << 3)     /* RX irq when >= 1/2 full          */
 
 /*************************************************
  *  TYPEDEF STRUCTS UNIONS ENUMS
@@ -36,7 +54,9 @@
 typedef enum {
     KEY_NONE   = 0,
     KEY_CTRL_C = 1,   /* 0x03 */
-    KEY_ENTER  = 2    /* 0x0D / 0x0A */
+    KEY_ENTER  = 2,   /* 0x0D / 0x0A */
+    KEY_CTRL_P = 3,   /* 0x10 — dump PMU probes */
+    KEY_CTRL_R = 4    /* 0x12 — start / stop + dump the profiler */
 } key_event_t;
 
 /**************************************************
@@ -46,10 +66,22 @@ void uart_init(void);
 void uart_putc(char c);
 void uart_puts(const char *s);
 void uart_puthex(unsigned long value);
+void uart_putdec(unsigned long value);
 bool uart_has_data(void);
 const unsigned int uart_special_chars(unsigned char*);
 unsigned uart_getc(void);
 key_event_t uart_key_event(unsigned char byte);
 
+/* Interrupt-driven mode (after irq_init): nothing below waits on the wire */
+void         uart_irq_init(void);
+void         uart_irq_handler(unsigned int irq_id);
+unsigned int uart_write(const unsigned char *src, unsigned int len);
+unsigned int uart_tx_queue(const unsigned char *src, unsigned int len);
+unsigned int uart_read(unsigned char *dst, unsigned int len);
+unsigned int uart_tx_pending(void);
+unsigned int uart_rx_dropped(void);
+unsigned int uart_tx_irqs(void);
+void         uart_set_rx_notify(void (*fn)(void));
+
 #endif
 
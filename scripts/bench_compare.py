@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+bench_compare.py - code size and benchmark deltas between build profiles.
+
+Each argument is label=build_dir. The script reads build_dir/bench.log (the
+output 'make bench' tees) and runs `size` on build_dir/bench.elf. The first
+profile is the baseline and every other column is relative to it.
+
+  scripts/bench_compare.py debug=build/debug-a72 release=build/release-a72
+
+Normally run through 'make bench-compare [COMPARE="debug release pgo"]'.
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+BENCH_RE = re.compile(r"^BENCH name=(\S+) .*?p50=(\d+) p99=(\d+)")
+
+
+def read_bench(path):
+    res = {}
+    try:
+        with open(path, errors="replace") as f:
+            for line in f:
+                m = BENCH_RE.match(line.strip())
+                if m:
+                    res[m.group(1)] = (int(m.group(2)), int(m.group(3)))
+    except OSError:
+        print("bench_compare: missing %s" % path, file=sys.stderr)
+    return res
+
+
+def read_size(tool, elf):
+    try:
+        out = subprocess.run([tool, elf], check=True, capture_output=True,
+                             text=True).stdout.splitlines()
+        text, data, bss = (int(v) for v in out[1].split()[:3])
+        return text, data, bss
+    except (OSError, subprocess.CalledProcessError, IndexError, ValueError):
+        return None
+
+
+def pct(new, base):
+    return "%+.1f%%" % (100.0 * (new - base) / base) if base else "n/a"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--size", default="aarch64-none-elf-size")
+    ap.add_argument("profiles", nargs="+", metavar="label=dir")
+    args = ap.parse_args()
+
+    profiles = [p.split("=", 1) for p in args.profiles]
+    base_label = profiles[0][0]
+
+    print("== code size (bench.elf) ==")
+    print("%-10s %10s %8s %8s %9s" % ("profile", "text", "data", "bss", "text vs " + base_label))
+    base_text = None
+    for label, d in profiles:
+        sz = read_size(args.size, d + "/bench.elf")
+        if sz is None:
+            print("%-10s %10s" % (label, "-"))
+            continue
+        if base_text is None:
+            base_text = sz[0]
+        print("%-10s %10d %8d %8d %9s" % (label, sz[0], sz[1], sz[2], pct(sz[0], base_text)))
+
+    results = [(label, read_bench(d + "/bench.log")) for label, d in profiles]
+    names = sorted(set().union(*(r.keys() for _, r in results)))
+
+    print("\n== p50 cycles (speedup vs %s) ==" % base_label)
+    print("%-18s" % "bench" + "".join("%20s" % label for label, _ in results))
+    for name in names:
+        base = results[0][1].get(name)
+        row = "%-18s" % name
+        for _, r in results:
+            v = r.get(name)
+            if v is None:
+                row += "%20s" % "-"
+            elif base is None or r is results[0][1]:
+                row += "%20d" % v[0]
+            else:
+                row += "%12d (%.2fx)" % (v[0], base[0] / v[0] if v[0] else 0.0)
+        print(row)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""
+prof_fold.py - turn a PC-sampling profile (include/prof/prof.h) into
+folded stacks for flamegraph.pl / speedscope / inferno.
+
+Input is either
+  * a UART capture holding PROF_BEGIN ... PROF_END (Ctrl+R on the console), or
+  * the raw dump written by prof_dump_semihost() (starts with "PRF1").
+
+Usage:
+  scripts/prof_fold.py uart.log > kernel.folded
+  scripts/prof_fold.py --per-core prof.bin | flamegraph.pl > kernel.svg
+
+Addresses are symbolized with `nm -n` on the ELF (default build/debug-a72/kernel.elf,
+tool aarch64-none-elf-nm, override with --elf / --nm).
+"""
+
+import argparse
+import bisect
+import collections
+import struct
+import subprocess
+import sys
+
+MAGIC = b"PRF1"
+END_CORE = 0xFF
+
+
+def load_symbols(nm, elf):
+    out = subprocess.run([nm, "-n", "--defined-only", elf],
+                         check=True, capture_output=True, text=True).stdout
+    addrs, names = [], []
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) != 3 or parts[1] not in "tTwW":
+            continue
+        addr = int(parts[0], 16)
+        if addrs and addrs[-1] == addr:
+            continue                        # keep the first alias
+        addrs.append(addr)
+        names.append(parts[2])
+    return addrs, names
+
+
+def symbolize(symtab, addr):
+    addrs, names = symtab
+    i = bisect.bisect_right(addrs, addr) - 1
+    return names[i] if i >= 0 else "0x%x" % addr
+
+
+def raw_from_uart(text):
+    """Concatenate the hex payload of every PROF line inside the markers."""
+    data, inside = bytearray(), False
+    for line in text.splitlines():
+        line = line.strip()
+        if line == "PROF_BEGIN":
+            data, inside = bytearray(), True   # keep the last dump only
+        elif line == "PROF_END":
+            inside = False
+        elif inside and line.startswith("PROF "):
+            data += bytes.fromhex(line[5:])
+    if not data:
+        sys.exit("prof_fold: no PROF_BEGIN/PROF_END block found")
+    return bytes(data)
+
+
+def parse(raw):
+    if raw[:4] != MAGIC:
+        sys.exit("prof_fold: bad magic, not a prof dump")
+    hz, cores, max_depth, nsamples, dropped = struct.unpack_from("<5I", raw, 4)
+    off, samples = 24, []
+    while off + 4 <= len(raw):
+        core, depth = raw[off], raw[off + 1]
+        off += 4
+        if core == END_CORE:
+            break
+        pcs = struct.unpack_from("<%dQ" % depth, raw, off)
+        off += 8 * depth
+        samples.append((core, pcs))
+    return {"hz": hz, "cores": cores, "max_depth": max_depth,
+            "samples": nsamples, "dropped": dropped}, samples
+
+
+def fold(samples, symtab, per_core):
+    counts = collections.Counter()
+    for core, pcs in samples:
+        # pcs[0] is the interrupted PC; the rest are return addresses, so
+        # step back one instruction to land inside the calling function.
+        frames = [symbolize(symtab, pcs[0])]
+        for i, ret in enumerate(pcs[1:], 1):
+            name = symbolize(symtab, ret - 4)
+            if i == 1 and name == frames[0]:
+                continue                    # LR still points into this function
+            frames.append(name)
+        if per_core:
+            frames.append("core%d" % core)
+        counts[";".join(reversed(frames))] += 1
+    return counts
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("dump", help="UART log or raw prof.bin")
+    ap.add_argument("--elf", default="build/debug-a72/kernel.elf")
+    ap.add_argument("--nm", default="aarch64-none-elf-nm")
+    ap.add_argument("--per-core", action="store_true",
+                    help="root every stack at coreN")
+    args = ap.parse_args()
+
+    with open(args.dump, "rb") as f:
+        raw = f.read()
+    if raw[:4] != MAGIC:
+        raw = raw_from_uart(raw.decode("ascii", "replace"))
+
+    info, samples = parse(raw)
+    symtab = load_symbols(args.nm, args.elf)
+    for stack, n in sorted(fold(samples, symtab, args.per_core).items()):
+        print("%s %d" % (stack, n))
+
+    print("prof_fold: %d samples at %d Hz, %d dropped"
+          % (len(samples), info["hz"], info["dropped"]), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
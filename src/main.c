@@ -31,11 +31,23 @@
 #include "scheduler/scheduler.h"
 #include "dispatcher.h"
 #include "crypto/hmac_sha256.h"
+#include "crypto/sha256.h"
+#include "crc/crc.h"
+#include "log/log.h"
+#include "pmu/pmu.h"
+#include "prof/prof.h"
+#include "pgo/pgo.h"
+#include "alloc/arena.h"
+#include "alloc/slab.h"
+#ifdef BENCH_BOOT
+#include "bench/bench.h"
+#endif
 
 /******************************************************************************
  * Macro Definition
  *****************************************************************************/
 #define PSCI_CPU_ON 0xC4000003
+#define PSCI_SYSTEM_OFF 0x84000008
 
 /*****************************************************************************
  * Global Variables
@@ -111,6 +123,51 @@ long psci_cpu_on(unsigned long cpu, unsigned long entry) {
     return x0;
 }
 
+/******************************************************************************
+ * Function: psci_system_off
+ * Description: Power the machine off (QEMU exits). Does not return.
+ *****************************************************************************/
+void psci_system_off(void) {
+    register unsigned long x0 __asm__("x0") = PSCI_SYSTEM_OFF;
+    __asm__ volatile("hvc #0" : "+r"(x0) :: "memory");
+    while (1) { __asm__ volatile("wfe"); }
+}
+
+#ifdef BENCH_BOOT
+static void bench_done(void) {
+    pgo_dump();                             // PGO_PHASE=gen only, no-op otherwise
+    psci_system_off();
+}
+
+/******************************************************************************
+ * Function: bench_boot
+ * Description: 'make bench' entry — Core 1 echoes mailbox traffic, Core 0
+ *              runs the benchmark suite. Then every core joins the
+ *              scheduler for the scaling benchmark, which powers off.
+ *****************************************************************************/
+static void bench_boot(void) {
+    extern void _start(void);
+
+    psci_cpu_on(1, (unsigned long)_start);
+    delay(10000000);                        // let Core 1 reach its echo loop
+
+    irq_init();
+    irq_enable();
+    bench_register_defaults();
+    bench_run_all();
+    bench_crc_run();
+    bench_modbus_run();
+    bench_mqtt_run();
+
+    mailbox_send(1, MSG_SHUTDOWN, 0);       // Core 1 leaves its echo loop
+    psci_cpu_on(2, (unsigned long)_start);
+    psci_cpu_on(3, (unsigned long)_start);
+    delay(10000000);                        // let Cores 1-3 reach sched_run
+
+    bench_scale_run(bench_done);            // does not return
+}
+#endif
+
 /******************************************************************************
  * Function: secondary_main
  * Description: Entry point for secondary CPU cores (Cores 1-3)
@@ -122,6 +179,13 @@ extern void _start(void);
 
 void secondary_main(void) {
     unsigned long cpu = get_cpu_id();
+
+    pmu_init();                             // event counters are per core
+
+#ifdef BENCH_BOOT
+    if (cpu == 1) bench_mailbox_echo();     // until MSG_SHUTDOWN
+    sched_run();                            // no pinned tasks: steal only
+#endif
     delay(cpu * 8000000);
 
     // All cores announce themselves (keep this)
@@ -135,47 +199,38 @@ void secondary_main(void) {
     // Testing with circular ring buffer 0 delay
     if (cpu == 1) {
         // Core 1: Producer — push test bytes 'A' to 'J' into ring buffer
-        spinlock_acquire(SPINLOCK_ADDR);
-        uart_puts("[Core 1] Ring buffer test: pushing A-J...\n");
-        spinlock_release(SPINLOCK_ADDR);
+        LOG_MSG("Ring buffer test: pushing A-J...");
 
-        for (unsigned char c = 'A'; c <= 'J'; c++) {
-            ring_buffer_put(UART_RX_BUFFER, c);
-        }
+        static const unsigned char test_bytes[] = "ABCDEFGHIJ";
+        ring_buffer_write(UART_RX_BUFFER, test_bytes, 10);   // one release for all 10
+        __asm__ volatile("sev" ::: "memory");
+
+        test_secondary_idle();              // test5/6/19's Core 1 side
 
-        while (1) { __asm__ volatile("wfe"); }
     }
 
     if (cpu == 2) {
         // Core 2: Consumer — read from ring buffer and print
-        spinlock_acquire(SPINLOCK_ADDR);
-        uart_puts("[Core 2] Ring buffer test: waiting for data...\n");
-        spinlock_release(SPINLOCK_ADDR);
+        LOG_MSG("Ring buffer test: waiting for data...");
 
         unsigned char byte;
         int received = 0;
         while (received < 10) {
             if (ring_buffer_get(UART_RX_BUFFER, &byte) == 0) {
-                spinlock_acquire(SPINLOCK_ADDR);
-                uart_puts("[Core 2] Got: ");
-                uart_putc(byte);
-                uart_puts("\n");
-                spinlock_release(SPINLOCK_ADDR);
+                LOG_CHAR("Got: ", byte);
                 received++;
             } else {
                 __asm__ volatile("wfe");  // sleep until Core 1 fires SEV
             }
         }
 
-        spinlock_acquire(SPINLOCK_ADDR);
-        uart_puts("[Core 2] Ring buffer test COMPLETE\n");
-        spinlock_release(SPINLOCK_ADDR);
+        LOG_MSG("Ring buffer test COMPLETE");
 
         while (1) { __asm__ volatile("wfe"); }
     }
 
     if (cpu == 3) {
-        jobContext_t mailbox_job = { MAILBOX_DISP_TASK, 3, "mailbox_dis", mailbox_dispatcher_task };
+        jobContext_t mailbox_job = { MAILBOX_DISP_TASK, 3, "mailbox_dis", mailbox_dispatcher_task, TASK_PRIO_NORMAL };
         sched_add_task(&mailbox_job);
         sched_run();
     }
@@ -195,18 +250,36 @@ void secondary_main(void) {
 void main(void) {
     /*********************************
      *          MAIN FLOW 
+     * Shared objects below are carved from the linker arena (alloc/arena.h)
      * Spinlock Init -> move between cores
      * Uart Init -> RX TX transm no conf needed QEMU 
+     * Log Init -> per-core log queues, drained by logger_task on Core 0
+     * PMU Init -> probe event counters (dump with Ctrl+P)
+     * Prof Init -> PC sampling profiler (start/stop + dump with Ctrl+R)
      * Ring Buffer Init -> Inter Core Messaging 
      * Mail Box Init -> all 4
+     * Slab Init -> message-buffer pools (alloc/slab.h)
      * I. Start the secondary cores: 1 2 3
-     * II. Start Interrupt Tests -> timer_tests
+     * II. Start Interrupt Tests -> timer_tests, then UART IRQ mode
      * III. Start Communication Tests -> trivial/tests.c
      * IV. Scheduler Register Tasks -> sched_add_tasks
      *******************************/
     spinlock_init();
     uart_init();
-    ring_buffer_init(UART_RX_BUFFER);
+    log_init();
+    pmu_init();
+    prof_init();
+    uart_rx_ring = ring_buffer_create();
+    if (tc_sha256_select_backend() == TC_SHA256_BACKEND_CE) {
+        uart_puts("[CRYPTO] SHA-256 backend: ARMv8 CE\n");
+    } else {
+        uart_puts("[CRYPTO] SHA-256 backend: scalar\n");
+    }
+    if (crc_select_backend() == CRC_BACKEND_HW) {
+        uart_puts("[CRC] CRC-32 backend: ARMv8 CRC32\n");
+    } else {
+        uart_puts("[CRC] CRC-32 backend: slicing-by-8\n");
+    }
     hmac_key_init(secret_key);
 
     spinlock_acquire(SPINLOCK_ADDR);
@@ -218,6 +291,16 @@ void main(void) {
     for (int i = 0; i < 4; i++) {
         mailbox_init(i);
     }
+
+    int pools = slab_msg_pools_init();
+    spinlock_acquire(SPINLOCK_ADDR);
+    if (pools != 0) uart_puts("[Core 0] Slab pools: arena exhausted!\n");
+    arena_stats_print();
+    spinlock_release(SPINLOCK_ADDR);
+
+#ifdef BENCH_BOOT
+    bench_boot();                           // does not return
+#endif
     
     spinlock_acquire(SPINLOCK_ADDR);
     uart_puts("[Core 0] Starting secondary cores...\n\n");
@@ -245,17 +328,26 @@ void main(void) {
 
     interrupt_tests_init();
 
+    /* From here on UART RX/TX are interrupt-driven (INTID 33 → Core 0) */
+    uart_irq_init();
+    irq_enable();
+
     spinlock_acquire(SPINLOCK_ADDR);
     uart_puts("\n[Core 0] === Starting Communication Test ===\n\n");
     spinlock_release(SPINLOCK_ADDR);
 
     run_all_tests();
 
-    jobContext_t uart_job = { UART_RX_TASK, 0, "uart_rx", uart_rx_task };
+    jobContext_t uart_job = { UART_RX_TASK, 0, "uart_rx", uart_rx_task, TASK_PRIO_NORMAL };
     sched_add_task(&uart_job);
 
-    jobContext_t consumer_job = { RING_COSUMER_TASK, 0, "ring_consumer", ring_consumer_task };
+    jobContext_t consumer_job = { RING_COSUMER_TASK, 0, "ring_consumer", ring_consumer_task, TASK_PRIO_NORMAL };
     sched_add_task(&consumer_job);
 
+    jobContext_t logger_job = { LOGGER_TASK, 0, "logger", logger_task, TASK_PRIO_LOW };
+    sched_add_task(&logger_job);
+
+    /* Time-slice Core 0 so a task that forgets to yield cannot starve the rest */
+    sched_preempt_enable(SCHED_QUANTUM_MS);
     sched_run();
 }
@@ -0,0 +1,152 @@
+/******************************************************************************
+ * File: bench.c
+ * Project: RPi5-Industrial-Gateway Bare Metal Development
+ * Description: Benchmark registry, sampling, statistics and UART report
+ * Copyright (c) 2026 Maior Cristian
+ ******************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "bench/bench.h"
+#include "uart/uart0.h"
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+static bench_t  bench_table[BENCH_MAX];
+static uint32_t bench_count;
+static uint64_t samples[BENCH_MAX_SAMPLES];
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+/* Insertion sort — n <= BENCH_MAX_SAMPLES and mostly-sorted input */
+static void sort_u64(uint64_t *v, uint32_t n)
+{
+    for (uint32_t i = 1; i < n; i++) {
+        uint64_t x = v[i];
+        uint32_t j = i;
+        while (j > 0 && v[j - 1] > x) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+}
+
+static inline uint32_t log2_bucket(uint64_t c)
+{
+    uint32_t b = c ? 63u - (uint32_t)__builtin_clzll(c) : 0;
+    return (b < BENCH_HIST_BUCKETS) ? b : BENCH_HIST_BUCKETS - 1;
+}
+
+/******************************************************************************
+ * Function: bench_register
+ * Description: Add a benchmark to the table run by bench_run_all()
+ * Parameters: name  - static string, no spaces (it is a report key)
+ *             fn    - one iteration
+ *             ctx   - passed to fn
+ *             iters - 0 = BENCH_DEFAULT_ITERS, clamped to BENCH_MAX_SAMPLES
+ * Returns: 0 on success, -1 if the table is full
+ *****************************************************************************/
+int bench_register(const char *name, bench_fn_t fn, void *ctx, uint32_t iters)
+{
+    if (bench_count >= BENCH_MAX) return -1;
+
+    if (iters == 0)                 iters = BENCH_DEFAULT_ITERS;
+    if (iters > BENCH_MAX_SAMPLES)  iters = BENCH_MAX_SAMPLES;
+
+    bench_table[bench_count].name  = name;
+    bench_table[bench_count].fn    = fn;
+    bench_table[bench_count].ctx   = ctx;
+    bench_table[bench_count].iters = iters;
+    bench_count++;
+    return 0;
+}
+
+/******************************************************************************
+ * Function: bench_run
+ * Description: One warm-up call, then b->iters timed calls. Fills 'res'.
+ *****************************************************************************/
+void bench_run(const bench_t *b, bench_result_t *res)
+{
+    uint64_t freq;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+
+    b->fn(b->ctx);                              /* warm caches / branch predictor */
+
+    uint64_t t0 = bench_ticks();
+    for (uint32_t i = 0; i < b->iters; i++) {
+        uint64_t c0 = bench_cycles();
+        uint64_t self = b->fn(b->ctx);
+        uint64_t c1 = bench_cycles();
+        samples[i] = (self != BENCH_SELF_TIMED) ? self : (c1 - c0);
+    }
+    uint64_t ticks = bench_ticks() - t0;
+
+    for (uint32_t k = 0; k < BENCH_HIST_BUCKETS; k++) res->hist[k] = 0;
+    for (uint32_t i = 0; i < b->iters; i++) res->hist[log2_bucket(samples[i])]++;
+
+    sort_u64(samples, b->iters);
+    res->iters   = b->iters;
+    res->min     = samples[0];
+    res->p50     = samples[b->iters / 2];
+    res->p99     = samples[(b->iters * 99u) / 100u];
+    res->max     = samples[b->iters - 1];
+    res->mean_ns = (ticks * 1000000000ull / freq) / b->iters;
+}
+
+/******************************************************************************
+ * Function: bench_report
+ * Description: Print the BENCH and BENCH_HIST lines for one result
+ *****************************************************************************/
+void bench_report(const char *name, const bench_result_t *res)
+{
+    uart_puts("BENCH name=");   uart_puts(name);
+    uart_puts(" iters=");       uart_putdec(res->iters);
+    uart_puts(" min=");         uart_putdec(res->min);
+    uart_puts(" p50=");         uart_putdec(res->p50);
+    uart_puts(" p99=");         uart_putdec(res->p99);
+    uart_puts(" max=");         uart_putdec(res->max);
+    uart_puts(" mean_ns=");     uart_putdec(res->mean_ns);
+    uart_puts("\n");
+
+    uart_puts("BENCH_HIST name="); uart_puts(name);
+    for (uint32_t k = 0; k < BENCH_HIST_BUCKETS; k++) {
+        if (!res->hist[k]) continue;
+        uart_puts(" ");
+        uart_putdec(k ? (1ull << k) : 0);
+        uart_puts("-");
+        uart_putdec((2ull << k) - 1);
+        uart_puts(":");
+        uart_putdec(res->hist[k]);
+    }
+    uart_puts("\n");
+}
+
+/******************************************************************************
+ * Function: bench_run_all
+ * Description: Run every registered benchmark in order and print the report.
+ *              Core 0, nothing else printing (output is not locked).
+ *****************************************************************************/
+void bench_run_all(void)
+{
+    bench_result_t res;
+    uint64_t freq;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+
+    uart_puts("BENCH_BEGIN cntfrq=");
+    uart_putdec(freq);
+    uart_puts(" count=");
+    uart_putdec(bench_count);
+    uart_puts("\n");
+
+    for (uint32_t i = 0; i < bench_count; i++) {
+        bench_run(&bench_table[i], &res);
+        bench_report(bench_table[i].name, &res);
+    }
+
+    uart_puts("BENCH_END\n");
+}
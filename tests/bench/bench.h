@@ -0,0 +1,109 @@
+/******************************************************************************
+ * File: bench.h
+ * Project: RPi5-Industrial-Gateway Bare Metal Development
+ * Description: On-target micro-benchmark harness
+ *
+ * A benchmark is a name plus a function that performs ONE iteration of the
+ * operation under test. The harness calls it 'iters' times, timing each
+ * call with PMCCNTR_EL0 (CPU cycles) and the whole run with cntpct_el0,
+ * then prints min / p50 / p99 / max, the mean in ns and a log2 histogram.
+ *
+ * Functions that measure something the harness cannot bracket (e.g. the
+ * time from raising an IRQ to its handler) return their own sample in
+ * cycles; return BENCH_SELF_TIMED (0) to let the harness time the call.
+ *
+ * Report (one record per line, key=value, grep '^BENCH'):
+ *   BENCH_BEGIN cntfrq=<hz> count=<n>
+ *   BENCH name=<s> iters=<n> min=<c> p50=<c> p99=<c> max=<c> mean_ns=<n>
+ *   BENCH_HIST name=<s> <lo>-<hi>:<count> ...       (cycles, non-empty only)
+ *   BENCH_END
+ *
+ * bench_crc_run() adds the CRC throughput report (BENCH_CRC_BEGIN ...
+ * BENCH_CRC_END, see bench_crc.c), bench_modbus_run() the Modbus RTU
+ * poll-rate report (BENCH_MODBUS_BEGIN ... BENCH_MODBUS_END, see
+ * bench_modbus.c), bench_mqtt_run() the MQTT encode report
+ * (BENCH_MQTT_BEGIN ... BENCH_MQTT_END, see bench_mqtt.c) and
+ * bench_scale_run() follows with the work-stealing scaling report
+ * (BENCH_SCALE_BEGIN ... BENCH_SCALE_END, see bench_scale.c).
+ *
+ * Built into the normal image for ad-hoc use, and into build/bench.elf by
+ * 'make bench', which boots straight into bench_run_all().
+ *
+ * Copyright (c) 2026 Maior Cristian
+ ******************************************************************************/
+#pragma once
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include <stdint.h>
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define BENCH_MAX            16     /* registered benchmarks              */
+#define BENCH_MAX_SAMPLES    512    /* per benchmark; iters is clamped    */
+#define BENCH_HIST_BUCKETS   32     /* log2 buckets: [2^k, 2^(k+1))       */
+#define BENCH_DEFAULT_ITERS  256
+#define BENCH_SELF_TIMED     0
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+/* One iteration. Returns BENCH_SELF_TIMED, or its own sample in cycles. */
+typedef uint64_t (*bench_fn_t)(void *ctx);
+
+typedef struct {
+    const char *name;
+    bench_fn_t  fn;
+    void       *ctx;
+    uint32_t    iters;
+} bench_t;
+
+typedef struct {
+    uint64_t min, p50, p99, max;
+    uint64_t mean_ns;
+    uint32_t iters;
+    uint32_t hist[BENCH_HIST_BUCKETS];
+} bench_result_t;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+static inline uint64_t bench_cycles(void)
+{
+    uint64_t v;
+    __asm__ volatile("isb; mrs %0, pmccntr_el0" : "=r"(v) :: "memory");
+    return v;
+}
+
+static inline uint64_t bench_ticks(void)
+{
+    uint64_t v;
+    __asm__ volatile("isb; mrs %0, cntpct_el0" : "=r"(v) :: "memory");
+    return v;
+}
+
+int  bench_register(const char *name, bench_fn_t fn, void *ctx, uint32_t iters);
+void bench_run(const bench_t *b, bench_result_t *res);
+void bench_report(const char *name, const bench_result_t *res);
+void bench_run_all(void);
+
+/* bench_suite.c — the stock benchmarks */
+void bench_register_defaults(void);
+void bench_mailbox_echo(void);      /* secondary core side of the round-trip */
+
+/* bench_crc.c — CRC bytes/cycle, every backend against the bitwise one */
+void bench_crc_run(void);
+
+/* bench_modbus.c — RTU master poll cycle against a simulated slave */
+void bench_modbus_run(void);
+
+/* bench_mqtt.c — MQTT PUBLISH encode, unbatched and batched */
+void bench_mqtt_run(void);
+
+/* bench_preempt.c — wake latency of a HIGH task over a spinning LOW one */
+void bench_preempt_run(uint32_t quantum_ms);
+
+/* bench_scale.c — 1..CORE_COUNT core scaling of migratable tasks */
+void bench_scale_run(void (*done)(void));
@@ -0,0 +1,137 @@
+/******************************************************************************
+ * File: bench_crc.c
+ * Project: RPi5-Industrial-Gateway Bare Metal Development
+ * Description: CRC throughput benchmark (bytes per cycle)
+ *
+ * Every CRC path in crc/crc.h runs over the same CRC_BENCH_BYTES buffer
+ * CRC_BENCH_ITERS times. The best PMCCNTR_EL0 sample is the figure, since
+ * the buffer is in L1 after the first pass. Each line also gives the
+ * speedup over the bitwise reference of the same CRC, and whether the
+ * result matches it.
+ *
+ * Report (grep '^BENCH_CRC'):
+ *   BENCH_CRC_BEGIN bytes=<n> iters=<n> hw=<0|1>
+ *   BENCH_CRC name=<s> cycles=<c> bytes_per_kcycle=<n> speedup_x100=<n> match=<0|1>
+ *   BENCH_CRC_END
+ *
+ * Copyright (c) 2026 Maior Cristian
+ ******************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "bench/bench.h"
+#include "crc/crc.h"
+#include "uart/uart0.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define CRC_BENCH_BYTES     4096
+#define CRC_BENCH_ITERS     32
+
+/*************************************************
+ *  TYPEDEF STRUCTS UNIONS ENUMS
+ ************************************************/
+typedef enum { CRC_BENCH_16, CRC_BENCH_32, CRC_BENCH_32C } crc_bench_algo_t;
+
+typedef struct {
+    const char       *name;
+    crc_bench_algo_t  algo;
+    int               backend;          /* -1: bitwise reference         */
+} crc_bench_t;
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+static uint8_t crc_bench_buf[CRC_BENCH_BYTES] __attribute__((aligned(64)));
+
+/* Each reference comes first: the lines after it are relative to it */
+static const crc_bench_t crc_benches[] = {
+    { "crc16_bitwise",  CRC_BENCH_16,  -1 },
+    { "crc16_slice8",   CRC_BENCH_16,  CRC_BACKEND_TABLE },
+    { "crc32_bitwise",  CRC_BENCH_32,  -1 },
+    { "crc32_slice8",   CRC_BENCH_32,  CRC_BACKEND_TABLE },
+    { "crc32_hw",       CRC_BENCH_32,  CRC_BACKEND_HW },
+    { "crc32c_bitwise", CRC_BENCH_32C, -1 },
+    { "crc32c_slice8",  CRC_BENCH_32C, CRC_BACKEND_TABLE },
+    { "crc32c_hw",      CRC_BENCH_32C, CRC_BACKEND_HW },
+};
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+static uint32_t crc_bench_once(const crc_bench_t *b)
+{
+    const uint8_t *p = crc_bench_buf;
+
+    switch (b->algo) {
+    case CRC_BENCH_16:
+        return b->backend < 0 ? crc16_modbus_bitwise(CRC16_MODBUS_INIT, p, CRC_BENCH_BYTES)
+                              : crc16_modbus_update(CRC16_MODBUS_INIT, p, CRC_BENCH_BYTES);
+    case CRC_BENCH_32:
+        return b->backend < 0 ? crc32_bitwise(CRC32_INIT, p, CRC_BENCH_BYTES)
+                              : crc32_update(CRC32_INIT, p, CRC_BENCH_BYTES);
+    default:
+        return b->backend < 0 ? crc32c_bitwise(CRC32_INIT, p, CRC_BENCH_BYTES)
+                              : crc32c_update(CRC32_INIT, p, CRC_BENCH_BYTES);
+    }
+}
+
+/******************************************************************************
+ * Function: bench_crc_run
+ * Description: Every path of crc/crc.h, skipping the CRC32-instruction ones
+ *              on a CPU without them. Restores the boot-selected backend.
+ *****************************************************************************/
+void bench_crc_run(void)
+{
+    int      saved = crc_get_backend();
+    int      hw    = crc_set_backend(CRC_BACKEND_HW) == 0;
+    uint64_t ref_cycles = 0;
+    uint32_t ref_crc    = 0;
+
+    for (uint32_t i = 0; i < CRC_BENCH_BYTES; i++) crc_bench_buf[i] = (uint8_t)(i * 131u + 17u);
+
+    uart_puts("BENCH_CRC_BEGIN bytes=");
+    uart_putdec(CRC_BENCH_BYTES);
+    uart_puts(" iters=");
+    uart_putdec(CRC_BENCH_ITERS);
+    uart_puts(" hw=");
+    uart_putdec(hw);
+    uart_puts("\n");
+
+    for (uint32_t n = 0; n < sizeof(crc_benches) / sizeof(crc_benches[0]); n++) {
+        const crc_bench_t *b = &crc_benches[n];
+        uint64_t best = UINT64_MAX;
+        uint32_t crc  = 0;
+
+        if (b->backend >= 0 && crc_set_backend(b->backend) != 0) continue;
+
+        for (uint32_t i = 0; i < CRC_BENCH_ITERS; i++) {
+            uint64_t t0 = bench_cycles();
+            crc = crc_bench_once(b);
+            uint64_t dt = bench_cycles() - t0;
+            if (dt < best) best = dt;
+        }
+        if (b->backend < 0) {
+            ref_cycles = best;
+            ref_crc    = crc;
+        }
+
+        uart_puts("BENCH_CRC name=");
+        uart_puts(b->name);
+        uart_puts(" cycles=");
+        uart_putdec(best);
+        uart_puts(" bytes_per_kcycle=");
+        uart_putdec(best ? (uint64_t)CRC_BENCH_BYTES * 1000 / best : 0);
+        uart_puts(" speedup_x100=");
+        uart_putdec(best ? ref_cycles * 100 / best : 0);
+        uart_puts(" match=");
+        uart_putdec(crc == ref_crc);
+        uart_puts("\n");
+    }
+
+    crc_set_backend(saved);
+    uart_puts("BENCH_CRC_END\n");
+}
@@ -0,0 +1,246 @@
+/******************************************************************************
+ * File: bench_modbus.c
+ * Project: RPi5-Industrial-Gateway Bare Metal Development
+ * Description: Sustained Modbus RTU poll-rate benchmark (simulated slave)
+ *
+ * The master engine talks to a slave that lives in this file: its port
+ * write() decodes the request ADU and builds the reply from a local
+ * register bank. Each poll is one full transaction on Core 0:
+ *
+ *   request -> slave reply -> modbus_rx_feed -> modbus_poll (t3.5 later)
+ *           -> modbus_frame_pop -> check the registers
+ *
+ * The line is simulated: the engine sees a clock that jumps to the next
+ * event, so the figure is the CPU cost of a poll cycle (master + slave),
+ * against the README's 10 kHz / 100 us target. wire_polls_per_s is what
+ * a real 115200 baud line allows for the same frames: both ADUs plus the
+ * two 1750 us t3.5 silences.
+ *
+ * Report (grep '^BENCH_MODBUS'):
+ *   BENCH_MODBUS_BEGIN polls=<n> regs=<n> baud=<n>
+ *   BENCH_MODBUS fc=<n> polls=<n> errors=<n> ticks=<n> cycle_ns=<n>
+ *                polls_per_s=<n> target_hz=<n> wire_polls_per_s=<n>
+ *   BENCH_MODBUS_END
+ *
+ * Copyright (c) 2026 Maior Cristian
+ ******************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "bench/bench.h"
+#include "modbus/modbus_rtu.h"
+#include "uart/uart0.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define MB_BENCH_POLLS      2000    /* transactions per function code      */
+#define MB_BENCH_REGS       10      /* registers per read / multiple write */
+#define MB_BENCH_SLAVE      17
+#define MB_BENCH_BAUD       115200
+#define MB_BENCH_TARGET_HZ  10000   /* README: 100 us poll cycle           */
+#define MB_SLAVE_REGS       256
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+static modbus_master_t mb_master;
+
+static struct {
+    uint16_t holding[MB_SLAVE_REGS];
+    uint8_t  reply[MODBUS_ADU_MAX];
+    uint32_t reply_len;
+} mb_slave;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+static inline uint16_t mb_input_value(uint32_t addr)
+{
+    return (uint16_t)((addr * 0x0101u) ^ 0x5A5Au);
+}
+
+static void mb_reply_crc(void)
+{
+    uint16_t crc = modbus_crc16(mb_slave.reply, mb_slave.reply_len);
+    mb_slave.reply[mb_slave.reply_len++] = (uint8_t)crc;
+    mb_slave.reply[mb_slave.reply_len++] = (uint8_t)(crc >> 8);
+}
+
+/******************************************************************************
+ * Function: mb_slave_write
+ * Description: The simulated slave's side of the line: check the request
+ *              and build the reply into mb_slave.reply. Addresses wrap at
+ *              MB_SLAVE_REGS.
+ * Returns: 0 (the transport accepted the ADU)
+ *****************************************************************************/
+static int mb_slave_write(void *ctx, const uint8_t *req, uint32_t len)
+{
+    uint8_t *r = mb_slave.reply;
+    (void)ctx;
+
+    mb_slave.reply_len = 0;
+    if (len < 8 || modbus_crc16(req, len - 2) != (uint16_t)(req[len - 2] | (req[len - 1] << 8))) {
+        return 0;                               /* a slave stays silent */
+    }
+
+    uint16_t addr = (uint16_t)((req[2] << 8) | req[3]);
+    uint16_t arg  = (uint16_t)((req[4] << 8) | req[5]);
+
+    r[0] = req[0];
+    r[1] = req[1];
+    switch (req[1]) {
+    case MODBUS_FC_READ_HOLDING:
+    case MODBUS_FC_READ_INPUT:
+        r[2] = (uint8_t)(arg * 2);
+        for (uint32_t i = 0; i < arg; i++) {
+            uint32_t a = (addr + i) % MB_SLAVE_REGS;
+            uint16_t v = req[1] == MODBUS_FC_READ_INPUT ? mb_input_value(a)
+                                                        : mb_slave.holding[a];
+            r[3 + 2 * i] = (uint8_t)(v >> 8);
+            r[4 + 2 * i] = (uint8_t)v;
+        }
+        mb_slave.reply_len = 3 + 2 * arg;
+        break;
+
+    case MODBUS_FC_WRITE_SINGLE:
+        mb_slave.holding[addr % MB_SLAVE_REGS] = arg;
+        for (uint32_t i = 2; i < 6; i++) r[i] = req[i];
+        mb_slave.reply_len = 6;
+        break;
+
+    case MODBUS_FC_WRITE_MULTIPLE:
+        for (uint32_t i = 0; i < arg; i++) {
+            mb_slave.holding[(addr + i) % MB_SLAVE_REGS] =
+                (uint16_t)((req[7 + 2 * i] << 8) | req[8 + 2 * i]);
+        }
+        for (uint32_t i = 2; i < 6; i++) r[i] = req[i];
+        mb_slave.reply_len = 6;
+        break;
+
+    default:
+        r[1] = (uint8_t)(req[1] | MODBUS_EXCEPTION);
+        r[2] = 0x01;                            /* illegal function */
+        mb_slave.reply_len = 3;
+        break;
+    }
+    mb_reply_crc();
+    return 0;
+}
+
+/* One transaction of function code 'fc', poll number 'i', at sim time *t */
+static int mb_poll_once(uint8_t fc, uint32_t i, uint64_t *t)
+{
+    modbus_master_t *m = &mb_master;
+    modbus_frame_t   f;
+    uint16_t         addr = (uint16_t)((i * MB_BENCH_REGS) % MB_SLAVE_REGS);
+    uint16_t         vals[MB_BENCH_REGS];
+    int              rc;
+
+    switch (fc) {
+    case MODBUS_FC_WRITE_SINGLE:
+        rc = modbus_write_register(m, MB_BENCH_SLAVE, addr, (uint16_t)i, *t);
+        break;
+    case MODBUS_FC_WRITE_MULTIPLE:
+        for (uint32_t k = 0; k < MB_BENCH_REGS; k++) vals[k] = (uint16_t)(i + k);
+        rc = modbus_write_registers(m, MB_BENCH_SLAVE, addr, MB_BENCH_REGS, vals, *t);
+        break;
+    default:
+        rc = modbus_read_registers(m, MB_BENCH_SLAVE, fc, addr, MB_BENCH_REGS, *t);
+        break;
+    }
+    if (rc != 0) return -1;
+
+    /* Reply arrives one tick later, the frame closes t3.5 after it */
+    *t += 1;
+    modbus_rx_feed(m, mb_slave.reply, mb_slave.reply_len, *t);
+    *t += m->t35;
+    if (!modbus_poll(m, *t) || modbus_frame_pop(m, &f) != 0) return -1;
+    if (f.status != MODBUS_OK) return -1;
+
+    if (fc == MODBUS_FC_READ_HOLDING || fc == MODBUS_FC_READ_INPUT) {
+        for (uint32_t k = 0; k < MB_BENCH_REGS; k++) {
+            uint32_t a = (addr + k) % MB_SLAVE_REGS;
+            uint16_t want = fc == MODBUS_FC_READ_INPUT ? mb_input_value(a)
+                                                       : mb_slave.holding[a];
+            if (f.regs[k] != want) return -1;
+        }
+    }
+    return 0;
+}
+
+/* Request and reply ADU sizes of one benchmark poll */
+static uint32_t mb_wire_bytes(uint8_t fc)
+{
+    switch (fc) {
+    case MODBUS_FC_WRITE_SINGLE:   return 8 + 8;
+    case MODBUS_FC_WRITE_MULTIPLE: return (9 + 2 * MB_BENCH_REGS) + 8;
+    default:                       return 8 + (5 + 2 * MB_BENCH_REGS);
+    }
+}
+
+/******************************************************************************
+ * Function: bench_modbus_run
+ * Description: MB_BENCH_POLLS transactions per function code (3, 4, 6, 16)
+ *              against the simulated slave, on the calling core.
+ *****************************************************************************/
+void bench_modbus_run(void)
+{
+    static const uint8_t fcs[] = {
+        MODBUS_FC_READ_HOLDING, MODBUS_FC_READ_INPUT,
+        MODBUS_FC_WRITE_SINGLE, MODBUS_FC_WRITE_MULTIPLE
+    };
+    modbus_port_t port = { mb_slave_write, 0, MB_BENCH_BAUD };
+    uint64_t freq, t = 0;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+
+    for (uint32_t a = 0; a < MB_SLAVE_REGS; a++) mb_slave.holding[a] = (uint16_t)(a * 7);
+
+    if (modbus_master_init(&mb_master, &port) != 0) {
+        uart_puts("BENCH_MODBUS_ERROR init failed\n");
+        return;
+    }
+
+    uart_puts("BENCH_MODBUS_BEGIN polls=");
+    uart_putdec(MB_BENCH_POLLS);
+    uart_puts(" regs=");
+    uart_putdec(MB_BENCH_REGS);
+    uart_puts(" baud=");
+    uart_putdec(MB_BENCH_BAUD);
+    uart_puts("\n");
+
+    for (uint32_t n = 0; n < sizeof(fcs); n++) {
+        uint32_t errors = 0;
+        uint64_t start  = bench_ticks();
+        for (uint32_t i = 0; i < MB_BENCH_POLLS; i++) {
+            if (mb_poll_once(fcs[n], i, &t) != 0) errors++;
+        }
+        uint64_t ticks = bench_ticks() - start;
+
+        /* us per poll on the wire: both ADUs + two t3.5 silences */
+        uint64_t wire_us = (uint64_t)mb_wire_bytes(fcs[n]) * MODBUS_CHAR_BITS * 1000000u
+                           / MB_BENCH_BAUD + 2 * MODBUS_T35_FIXED_US;
+
+        uart_puts("BENCH_MODBUS fc=");
+        uart_putdec(fcs[n]);
+        uart_puts(" polls=");
+        uart_putdec(MB_BENCH_POLLS);
+        uart_puts(" errors=");
+        uart_putdec(errors);
+        uart_puts(" ticks=");
+        uart_putdec(ticks);
+        uart_puts(" cycle_ns=");
+        uart_putdec(ticks * 1000000000ull / freq / MB_BENCH_POLLS);
+        uart_puts(" polls_per_s=");
+        uart_putdec(ticks ? (uint64_t)MB_BENCH_POLLS * freq / ticks : 0);
+        uart_puts(" target_hz=");
+        uart_putdec(MB_BENCH_TARGET_HZ);
+        uart_puts(" wire_polls_per_s=");
+        uart_putdec(1000000u / wire_us);
+        uart_puts("\n");
+    }
+
+    uart_puts("BENCH_MODBUS_END\n");
+}
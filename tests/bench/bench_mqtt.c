@@ -0,0 +1,188 @@
+/******************************************************************************
+ * File: bench_mqtt.c
+ * Project: RPi5-Industrial-Gateway Bare Metal Development
+ * Description: MQTT PUBLISH encode throughput (packets per second)
+ *
+ * MQTT_BENCH_PACKETS sensor records are published through an mqtt_writer_t
+ * whose transport is a sink: writev() gathers the segments into one flat
+ * buffer, the single copy a real transport (UART ring, DMA) also makes.
+ * The payload is two segments, a fixed JSON prefix and the per-record
+ * value, as a Modbus-to-JSON publisher would build it. Each packet of a
+ * batch has its own value buffer, since the batch references them until
+ * it is flushed; the sink checks the first and last value of every batch.
+ *
+ * Each configuration runs once with a flush after every packet (batch=1)
+ * and once with full batches (batch=MQTT_BATCH_PACKETS). The pair separates
+ * the encoder's per-packet cost from the per-writev() cost; this sink has
+ * almost none, a transport with a per-call cost (a lock, a DMA kick) pays
+ * it once per batch. The UART itself is not measured: at 115200 baud it
+ * carries well under 1000 of these packets per second.
+ *
+ * Report (grep '^BENCH_MQTT'):
+ *   BENCH_MQTT_BEGIN packets=<n> payload=<n> topic=<s>
+ *   BENCH_MQTT qos=<n> batch=<n> packets=<n> writev=<n> bytes=<n> ticks=<n>
+ *              ns_per_packet=<n> packets_per_s=<n> errors=<n>
+ *   BENCH_MQTT_END
+ *
+ * Copyright (c) 2026 Maior Cristian
+ ******************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "bench/bench.h"
+#include "mqtt/mqtt.h"
+#include "uart/uart0.h"
+#include "libc/mem.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define MQTT_BENCH_PACKETS  20000
+#define MQTT_BENCH_TOPIC    "gw/modbus/17/hr/40001"
+#define MQTT_BENCH_SINK     4096            /* > one full batch           */
+#define MQTT_BENCH_IOVS     3               /* header, prefix, value      */
+#define MQTT_BENCH_DIGITS   5
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+static mqtt_writer_t mqtt_bench_w;
+
+static struct {
+    uint8_t  buf[MQTT_BENCH_SINK];
+    uint64_t bytes;
+    uint32_t calls;
+    uint32_t packets;                       /* index of the next packet   */
+    uint32_t bad;                           /* batches with a wrong value */
+} mqtt_sink;
+
+static const uint8_t mqtt_bench_prefix[] = "{\"slave\":17,\"fc\":3,\"addr\":40001,\"value\":";
+/* One value buffer per batch slot: queued packets still point at theirs */
+static uint8_t       mqtt_bench_value[MQTT_BATCH_PACKETS][8];
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+/* The value digits at 'p' against packet number 'v' */
+static int mqtt_bench_value_ok(const uint8_t *p, uint32_t v)
+{
+    for (int i = MQTT_BENCH_DIGITS - 1; i >= 0; i--) {
+        if (p[i] != (uint8_t)('0' + v % 10)) return 0;
+        v /= 10;
+    }
+    return 1;
+}
+
+/*
+ * Gather the batch into buf[], then check what went out: the value of the
+ * first packet (right after its header and prefix) and of the last one
+ * (the final segment) must be their own packet numbers.
+ */
+static int mqtt_sink_writev(void *ctx, const mqtt_iov_t *iov, uint32_t n)
+{
+    uint32_t off = 0;
+    (void)ctx;
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (iov[i].len > MQTT_BENCH_SINK - off) return -1;
+        memcpy(&mqtt_sink.buf[off], iov[i].base, iov[i].len);
+        off += iov[i].len;
+    }
+
+    uint32_t packets = n / MQTT_BENCH_IOVS;
+    uint32_t last    = off - iov[n - 1].len;
+    if (!mqtt_bench_value_ok(&mqtt_sink.buf[iov[0].len + iov[1].len], mqtt_sink.packets) ||
+        !mqtt_bench_value_ok(&mqtt_sink.buf[last], mqtt_sink.packets + packets - 1)) {
+        mqtt_sink.bad++;
+    }
+
+    mqtt_sink.packets += packets;
+    mqtt_sink.bytes   += off;
+    mqtt_sink.calls++;
+    return 0;
+}
+
+/* "12345}" style value in batch slot 'slot', fixed width */
+static uint8_t *mqtt_bench_set_value(uint32_t slot, uint32_t v)
+{
+    uint8_t *p = mqtt_bench_value[slot];
+
+    for (int i = MQTT_BENCH_DIGITS - 1; i >= 0; i--) {
+        p[i] = (uint8_t)('0' + v % 10);
+        v /= 10;
+    }
+    p[MQTT_BENCH_DIGITS] = '}';
+    return p;
+}
+
+/******************************************************************************
+ * Function: bench_mqtt_run
+ * Description: QoS 0 and QoS 1, each unbatched and batched, into the sink
+ *****************************************************************************/
+void bench_mqtt_run(void)
+{
+    static const mqtt_transport_t sink = { mqtt_sink_writev, 0 };
+    static const uint8_t qos[] = { MQTT_QOS0, MQTT_QOS1 };
+    mqtt_writer_t *w = &mqtt_bench_w;
+    mqtt_iov_t payload[2] = {
+        { mqtt_bench_prefix, sizeof(mqtt_bench_prefix) - 1 },
+        { 0,                 MQTT_BENCH_DIGITS + 1 },
+    };
+    uint64_t freq;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+
+    uart_puts("BENCH_MQTT_BEGIN packets=");
+    uart_putdec(MQTT_BENCH_PACKETS);
+    uart_puts(" payload=");
+    uart_putdec(payload[0].len + payload[1].len);
+    uart_puts(" topic=" MQTT_BENCH_TOPIC "\n");
+
+    for (uint32_t q = 0; q < sizeof(qos); q++) {
+        for (uint32_t batch = 1; batch <= MQTT_BATCH_PACKETS; batch *= MQTT_BATCH_PACKETS) {
+            uint32_t errors = 0;
+
+            mqtt_writer_init(w, &sink);
+            mqtt_sink.bytes   = 0;
+            mqtt_sink.calls   = 0;
+            mqtt_sink.packets = 0;
+            mqtt_sink.bad     = 0;
+
+            /* Flush before a slot is reused, not from inside mqtt_publish() */
+            uint64_t start = bench_ticks();
+            for (uint32_t i = 0; i < MQTT_BENCH_PACKETS; i++) {
+                if (mqtt_batch_packets(w) == batch && mqtt_flush(w) != 0) errors++;
+                payload[1].base = mqtt_bench_set_value(i % MQTT_BATCH_PACKETS, i);
+                if (mqtt_publish(w, MQTT_BENCH_TOPIC, qos[q], payload, 2) < 0) errors++;
+            }
+            if (mqtt_flush(w) != 0) errors++;
+            uint64_t ticks = bench_ticks() - start;
+
+            errors += mqtt_sink.bad;
+            if (w->stats.packets != MQTT_BENCH_PACKETS || w->stats.bytes != mqtt_sink.bytes) errors++;
+
+            uart_puts("BENCH_MQTT qos=");
+            uart_putdec(qos[q] >> 1);
+            uart_puts(" batch=");
+            uart_putdec(batch);
+            uart_puts(" packets=");
+            uart_putdec(w->stats.packets);
+            uart_puts(" writev=");
+            uart_putdec(mqtt_sink.calls);
+            uart_puts(" bytes=");
+            uart_putdec(mqtt_sink.bytes);
+            uart_puts(" ticks=");
+            uart_putdec(ticks);
+            uart_puts(" ns_per_packet=");
+            uart_putdec(ticks * 1000000000ull / freq / MQTT_BENCH_PACKETS);
+            uart_puts(" packets_per_s=");
+            uart_putdec(ticks ? (uint64_t)MQTT_BENCH_PACKETS * freq / ticks : 0);
+            uart_puts(" errors=");
+            uart_putdec(errors);
+            uart_puts("\n");
+        }
+    }
+
+    uart_puts("BENCH_MQTT_END\n");
+}
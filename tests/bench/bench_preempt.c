@@ -0,0 +1,145 @@
+/******************************************************************************
+ * File: bench_preempt.c
+ * Project: RPi5-Industrial-Gateway Bare Metal Development
+ * Description: Preemption wake-latency benchmark
+ *
+ * A LOW task pinned to the calling core spins without ever yielding. The
+ * calling task (pinned, above TASK_PRIO_LOW) sleeps PREEMPT_SLEEP_MS and
+ * wakes PREEMPT_SAMPLES times. Each wake can only reach it through the
+ * timer IRQ and the switch in sched_irq_exit(), so every sample is a
+ * preemption of the spinner. The latency of a sample is the time from
+ * the requested deadline to the first instruction after task_sleep_ms().
+ * The worst case must stay within one quantum plus one wheel jiffy (the
+ * sleep is rounded up to a jiffy); anything longer means the wake waited
+ * for the spinner's slice to run out, or never came.
+ *
+ * Report (grep '^BENCH_PREEMPT'):
+ *   BENCH_PREEMPT samples=<n> sleep_ms=<n> max_ticks=<n> avg_ticks=<n>
+ *                 max_ns=<n> bound_ticks=<n> preemptions=<n> spins=<n>
+ *   BENCH_PREEMPT_ERROR <why>
+ *
+ * Copyright (c) 2026 Maior Cristian
+ ******************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "bench/bench.h"
+#include "scheduler/scheduler.h"
+#include "timer/timer_wheel.h"
+#include "ipc/atomic.h"
+#include "uart/uart0.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define PREEMPT_SAMPLES     64
+#define PREEMPT_SLEEP_MS    1
+#define PREEMPT_SPINNER_ID  0x5D0
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+static volatile uint32_t preempt_stop;
+static volatile uint32_t preempt_live;
+static volatile uint64_t preempt_spins;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+/******************************************************************************
+ * Function: preempt_spinner
+ * Description: CPU-bound LOW task with no task_yield() and no sleep. Only
+ *              the timer IRQ can take the core away from it.
+ *****************************************************************************/
+static void preempt_spinner(void)
+{
+    atomic_store_release32(&preempt_live, 1);
+    while (!atomic_load_acquire32(&preempt_stop)) {
+        preempt_spins++;
+    }
+    atomic_store_release32(&preempt_live, 0);
+}
+
+static void preempt_error(const char *why)
+{
+    uart_puts("BENCH_PREEMPT_ERROR ");
+    uart_puts(why);
+    uart_puts("\n");
+}
+
+/******************************************************************************
+ * Function: bench_preempt_run
+ * Description: Runs the wake-latency samples against a spinner on the
+ *              calling core and reports them. Call from a pinned task above
+ *              TASK_PRIO_LOW on a core with sched_preempt_enable() on.
+ *              Leaves one dead pinned slot behind (the spinner).
+ * Parameters: quantum_ms - the slice passed to sched_preempt_enable()
+ *****************************************************************************/
+void bench_preempt_run(uint32_t quantum_ms)
+{
+    uint64_t core, freq;
+    __asm__ volatile("mrs %0, mpidr_el1" : "=r"(core));
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+    core &= 0xFF;
+
+    uint64_t sleep_ticks = (uint64_t)PREEMPT_SLEEP_MS * freq / 1000;
+    uint64_t bound       = (uint64_t)(quantum_ms ? quantum_ms : SCHED_QUANTUM_MS) *
+                           freq / 1000 + freq / TIMER_WHEEL_HZ;
+
+    preempt_stop  = 0;
+    preempt_live  = 0;
+    preempt_spins = 0;
+
+    jobContext_t job = { PREEMPT_SPINNER_ID, 0, "preempt_spin", preempt_spinner,
+                         TASK_PRIO_LOW, TASK_AFFINITY_PINNED };
+    if (sched_add_task(&job) < 0) {
+        preempt_error("no task slot for the spinner");
+        return;
+    }
+
+    /* first sleep hands the core to the spinner */
+    while (!atomic_load_acquire32(&preempt_live)) task_sleep_ms(PREEMPT_SLEEP_MS);
+
+    uint64_t preempts = sched_preempt_count((uint32_t)core);
+    uint64_t worst = 0, sum = 0;
+
+    for (uint32_t i = 0; i < PREEMPT_SAMPLES; i++) {
+        uint64_t deadline = bench_ticks() + sleep_ticks;
+        task_sleep_ms(PREEMPT_SLEEP_MS);
+        uint64_t now = bench_ticks();
+        uint64_t lat = (now > deadline) ? now - deadline : 0;
+
+        sum += lat;
+        if (lat > worst) worst = lat;
+    }
+
+    preempts = sched_preempt_count((uint32_t)core) - preempts;
+    uint64_t spins = preempt_spins;
+
+    atomic_store_release32(&preempt_stop, 1);
+    while (atomic_load_acquire32(&preempt_live)) task_sleep_ms(PREEMPT_SLEEP_MS);
+
+    uart_puts("BENCH_PREEMPT samples=");
+    uart_putdec(PREEMPT_SAMPLES);
+    uart_puts(" sleep_ms=");
+    uart_putdec(PREEMPT_SLEEP_MS);
+    uart_puts(" max_ticks=");
+    uart_putdec(worst);
+    uart_puts(" avg_ticks=");
+    uart_putdec(sum / PREEMPT_SAMPLES);
+    uart_puts(" max_ns=");
+    uart_putdec(worst * 1000000000ull / freq);
+    uart_puts(" bound_ticks=");
+    uart_putdec(bound);
+    uart_puts(" preemptions=");
+    uart_putdec(preempts);
+    uart_puts(" spins=");
+    uart_putdec(spins);
+    uart_puts("\n");
+
+    if (worst > bound)              preempt_error("wake later than one quantum");
+    if (preempts < PREEMPT_SAMPLES) preempt_error("a wake did not preempt the spinner");
+    if (spins == 0)                 preempt_error("spinner never ran");
+}
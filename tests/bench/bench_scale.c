@@ -0,0 +1,196 @@
+/******************************************************************************
+ * File: bench_scale.c
+ * Project: RPi5-Industrial-Gateway Bare Metal Development
+ * Description: Work-stealing scaling benchmark (1 -> CORE_COUNT cores)
+ *
+ * A pinned driver task on Core 0 runs SCALE_TASKS migratable CPU-bound
+ * workers once per core count k. Each worker's affinity is cores 0..k-1.
+ * Every worker does SCALE_UNITS units of xorshift work and yields after
+ * each unit. All workers start on Core 0's steal queue; Cores 1..k-1 sit
+ * in their idle loops and steal them. The time from 'go' to the latest
+ * worker finish time gives throughput and speedup over k = 1. The final
+ * xorshift state of each worker must be identical in every round, which
+ * checks that a task's registers and stack survive migration. Before the
+ * first round the driver runs the preemption latency check
+ * (bench_preempt.c) on Core 0.
+ *
+ * Report (grep '^BENCH_SCALE'):
+ *   BENCH_SCALE_BEGIN tasks=<n> units=<n> iters=<n>
+ *   BENCH_SCALE cores=<k> ticks=<n> units_per_s=<n> speedup_x100=<n> steals=<n>
+ *   BENCH_SCALE_END
+ *
+ * Copyright (c) 2026 Maior Cristian
+ ******************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "bench/bench.h"
+#include "scheduler/scheduler.h"
+#include "ipc/atomic.h"
+#include "uart/uart0.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define SCALE_TASKS         12      /* divides evenly over 1, 2, 3, 4 cores */
+#define SCALE_UNITS         64      /* task_yield() points per worker       */
+#define SCALE_UNIT_ITERS    20000   /* xorshift64 steps per unit            */
+#define SCALE_DRIVER_ID     0x5C0
+#define SCALE_WORKER_ID     0x5C1
+
+_Static_assert(SCALE_TASKS <= SCHED_MIG_TASKS, "one pool slot per worker");
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+static volatile uint32_t scale_go;
+static volatile uint32_t scale_left;
+static volatile uint32_t scale_ticket;
+static uint64_t          scale_finish[SCALE_TASKS];     /* cntpct at the end */
+static uint64_t          scale_result[SCALE_TASKS];
+static uint64_t          scale_ref[SCALE_TASKS];
+static void            (*scale_done)(void);
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+static uint64_t scale_steals(void)
+{
+    uint64_t n = 0;
+    for (uint32_t c = 0; c < CORE_COUNT; c++) n += sched_steal_count(c);
+    return n;
+}
+
+/******************************************************************************
+ * Function: scale_worker
+ * Description: One migratable worker. Waits for 'go', burns SCALE_UNITS
+ *              units, then publishes its state and finish time with the
+ *              release of the scale_left decrement. Returning ends the
+ *              task (task_exit).
+ *****************************************************************************/
+static void scale_worker(void)
+{
+    uint32_t idx = atomic_fetch_add32(&scale_ticket, 1);
+    uint64_t x   = 0x9E3779B97F4A7C15ull ^ idx;
+
+    while (!atomic_load_acquire32(&scale_go)) {
+        __asm__ volatile("wfe");
+    }
+
+    for (uint32_t u = 0; u < SCALE_UNITS; u++) {
+        for (uint32_t i = 0; i < SCALE_UNIT_ITERS; i++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+        task_yield();                       /* a point where we may move */
+    }
+
+    scale_result[idx] = x;
+    scale_finish[idx] = bench_ticks();
+    atomic_fetch_add32(&scale_left, (uint32_t)-1);
+}
+
+static void scale_report(uint32_t cores, uint64_t ticks, uint64_t base,
+                         uint64_t freq, uint64_t steals)
+{
+    uint64_t units = (uint64_t)SCALE_TASKS * SCALE_UNITS;
+
+    uart_puts("BENCH_SCALE cores=");
+    uart_putdec(cores);
+    uart_puts(" ticks=");
+    uart_putdec(ticks);
+    uart_puts(" units_per_s=");
+    uart_putdec(ticks ? units * freq / ticks : 0);
+    uart_puts(" speedup_x100=");
+    uart_putdec(ticks ? base * 100 / ticks : 0);
+    uart_puts(" steals=");
+    uart_putdec(steals);
+    uart_puts("\n");
+}
+
+/******************************************************************************
+ * Function: scale_driver
+ * Description: Pinned to Core 0 above SCHED_MIG_PRIO. Sleeps while the
+ *              workers run, so Core 0 computes its share too.
+ *****************************************************************************/
+static void scale_driver(void)
+{
+    uint64_t freq, base = 0;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+
+    bench_preempt_run(SCHED_QUANTUM_MS);
+
+    uart_puts("BENCH_SCALE_BEGIN tasks=");
+    uart_putdec(SCALE_TASKS);
+    uart_puts(" units=");
+    uart_putdec(SCALE_UNITS);
+    uart_puts(" iters=");
+    uart_putdec(SCALE_UNIT_ITERS);
+    uart_puts("\n");
+
+    for (uint32_t k = 1; k <= CORE_COUNT; k++) {
+        while (sched_mig_live()) task_sleep_ms(1);  /* last round's slots */
+
+        scale_ticket = 0;
+        scale_left   = SCALE_TASKS;
+        atomic_store_release32(&scale_go, 0);
+
+        for (uint32_t i = 0; i < SCALE_TASKS; i++) {
+            jobContext_t job = { SCALE_WORKER_ID, 0, "scale_worker", scale_worker,
+                                 TASK_PRIO_LOW, (uint8_t)((1u << k) - 1) };
+            sched_add_task(&job);
+        }
+
+        uint64_t steals = scale_steals();
+        uint64_t start  = bench_ticks();
+        atomic_store_release32(&scale_go, 1);
+        __asm__ volatile("sev" ::: "memory");
+
+        while (atomic_load_acquire32(&scale_left)) task_sleep_ms(1);
+
+        uint64_t end = start;
+        for (uint32_t i = 0; i < SCALE_TASKS; i++) {
+            if (scale_finish[i] > end) end = scale_finish[i];
+        }
+        uint64_t ticks = end - start;
+        if (k == 1) base = ticks;
+        scale_report(k, ticks, base, freq, scale_steals() - steals);
+
+        for (uint32_t i = 0; i < SCALE_TASKS; i++) {
+            if (k == 1) {
+                scale_ref[i] = scale_result[i];
+            } else if (scale_result[i] != scale_ref[i]) {
+                uart_puts("BENCH_SCALE_ERROR cores=");
+                uart_putdec(k);
+                uart_puts(" worker state differs after migration\n");
+                break;
+            }
+        }
+    }
+
+    uart_puts("BENCH_SCALE_END\n");
+    if (scale_done) scale_done();
+    task_exit();
+}
+
+/******************************************************************************
+ * Function: bench_scale_run
+ * Description: Core 0 becomes a preemptive scheduler running the scaling
+ *              driver. Cores 1..CORE_COUNT-1 must be in sched_run() with no
+ *              pinned tasks. Needs irq_init() (scheduler tick).
+ * Parameters: done - called by the driver after BENCH_SCALE_END (may be 0)
+ * Returns: never
+ *****************************************************************************/
+void bench_scale_run(void (*done)(void))
+{
+    jobContext_t driver = { SCALE_DRIVER_ID, 0, "scale_driver", scale_driver,
+                            TASK_PRIO_HIGH, TASK_AFFINITY_PINNED };
+
+    scale_done = done;
+    sched_add_task(&driver);
+    sched_preempt_enable(SCHED_QUANTUM_MS);
+    sched_run();
+}
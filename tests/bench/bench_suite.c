@@ -0,0 +1,299 @@
+/******************************************************************************
+ * File: bench_suite.c
+ * Project: RPi5-Industrial-Gateway Bare Metal Development
+ * Description: Stock benchmarks registered by bench_register_defaults()
+ *
+ *   ring_put_get     ring_buffer_put + ring_buffer_get, one byte
+ *   mailbox_rtt      Core 0 -> Core 1 -> Core 0, HMAC on both legs
+ *                    (Core 1 must be running bench_mailbox_echo)
+ *   mailbox_rtt_buf  same with a BENCH_BUF_BYTES pool buffer passed by
+ *                    handle both ways (HMAC over the payload, no copy)
+ *   ctx_switch_pair  sched_context_switch there and back (2 switches)
+ *   hmac_tag         hmac_tag_compute over one mailbox_msg_t
+ *   irq_entry        SGI raised on self -> first line of the C handler
+ *                    (full path: whole frame + irq_dispatch)
+ *   irq_entry_fast   same on the lean path (caller-saved regs only,
+ *                    handler called from the vector via irq_fast_table)
+ *   irq_entry_fiq    same with the SGI as the Group 0 FIQ source
+ *                    (only where irq_set_fiq() succeeds, e.g. QEMU virt)
+ *   slab_alloc_free  slab_alloc + slab_free on slab_msg_small, own core
+ *   timer_arm_cancel timer_arm + timer_cancel of one timer while
+ *                    BENCH_TIMERS periodic timers are armed on the wheel
+ *   timer_expire     timer_run over 1 ms of simulated time with those
+ *                    BENCH_TIMERS armed; sample = cycles per expired timer
+ *                    (cascades included, each one re-arms itself). Steps
+ *                    that expire nothing are skipped, not sampled
+ *
+ * Copyright (c) 2026 Maior Cristian
+ ******************************************************************************/
+
+/**************************************************
+ * INCLUDE FILES
+ ***************************************************/
+#include "bench/bench.h"
+#include "ringbuffer/ringbuf.h"
+#include "ipc/ipc.h"
+#include "crypto/hmac_sha256.h"
+#include "scheduler/scheduler.h"
+#include "interrupts/irq.h"
+#include "alloc/slab.h"
+#include "alloc/arena.h"
+#include "timer/timer_wheel.h"
+
+/**************************************************
+ * MACRO DEFINTIONS
+ ***************************************************/
+#define BENCH_ECHO_CORE     1
+#define BENCH_SGI_ID        1u      /* SGIs 1-3: private to the bench suite */
+#define BENCH_SGI_FAST      2u
+#define BENCH_SGI_FIQ       3u
+#define BENCH_BUF_BYTES     256     /* mailbox_rtt_buf payload            */
+#define BENCH_TIMERS        10000   /* armed while timer_* are measured   */
+#define BENCH_TIMER_MIN_US  1000    /* periods spread over 1 ms .. ~1 s   */
+#define BENCH_TIMER_SPAN_US 1000000
+
+/**************************************************
+ * GLOBAL VARIABLES
+ ***************************************************/
+static ring_buffer_t     bench_ring;
+static mailbox_msg_t     bench_msg;
+static tcb_t             bench_tcb_main;
+static tcb_t             bench_tcb_peer;
+static task_stack_t      bench_peer_stack TASK_STACK_SECTION;
+static volatile uint64_t irq_entry_stamp;
+static sw_timer_t       *bench_timers;          /* BENCH_TIMERS, from the arena */
+static sw_timer_t        bench_probe;
+static uint64_t          bench_timer_clock;     /* simulated cntpct             */
+static uint64_t          bench_timer_step;      /* 1 ms of cntpct               */
+static uint64_t          bench_rng = 0x9E3779B97F4A7C15ull;
+
+/**************************************************
+ * HELPER FUNCTIONS
+ ***************************************************/
+
+static uint64_t bench_ring_put_get(void *ctx)
+{
+    unsigned char c;
+    (void)ctx;
+    ring_buffer_put(&bench_ring, 0x5A);
+    ring_buffer_get(&bench_ring, &c);
+    return BENCH_SELF_TIMED;
+}
+
+static uint64_t bench_mailbox_rtt(void *ctx)
+{
+    unsigned int sender, type, data;
+    (void)ctx;
+
+    mailbox_send(BENCH_ECHO_CORE, MSG_PING, 0xBE4C);
+    while (mailbox_receive(0, &sender, &type, &data) == 0) {
+        /* spin — WFE would add the wake-up latency of the idle core */
+    }
+    return BENCH_SELF_TIMED;
+}
+
+static uint64_t bench_mailbox_rtt_buf(void *ctx)
+{
+    mailbox_msg_t msg;
+    uint32_t handle;
+    (void)ctx;
+
+    if (!mailbox_buf_alloc(BENCH_BUF_BYTES, &handle)) return BENCH_SELF_TIMED;
+    mailbox_send_buf(BENCH_ECHO_CORE, MSG_DATA, 0xB0F, handle, 0, BENCH_BUF_BYTES);
+    while (mailbox_receive_msg(0, &msg) == 0) {
+        /* spin */
+    }
+    mailbox_release(&msg);                  /* the echo handed it back */
+    return BENCH_SELF_TIMED;
+}
+
+/******************************************************************************
+ * Function: bench_mailbox_echo
+ * Description: Runs on BENCH_ECHO_CORE in bench builds: bounce every message
+ *              back to its sender as MSG_ACK, passing an attached buffer
+ *              back with it. Returns on MSG_SHUTDOWN, so the core can join
+ *              the scaling benchmark (bench_scale.c).
+ *****************************************************************************/
+void bench_mailbox_echo(void)
+{
+    mailbox_msg_t msg;
+    unsigned long cpu;
+    __asm__ volatile("mrs %0, mpidr_el1" : "=r"(cpu));
+    cpu &= 0xFF;
+
+    while (1) {
+        if (mailbox_receive_msg(cpu, &msg) == 1) {
+            if (msg.msg_type == MSG_SHUTDOWN) return;
+            if (mailbox_send_buf(msg.sender_id, MSG_ACK, msg.msg_data, msg.buf_handle,
+                                 msg.buf_off, msg.buf_len) != 0) {
+                mailbox_release(&msg);
+            }
+        }
+    }
+}
+
+static void bench_peer_entry(void)
+{
+    for (;;) sched_context_switch(&bench_tcb_peer, &bench_tcb_main);
+}
+
+static uint64_t bench_ctx_switch(void *ctx)
+{
+    (void)ctx;
+    sched_context_switch(&bench_tcb_main, &bench_tcb_peer);
+    return BENCH_SELF_TIMED;
+}
+
+static uint64_t bench_hmac_tag(void *ctx)
+{
+    (void)ctx;
+    bench_msg.counter++;
+    hmac_tag_compute(&bench_msg, 0, bench_msg.tag);
+    return BENCH_SELF_TIMED;
+}
+
+static void bench_sgi_handler(uint32_t irq_id)
+{
+    (void)irq_id;
+    irq_entry_stamp = bench_cycles();
+}
+
+/* ctx = SGI to raise, which picks the path */
+static uint64_t bench_irq_entry(void *ctx)
+{
+    uint32_t sgi = (uint32_t)(uintptr_t)ctx;
+    irq_entry_stamp = 0;
+    uint64_t start = bench_cycles();
+    irq_send_sgi_self(sgi);
+    while (irq_entry_stamp == 0) { }
+    return irq_entry_stamp - start;
+}
+
+static uint64_t bench_slab_alloc_free(void *ctx)
+{
+    slab_pool_t *p = ctx;
+    slab_free(p, slab_alloc(p));
+    return BENCH_SELF_TIMED;
+}
+
+static uint64_t bench_rand(void)
+{
+    bench_rng ^= bench_rng << 13;
+    bench_rng ^= bench_rng >> 7;
+    bench_rng ^= bench_rng << 17;
+    return bench_rng;
+}
+
+static void bench_timer_fn(sw_timer_t *t)
+{
+    (void)t;                                /* periodic: already re-armed */
+}
+
+static uint64_t bench_timer_arm_cancel(void *ctx)
+{
+    (void)ctx;
+    timer_arm(&bench_probe, bench_rand() % (10u * BENCH_TIMER_SPAN_US), 0);
+    timer_cancel(&bench_probe);
+    return BENCH_SELF_TIMED;
+}
+
+/*
+ * Simulated time: the wheel only sees the cntpct it is run up to. Steps
+ * until one expires something; every period is under ~1 s, so that is at
+ * most ~1000 steps with the BENCH_TIMERS armed.
+ */
+static uint64_t bench_timer_expire(void *ctx)
+{
+    uint32_t fired;
+    uint64_t spent;
+    (void)ctx;
+
+    do {
+        bench_timer_clock += bench_timer_step;
+
+        uint64_t start = bench_cycles();
+        fired = timer_run(bench_timer_clock);
+        spent = bench_cycles() - start;
+    } while (!fired);
+
+    return spent / fired ? spent / fired : 1;
+}
+
+/******************************************************************************
+ * Function: bench_timer_setup
+ * Description: Core 0's wheel with BENCH_TIMERS periodic timers armed at
+ *              random periods, so the population stays constant while
+ *              timer_expire runs. sched_run() empties the wheel again.
+ * Returns: 0, or -1 if the arena has no room for the timers
+ *****************************************************************************/
+static int bench_timer_setup(void)
+{
+    uint64_t freq;
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+
+    bench_timers = arena_alloc(sizeof(sw_timer_t) * BENCH_TIMERS, _Alignof(sw_timer_t));
+    if (!bench_timers) return -1;
+
+    timer_init();
+    timer_setup(&bench_probe, bench_timer_fn);
+    for (uint32_t i = 0; i < BENCH_TIMERS; i++) {
+        uint32_t period = BENCH_TIMER_MIN_US + (uint32_t)(bench_rand() % BENCH_TIMER_SPAN_US);
+        timer_setup(&bench_timers[i], bench_timer_fn);
+        timer_arm(&bench_timers[i], period, period);
+    }
+    bench_timer_clock = bench_ticks();
+    bench_timer_step  = freq / 1000;
+    return 0;
+}
+
+/******************************************************************************
+ * Function: bench_register_defaults
+ * Description: Prepare the fixtures and register the stock benchmarks.
+ *              Needs irq_init() + irq_enable() (irq_entry*; the FIQ
+ *              variant claims the FIQ source) and Core 1 in
+ *              bench_mailbox_echo() (mailbox_rtt), and slab_msg_pools_init()
+ *              (slab_alloc_free). The timer_* fixture takes Core 0's timer
+ *              wheel, so it must run before sched_run() on Core 0.
+ *****************************************************************************/
+void bench_register_defaults(void)
+{
+    ring_buffer_init(&bench_ring);
+
+    bench_msg.sender_id = 0;
+    bench_msg.msg_type  = MSG_DATA;
+    bench_msg.msg_data  = 0x12345678;
+    bench_msg.counter   = 0;
+
+    /* Peer context: same initial frame layout sched_add_task builds */
+    bench_tcb_peer.stack = bench_peer_stack.stack;
+    uint64_t *sp = (uint64_t *)(bench_tcb_peer.stack + TASK_STACK_SIZE) - 12;
+    uint64_t daif;
+    __asm__ volatile("mrs %0, daif" : "=r"(daif));
+    for (int i = 0; i < 12; i++) sp[i] = 0;
+    sp[1]  = (uint64_t)sched_task_start;    /* x30 */
+    sp[10] = (uint64_t)bench_peer_entry;    /* x19 */
+    sp[11] = daif;                          /* x20 */
+    bench_tcb_peer.sp = (uint64_t)sp;
+
+    irq_register_handler(BENCH_SGI_ID, bench_sgi_handler);
+    irq_register_fast(BENCH_SGI_FAST, bench_sgi_handler);
+    int fiq = irq_set_fiq(BENCH_SGI_FIQ, bench_sgi_handler);
+
+    bench_register("ring_put_get",    bench_ring_put_get, 0, 0);
+    bench_register("mailbox_rtt",     bench_mailbox_rtt,  0, 0);
+    bench_register("mailbox_rtt_buf", bench_mailbox_rtt_buf, 0, 0);
+    bench_register("ctx_switch_pair", bench_ctx_switch,   0, 0);
+    bench_register("hmac_tag",        bench_hmac_tag,     0, 0);
+    bench_register("irq_entry",       bench_irq_entry, (void *)(uintptr_t)BENCH_SGI_ID, 0);
+    bench_register("irq_entry_fast",  bench_irq_entry, (void *)(uintptr_t)BENCH_SGI_FAST, 0);
+    if (fiq == 0) {
+        bench_register("irq_entry_fiq", bench_irq_entry, (void *)(uintptr_t)BENCH_SGI_FIQ, 0);
+    }
+    if (slab_msg_small) {
+        bench_register("slab_alloc_free", bench_slab_alloc_free, slab_msg_small, 0);
+    }
+    if (bench_timer_setup() == 0) {
+        bench_register("timer_arm_cancel", bench_timer_arm_cancel, 0, 0);
+        bench_register("timer_expire",     bench_timer_expire,     0, 0);
+    }
+}
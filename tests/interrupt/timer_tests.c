@@ -1,7 +1,9 @@
 /******************************************************************************
  * File: timer_tests.c
  * Description: Timer safety tests — frequency sanity, IMASK masking,
- *              countdown with IRQ, and overflow/late-reload delta check.
+ *              countdown with IRQ, overflow/late-reload delta check,
+ *              virtual-timer driven profiler sampling, and nesting of
+ *              prioritised IRQs.
  * Copyright (c) 2026 Maior Cristian
  ******************************************************************************/
 
@@ -11,6 +13,7 @@
 #include "interrupt/timer_tests.h"
 #include "interrupts/irq.h"
 #include "uart/uart0.h"
+#include "prof/prof.h"
 
 /**************************************************
  * MACRO DEFINITIONS
@@ -19,6 +22,11 @@
 #define COUNTDOWN_START    '5'          /* ASCII countdown 5 → 0             */
 #define DELTA_TEST_TICKS   3u           /* number of IRQs to measure spacing */
 #define TOLERANCE_PERCENT  10u          /* allow 10% jitter on delta check   */
+#define PROF_TEST_MS       10u          /* sampling window for test 5        */
+#define PROF_TEST_MIN      (PROF_MAX_HZ * PROF_TEST_MS / 1000u / 4u)  /* 25% */
+#define NEST_SGI_LOW       6u           /* SGIs private to test 6            */
+#define NEST_SGI_HIGH      7u
+#define NEST_WAIT_TICKS    62500u       /* 1 ms for the other SGI to arrive  */
 
 /**************************************************
  * GLOBAL VARIABLES
@@ -27,6 +35,9 @@ volatile unsigned char u_timerLeft;
 static volatile uint32_t g_imask_fired;
 static volatile uint32_t g_delta_count;
 static volatile uint64_t g_delta_timestamps[DELTA_TEST_TICKS + 1];
+static volatile uint32_t g_nest_log;            /* 4 bits per handler event */
+static volatile uint32_t g_nest_depth;          /* irq_nesting() in 'high'  */
+static volatile uint32_t g_nest_raise;          /* which SGI raises which   */
 
 /**************************************************
  * HELPER — read physical counter
@@ -49,8 +60,6 @@ static inline uint64_t read_cntfrq(void)
  * IRQ HANDLERS
  ***************************************************/
 
-static void uart0_irq_handler(uint32_t irq_id) { (void)irq_id; }
-
 static void countdown_irq_handler(uint32_t irq_id)
 {
     (void)irq_id;
@@ -100,6 +109,25 @@ static void delta_irq_handler(uint32_t irq_id)
     __asm__ volatile("msr cntp_tval_el0, %0" :: "r"(freq));
 }
 
+/* Test 6 handlers: log entry/exit, optionally raise the other SGI and give
+ * it NEST_WAIT_TICKS to preempt before returning */
+static void nest_log(uint32_t ev) { g_nest_log = (g_nest_log << 4) | ev; }
+
+static void nest_sgi_handler(uint32_t irq_id)
+{
+    uint32_t high = (irq_id == NEST_SGI_HIGH);
+
+    nest_log(high ? 0x3u : 0x1u);
+    if (high) g_nest_depth = irq_nesting();
+    if (g_nest_raise == irq_id) {
+        g_nest_raise = 0;
+        irq_send_sgi_self(high ? NEST_SGI_LOW : NEST_SGI_HIGH);
+        uint64_t start = read_cntpct();
+        while (read_cntpct() - start < NEST_WAIT_TICKS) { }
+    }
+    nest_log(high ? 0x4u : 0x2u);
+}
+
 /******************************************************************************
  * Test 1: Frequency Sanity Check
  * Reads cntfrq_el0 and asserts it matches the QEMU virt expected value.
@@ -254,6 +282,91 @@ static int test_delta(void)
     return 0;
 }
 
+/******************************************************************************
+ * Test 5: Profiler Sampling
+ * Samples Core 0 at PROF_MAX_HZ for PROF_TEST_MS while it spins, then checks
+ * enough samples arrived (a quarter of nominal, QEMU timers are lazy) and
+ * that each one holds a PC.
+ ******************************************************************************/
+static int test_prof_sampling(void)
+{
+    uart_puts("[TEST] Profiler sampling... ");
+
+    uint64_t window = read_cntfrq() * PROF_TEST_MS / 1000u;
+
+    prof_start(PROF_MAX_HZ);
+    irq_enable();
+
+    uint64_t start = read_cntpct();
+    while (read_cntpct() - start < window) { }
+
+    irq_disable();
+    prof_stop();
+
+    uint32_t n = prof_sample_count(0);
+    uart_puts("samples: 0x");
+    uart_puthex(n);
+    uart_puts(" ");
+
+    for (uint32_t i = 0; i < n; i++) {
+        const prof_sample_t *s = prof_sample(0, i);
+        if (!s || s->depth == 0 || s->pc[0] == 0) n = 0;
+    }
+
+    if (n < PROF_TEST_MIN) {
+        uart_puts("FAIL\n");
+        return -1;
+    }
+    uart_puts("PASS\n");
+    return 0;
+}
+
+/******************************************************************************
+ * Test 6: Nested Priorities
+ * A low-priority SGI handler raises a high-priority SGI: it must run inside
+ * the low one (log 1 3 4 2, nesting depth 2). A high-priority handler
+ * raising a low-priority SGI must finish first (log 3 4 1 2).
+ ******************************************************************************/
+static int nest_round(uint32_t first, uint32_t expect_log)
+{
+    g_nest_log   = 0;
+    g_nest_depth = 0;
+    g_nest_raise = first;
+
+    irq_enable();
+    irq_send_sgi_self(first);
+    uint64_t start = read_cntpct();
+    while ((g_nest_log & 0xF000u) == 0 && read_cntpct() - start < 4 * NEST_WAIT_TICKS) { }
+    irq_disable();
+
+    return (g_nest_log == expect_log) ? 0 : -1;
+}
+
+static int test_nested_priority(void)
+{
+    uart_puts("[TEST] Nested IRQ priorities... ");
+
+    irq_set_priority(NEST_SGI_LOW,  IRQ_PRIO_LOW);
+    irq_set_priority(NEST_SGI_HIGH, IRQ_PRIO_HIGH);
+    irq_register_handler(NEST_SGI_LOW,  nest_sgi_handler);
+    irq_register_handler(NEST_SGI_HIGH, nest_sgi_handler);
+
+    int preempt  = nest_round(NEST_SGI_LOW, 0x1342u);
+    uint32_t dep = g_nest_depth;
+    int ordered  = nest_round(NEST_SGI_HIGH, 0x3412u);
+
+    if (preempt || dep != 2u || ordered) {
+        uart_puts("FAIL (log 0x");
+        uart_puthex(g_nest_log);
+        uart_puts(" depth ");
+        uart_putc('0' + (dep & 0xF));
+        uart_puts(")\n");
+        return -1;
+    }
+    uart_puts("PASS\n");
+    return 0;
+}
+
 /******************************************************************************
  * Function: interrupt_tests_init
  * Description: Runs all timer safety tests in order, halts on fatal failure.
@@ -261,7 +374,6 @@ static int test_delta(void)
 void interrupt_tests_init(void)
 {
     irq_init();
-    irq_register_handler(IRQ_ID_UART0, uart0_irq_handler);
 
     /* Test 1 — freq must be correct for ALL other tests */
     if (test_freq_sanity() != 0) {
@@ -272,6 +384,8 @@ void interrupt_tests_init(void)
     test_imask();
     test_countdown();
     test_delta();
+    test_prof_sampling();
+    test_nested_priority();
 
     uart_puts("[IRQ] All timer tests complete. Continuing...\n");
 }
\ No newline at end of file
@@ -16,7 +16,6 @@
 void interrupt_tests_init(void);
 // static inline uint64_t read_cntpct(void);
 // static inline uint64_t read_cntfrq(void);
-// static void uart0_irq_handler(uint32_t irq_id);
 // static void countdown_irq_handler(uint32_t irq_id);
 // static void imask_irq_handler(uint32_t irq_id);
 // static void delta_irq_handler(uint32_t irq_id);
@@ -24,3 +23,6 @@ void interrupt_tests_init(void);
 // static int test_imask(void);
 // static int test_countdown(void);
 // static int test_delta(void);
+// static int test_prof_sampling(void);
+// static void nest_sgi_handler(uint32_t irq_id);
+// static int test_nested_priority(void);
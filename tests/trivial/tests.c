@@ -25,6 +25,20 @@
 #include "uart/uart0.h"
 #include "ipc/ipc.h"
 #include "ringbuffer/ringbuf.h"
+#include "queue/queue.h"
+#include "crypto/tc_defs.h"
+#include "crypto/sha256.h"
+#include "log/log.h"
+#include "pmu/pmu.h"
+#include "mmu/pagetable.h"
+#include "alloc/arena.h"
+#include "alloc/slab.h"
+#include "timer/timer_wheel.h"
+#include "scheduler/scheduler.h"
+#include "crc/crc.h"
+#include "mqtt/mqtt.h"
+#include "modbus/modbus_rtu.h"
+#include "libc/mem.h"
 #include "tests.h"
 
 /******************************************************************************
@@ -32,6 +46,99 @@
  *****************************************************************************/
 extern void delay(int n);
 
+/**************************************************
+ * QUEUE TEST TYPES
+ ***************************************************/
+typedef struct {
+    uint32_t seq;            /* checked on pop to catch reordering/loss */
+    uint32_t payload[3];     /* pad record to 16 bytes like a small frame */
+} test_record_t;
+
+QUEUE_SPSC_DECLARE(test_spsc_q, test_record_t, TEST_QUEUE_CAPACITY)
+QUEUE_MPSC_DECLARE(test_mpsc_q, test_record_t, TEST_QUEUE_CAPACITY)
+QUEUE_MPMC_DECLARE(test_mpmc_q, test_record_t, TEST_QUEUE_CAPACITY)
+
+static test_spsc_q_t spsc_queue;
+static test_mpsc_q_t mpsc_queue;
+static test_mpmc_q_t mpmc_queue;
+
+/* Cross-core queue phase of test5/test6: per-core results, shared count */
+static struct {
+    volatile uint32_t popped;       /* both consumers, atomic_fetch_add32 */
+    uint32_t          errors[2];    /* [core]                             */
+    uint64_t          sum[2];       /* [core]: seq + 1 of every pop       */
+} test_xq;
+
+/* Job Core 0 posts to Core 1 (test_secondary_idle) */
+static void (*volatile test_remote_job)(void);
+static volatile uint32_t test_remote_state;
+
+static spinlock_t test_ticket_lock;
+static mcs_lock_t test_mcs_lock;
+static uint8_t sha_bench_buf[TEST_SHA_BENCH_BLOCKS * TC_SHA256_BLOCK_SIZE];
+
+/* FIPS 180-2 appendix B.1: SHA-256("abc") */
+static const uint8_t sha_abc_digest[TC_SHA256_DIGEST_SIZE] = {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+    0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+    0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+};
+
+/*
+ * Fill the queue to capacity, check one extra push is refused, then drain
+ * it and check FIFO order. Repeats until TEST_QUEUE_OPS records went through.
+ */
+#define RUN_QUEUE_THROUGHPUT(qname, q, errors)                              \
+    do {                                                                    \
+        test_record_t rec = { 0, { 0xA5A5A5A5, 0x5A5A5A5A, 0 } };          \
+        test_record_t out;                                                  \
+        for (uint32_t n = 0; n < TEST_QUEUE_OPS; n += TEST_QUEUE_CAPACITY) {\
+            for (uint32_t i = 0; i < TEST_QUEUE_CAPACITY; i++) {            \
+                rec.seq = n + i;                                            \
+                if (qname##_push((q), &rec) != 0) (errors)++;               \
+            }                                                               \
+            if (qname##_push((q), &rec) == 0) (errors)++;   /* full */      \
+            for (uint32_t i = 0; i < TEST_QUEUE_CAPACITY; i++) {            \
+                if (qname##_pop((q), &out) != 0 || out.seq != n + i)        \
+                    (errors)++;                                             \
+            }                                                               \
+        }                                                                   \
+        if (qname##_pop((q), &out) == 0) (errors)++;        /* empty */     \
+    } while (0)
+
+/*
+ * Cross-core phase, run by Core 0 and Core 1 at the same time: each pushes
+ * TEST_QUEUE_OPS records tagged with its core; with 'pop' it also pops
+ * until both streams are through. Per producer, the seqs one consumer
+ * sees must rise (FIFO); count and seq sums are checked afterwards.
+ */
+#define RUN_QUEUE_CROSS(qname, q, core, pop)                                \
+    do {                                                                    \
+        test_record_t rec = { 0, { 0xA5A5A5A5, 0x5A5A5A5A, (core) } };     \
+        test_record_t out;                                                  \
+        uint32_t next[2] = { 0, 0 };                                        \
+        uint32_t sent = 0;                                                  \
+        uint64_t t0 = read_cntpct();                                        \
+        while (sent < TEST_QUEUE_OPS || ((pop) &&                           \
+               atomic_load_acquire32(&test_xq.popped) < 2 * TEST_QUEUE_OPS)) {\
+            if (read_cntpct() - t0 > TEST_QUEUE_CROSS_TICKS) {              \
+                test_xq.errors[core]++;                     /* stuck */     \
+                break;                                                      \
+            }                                                               \
+            rec.seq = sent;                                                 \
+            if (sent < TEST_QUEUE_OPS && qname##_push((q), &rec) == 0)      \
+                sent++;                                                     \
+            if ((pop) && qname##_pop((q), &out) == 0) {                     \
+                uint32_t src = out.payload[2] & 1u;                         \
+                if (out.seq < next[src]) test_xq.errors[core]++;            \
+                next[src] = out.seq + 1;                                    \
+                test_xq.sum[core] += out.seq + 1;                           \
+                atomic_fetch_add32(&test_xq.popped, 1);                     \
+            }                                                               \
+        }                                                                   \
+    } while (0)
+
 /**************************************************
  * HELPER FUNCTIONS
  ***************************************************/
@@ -68,6 +175,193 @@ static void test_print_fail(const char *label, const char *reason) {
     spinlock_release(SPINLOCK_ADDR);
 }
 
+/******************************************************************************
+ * Function: read_cntpct
+ * Description: Reads the physical counter (62.5 MHz on QEMU virt)
+ *****************************************************************************/
+static inline uint64_t read_cntpct(void) {
+    uint64_t v;
+    __asm__ volatile("isb; mrs %0, cntpct_el0" : "=r"(v) :: "memory");
+    return v;
+}
+
+/******************************************************************************
+ * Function: read_pmccntr
+ * Description: Enables the PMU cycle counter (idempotent) and reads it
+ *****************************************************************************/
+static inline uint64_t read_pmccntr(void) {
+    uint64_t v;
+    __asm__ volatile("msr pmcr_el0, %0" :: "r"(1UL));          /* PMCR.E     */
+    __asm__ volatile("msr pmcntenset_el0, %0" :: "r"(1UL << 31)); /* cycle ctr */
+    __asm__ volatile("isb; mrs %0, pmccntr_el0" : "=r"(v) :: "memory");
+    return v;
+}
+
+/******************************************************************************
+ * Function: sha_bench_backend
+ * Description: Hashes "abc" (known answer) and the bench buffer with one
+ *              backend. Returns PMU cycles per compressed block.
+ * Parameters:
+ *   digest - out: SHA-256 of sha_bench_buf
+ *   kat_ok - out: 1 if SHA-256("abc") matched FIPS 180-2
+ *****************************************************************************/
+static uint64_t sha_bench_backend(uint8_t digest[TC_SHA256_DIGEST_SIZE], int *kat_ok) {
+    struct tc_sha256_state_struct st;
+    uint8_t abc[TC_SHA256_DIGEST_SIZE];
+    uint8_t diff = 0;
+
+    tc_sha256_init(&st);
+    tc_sha256_update(&st, (const uint8_t *)"abc", 3);
+    tc_sha256_final(abc, &st);
+    for (unsigned i = 0; i < TC_SHA256_DIGEST_SIZE; i++) diff |= abc[i] ^ sha_abc_digest[i];
+    *kat_ok = (diff == 0);
+
+    uint64_t start = read_pmccntr();
+    tc_sha256_init(&st);
+    tc_sha256_update(&st, sha_bench_buf, sizeof(sha_bench_buf));
+    tc_sha256_final(digest, &st);
+    uint64_t cycles = read_pmccntr() - start;
+
+    return cycles / (TEST_SHA_BENCH_BLOCKS + 1);   /* +1 = padding block */
+}
+
+/******************************************************************************
+ * Function: test_report_queue
+ * Description: Prints PASS/FAIL plus the tick count of a queue throughput run
+ * Parameters:
+ *   label  - Short string identifying the test
+ *   errors - Number of failed push/pop/order checks
+ *   ticks  - cntpct_el0 ticks for TEST_QUEUE_OPS push+pop pairs
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+static int test_report_queue(const char *label, uint32_t errors, uint64_t ticks) {
+    spinlock_acquire(SPINLOCK_ADDR);
+    uart_puts("[Core 0] ");
+    uart_puts(label);
+    uart_puts(": ");
+    uart_puthex(TEST_QUEUE_OPS);
+    uart_puts(" push+pop pairs in ");
+    uart_puthex(ticks);
+    uart_puts(" ticks\n");
+    spinlock_release(SPINLOCK_ADDR);
+
+    if (errors) {
+        test_print_fail(label, "order/full/empty check failed");
+        return -1;
+    }
+    test_print_pass(label);
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test_remote_post
+ * Description: Hand 'job' to Core 1 (waiting in test_secondary_idle) and
+ *              wait until it has started, so both cores run together.
+ *              Takes the job back if Core 1 does not start it in time.
+ * Returns: 0 if Core 1 is running the job, -1 if it never took it
+ *****************************************************************************/
+static int test_remote_post(void (*job)(void)) {
+    test_remote_job = job;
+    atomic_store_release32(&test_remote_state, TEST_REMOTE_POSTED);
+    __asm__ volatile("sev" ::: "memory");
+
+    uint64_t start = read_cntpct();
+    while (atomic_load_acquire32(&test_remote_state) == TEST_REMOTE_POSTED) {
+        if (read_cntpct() - start > TEST_QUEUE_CROSS_TICKS &&
+            atomic_cas32(&test_remote_state, TEST_REMOTE_POSTED, TEST_REMOTE_IDLE)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test_remote_wait
+ * Description: Wait for the job test_remote_post() started to finish
+ * Returns: 0 when Core 1 is done, -1 on timeout
+ *****************************************************************************/
+static int test_remote_wait(void) {
+    uint64_t start = read_cntpct();
+    while (atomic_load_acquire32(&test_remote_state) != TEST_REMOTE_DONE) {
+        if (read_cntpct() - start > 2 * TEST_QUEUE_CROSS_TICKS) return -1;
+    }
+    atomic_store_release32(&test_remote_state, TEST_REMOTE_IDLE);
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test_report_cross
+ * Description: Checks the cross-core phase: 2 x TEST_QUEUE_OPS records
+ *              popped, none lost or duplicated (seq sums), per-producer
+ *              order kept on every consumer; prints PASS/FAIL and ticks.
+ * Parameters:
+ *   label  - Short string identifying the test
+ *   remote - result of test_remote_wait()
+ *   ticks  - cntpct_el0 ticks of Core 0's side
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+static int test_report_cross(const char *label, int remote, uint64_t ticks) {
+    const uint64_t expect = 2ull * TEST_QUEUE_OPS * (TEST_QUEUE_OPS + 1) / 2;
+    const char *why = 0;
+
+    if (remote != 0) why = "Core 1 did not finish";
+    else if (test_xq.errors[0] || test_xq.errors[1]) why = "order check failed or stuck";
+    else if (test_xq.popped != 2 * TEST_QUEUE_OPS) why = "record count";
+    else if (test_xq.sum[0] + test_xq.sum[1] != expect) why = "records lost or duplicated";
+
+    spinlock_acquire(SPINLOCK_ADDR);
+    uart_puts("[Core 0] ");
+    uart_puts(label);
+    uart_puts(": ");
+    uart_puthex(2 * TEST_QUEUE_OPS);
+    uart_puts(" records across 2 cores in ");
+    uart_puthex(ticks);
+    uart_puts(" ticks\n");
+    spinlock_release(SPINLOCK_ADDR);
+
+    if (why) {
+        test_print_fail(label, why);
+        return -1;
+    }
+    test_print_pass(label);
+    return 0;
+}
+
+static void test_xq_reset(void) {
+    test_xq.popped = 0;
+    for (uint32_t c = 0; c < 2; c++) {
+        test_xq.errors[c] = 0;
+        test_xq.sum[c]    = 0;
+    }
+}
+
+/* Core 1's side: a second producer (MPSC), producer + consumer (MPMC) */
+static void test5_core1_job(void) {
+    RUN_QUEUE_CROSS(test_mpsc_q, &mpsc_queue, 1, 0);
+}
+
+static void test6_core1_job(void) {
+    RUN_QUEUE_CROSS(test_mpmc_q, &mpmc_queue, 1, 1);
+}
+
+/******************************************************************************
+ * Function: test_secondary_idle
+ * Description: Core 1's idle loop once its ring-buffer demo is done: sleeps
+ *              in WFE and runs the jobs Core 0 posts for the cross-core
+ *              queue tests. test19's job never returns: it leaves Core 1
+ *              in sched_run(). Does not return.
+ *****************************************************************************/
+void test_secondary_idle(void) {
+    while (1) {
+        if (atomic_load_acquire32(&test_remote_state) == TEST_REMOTE_POSTED &&
+            atomic_cas32(&test_remote_state, TEST_REMOTE_POSTED, TEST_REMOTE_RUNNING)) {
+            test_remote_job();
+            atomic_store_release32(&test_remote_state, TEST_REMOTE_DONE);
+        }
+        __asm__ volatile("wfe");
+    }
+}
+
 /******************************************************************************
  * UNIT TEST CASES
  *****************************************************************************/
@@ -169,7 +463,6 @@ int test2_send_data_messages(void) {
             uart_puts("\n");
             spinlock_release(SPINLOCK_ADDR);
 
-            mailbox_clear(0);
             acks_received++;
         }
         delay(TEST_DELAY_MEDIUM);
@@ -188,7 +481,7 @@ int test2_send_data_messages(void) {
  * Function: test3_uart_rx_keyboard_simulation
  * Description: [Test 3] UART RX live - Keyboard Simulation.
  * Parameters: None
- * Returns: None (Core 0 announces then enters WFE sleep)
+ * Returns: None (announces only; the test runs on Cores 1 & 2)
  *****************************************************************************/
 void test3_uart_rx_keyboard_simulation(void) {
     spinlock_acquire(SPINLOCK_ADDR);
@@ -199,6 +492,996 @@ void test3_uart_rx_keyboard_simulation(void) {
     // while (1) { __asm__ volatile("wfe"); } // IMPORTANT to be commented when having scheduler
 }
 
+/******************************************************************************
+ * Function: test4_spsc_queue_throughput
+ * Description: [Test 4] Pushes/pops TEST_QUEUE_OPS 16-byte records through
+ *              the SPSC queue on Core 0 and reports the elapsed ticks.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test4_spsc_queue_throughput(void) {
+    uint32_t errors = 0;
+
+    test_spsc_q_init(&spsc_queue);
+    uint64_t start = read_cntpct();
+    RUN_QUEUE_THROUGHPUT(test_spsc_q, &spsc_queue, errors);
+    uint64_t ticks = read_cntpct() - start;
+
+    return test_report_queue("Test4: SPSC queue throughput", errors, ticks);
+}
+
+/******************************************************************************
+ * Function: test5_mpsc_queue_throughput
+ * Description: [Test 5] Same workload through the MPSC (CAS producer) queue,
+ *              then a contended run: Core 0 and Core 1 both produce at
+ *              once while Core 0 consumes, so the producer CAS races.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test5_mpsc_queue_throughput(void) {
+    uint32_t errors = 0;
+
+    test_mpsc_q_init(&mpsc_queue);
+    uint64_t start = read_cntpct();
+    RUN_QUEUE_THROUGHPUT(test_mpsc_q, &mpsc_queue, errors);
+    uint64_t ticks = read_cntpct() - start;
+
+    int rc = test_report_queue("Test5: MPSC queue throughput", errors, ticks);
+
+    test_mpsc_q_init(&mpsc_queue);
+    test_xq_reset();
+    if (test_remote_post(test5_core1_job) != 0) {
+        test_print_fail("Test5 MPSC cross-core", "Core 1 did not take the job");
+        return -1;
+    }
+    start = read_cntpct();
+    RUN_QUEUE_CROSS(test_mpsc_q, &mpsc_queue, 0, 1);
+    ticks = read_cntpct() - start;
+
+    return test_report_cross("Test5: MPSC 2 producers on 2 cores", test_remote_wait(), ticks) | rc;
+}
+
+/******************************************************************************
+ * Function: test6_mpmc_queue_throughput
+ * Description: [Test 6] Same workload through the MPMC (CAS both sides)
+ *              queue, then a contended run: Core 0 and Core 1 each produce
+ *              and consume at once, so both CAS sides race.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test6_mpmc_queue_throughput(void) {
+    uint32_t errors = 0;
+
+    test_mpmc_q_init(&mpmc_queue);
+    uint64_t start = read_cntpct();
+    RUN_QUEUE_THROUGHPUT(test_mpmc_q, &mpmc_queue, errors);
+    uint64_t ticks = read_cntpct() - start;
+
+    int rc = test_report_queue("Test6: MPMC queue throughput", errors, ticks);
+
+    test_mpmc_q_init(&mpmc_queue);
+    test_xq_reset();
+    if (test_remote_post(test6_core1_job) != 0) {
+        test_print_fail("Test6 MPMC cross-core", "Core 1 did not take the job");
+        return -1;
+    }
+    start = read_cntpct();
+    RUN_QUEUE_CROSS(test_mpmc_q, &mpmc_queue, 0, 1);
+    ticks = read_cntpct() - start;
+
+    return test_report_cross("Test6: MPMC 2 producers + 2 consumers", test_remote_wait(), ticks) | rc;
+}
+
+/******************************************************************************
+ * Function: test7_sha256_backends
+ * Description: [Test 7] Runs the SHA-256 known-answer test on the scalar and
+ *              (if present) ARMv8 CE compress backends, checks both give the
+ *              same digest over TEST_SHA_BENCH_BLOCKS blocks and prints the
+ *              cycles/block of each. Restores the boot-selected backend.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test7_sha256_backends(void) {
+    uint8_t d_scalar[TC_SHA256_DIGEST_SIZE];
+    uint8_t d_ce[TC_SHA256_DIGEST_SIZE];
+    int kat_scalar, kat_ce = 1;
+    uint64_t cyc_ce = 0;
+    uint8_t diff = 0;
+    int saved = tc_sha256_get_backend();
+
+    for (unsigned i = 0; i < sizeof(sha_bench_buf); i++) sha_bench_buf[i] = (uint8_t)(i * 31u + 7u);
+
+    tc_sha256_set_backend(TC_SHA256_BACKEND_SCALAR);
+    uint64_t cyc_scalar = sha_bench_backend(d_scalar, &kat_scalar);
+
+    int have_ce = (tc_sha256_set_backend(TC_SHA256_BACKEND_CE) == TC_CRYPTO_SUCCESS);
+    if (have_ce) {
+        cyc_ce = sha_bench_backend(d_ce, &kat_ce);
+        for (unsigned i = 0; i < TC_SHA256_DIGEST_SIZE; i++) diff |= d_scalar[i] ^ d_ce[i];
+    }
+    tc_sha256_set_backend(saved);
+
+    spinlock_acquire(SPINLOCK_ADDR);
+    uart_puts("[Core 0] SHA-256 scalar: ");
+    uart_puthex(cyc_scalar);
+    uart_puts(" cycles/block\n");
+    uart_puts("[Core 0] SHA-256 CE    : ");
+    if (have_ce) uart_puthex(cyc_ce);
+    else         uart_puts("n/a (no SHA2 in ID_AA64ISAR0_EL1)");
+    uart_puts(have_ce ? " cycles/block\n" : "\n");
+    spinlock_release(SPINLOCK_ADDR);
+
+    if (!kat_scalar || !kat_ce) {
+        test_print_fail("Test7 SHA-256", "known-answer digest mismatch");
+        return -1;
+    }
+    if (diff) {
+        test_print_fail("Test7 SHA-256", "CE and scalar digests differ");
+        return -1;
+    }
+    test_print_pass("Test7: SHA-256 scalar/CE backends");
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test8_lock_stats
+ * Description: [Test 8] Takes a private ticket lock and MCS lock
+ *              TEST_LOCK_ITERS times each, checks the acquire counters and
+ *              that both locks end up free, then prints the contention
+ *              stats of both plus the global UART lock.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test8_lock_stats(void) {
+    mcs_node_t node;
+
+    spinlock_lock_init(&test_ticket_lock);
+    mcs_lock_init(&test_mcs_lock);
+
+    uint64_t t0 = read_cntpct();
+    for (uint32_t i = 0; i < TEST_LOCK_ITERS; i++) {
+        spinlock_acquire(&test_ticket_lock);
+        spinlock_release(&test_ticket_lock);
+    }
+    uint64_t t1 = read_cntpct();
+    for (uint32_t i = 0; i < TEST_LOCK_ITERS; i++) {
+        mcs_lock_acquire(&test_mcs_lock, &node);
+        mcs_lock_release(&test_mcs_lock, &node);
+    }
+    uint64_t t2 = read_cntpct();
+
+    uint32_t t = test_ticket_lock.ticket;
+
+    spinlock_acquire(SPINLOCK_ADDR);
+    uart_puts("[Core 0] ticket lock ticks: ");
+    uart_puthex(t1 - t0);
+    uart_puts("  MCS lock ticks: ");
+    uart_puthex(t2 - t1);
+    uart_puts(atomic_use_lse ? "  (LSE)\n" : "  (LDXR/STXR)\n");
+    lock_stats_print("ticket", &test_ticket_lock.stats);
+    lock_stats_print("mcs   ", &test_mcs_lock.stats);
+    lock_stats_print("global", &SPINLOCK_ADDR->stats);
+    spinlock_release(SPINLOCK_ADDR);
+
+    if (test_ticket_lock.stats.acquires != TEST_LOCK_ITERS ||
+        test_mcs_lock.stats.acquires != TEST_LOCK_ITERS) {
+        test_print_fail("Test8 locks", "acquire count mismatch");
+        return -1;
+    }
+    if ((t & 0xFFFFu) != (t >> 16) || test_mcs_lock.tail != 0) {
+        test_print_fail("Test8 locks", "lock not free after release");
+        return -1;
+    }
+    test_print_pass("Test8: ticket/MCS lock stats");
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test9_uart_irq_tx
+ * Description: [Test 9] Queues one line through uart_write(), then one
+ *              longer than the TX FIFO through uart_tx_queue() with IRQs
+ *              masked, so nothing is sent synchronously: the whole line
+ *              must still be in the ring, and only the TX interrupt can
+ *              drain it within TEST_UART_DRAIN_TICKS. Needs
+ *              uart_irq_init() + irq_enable().
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test9_uart_irq_tx(void) {
+    static const unsigned char line[] =
+        "[Core 0] UART TX ring: this line was queued without waiting\r\n";
+    static const unsigned char isr_line[] =
+        "[Core 0] UART TX ring: this line left through the TX interrupt only\r\n";
+    unsigned int len     = sizeof(line) - 1;
+    unsigned int isr_len = sizeof(isr_line) - 1;
+    const char *why = 0;
+    uint64_t daif;
+
+    uint64_t start = read_cntpct();
+    unsigned int queued = uart_write(line, len);
+    uint64_t queue_ticks = read_cntpct() - start;
+
+    while (uart_tx_pending() && (read_cntpct() - start) < TEST_UART_DRAIN_TICKS) {
+        __asm__ volatile("wfi");
+    }
+    if (queued != len) why = "TX ring rejected bytes";
+    else if (uart_tx_pending()) why = "TX ring not drained";
+
+    /* Pump suppressed: only the ISR may move these bytes to the FIFO */
+    unsigned int irqs = uart_tx_irqs();
+    __asm__ volatile("mrs %0, daif\n msr daifset, #2" : "=r"(daif) :: "memory");
+    unsigned int isr_queued = uart_tx_queue(isr_line, isr_len);
+    unsigned int parked     = uart_tx_pending();
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+
+    start = read_cntpct();
+    while (uart_tx_pending() && (read_cntpct() - start) < TEST_UART_DRAIN_TICKS) {
+        __asm__ volatile("wfi");
+    }
+    uint64_t drain_ticks = read_cntpct() - start;
+    irqs = uart_tx_irqs() - irqs;
+
+    spinlock_acquire(SPINLOCK_ADDR);
+    uart_puts("[Core 0] uart_write ticks: ");
+    uart_puthex(queue_ticks);
+    uart_puts("  ISR drained after: ");
+    uart_puthex(drain_ticks);
+    uart_puts("  TX irqs: ");
+    uart_puthex(irqs);
+    uart_puts("  rx dropped: ");
+    uart_puthex(uart_rx_dropped());
+    uart_puts("\n");
+    spinlock_release(SPINLOCK_ADDR);
+
+    if (why) {
+        /* uart_write() part already failed */
+    } else if (isr_len <= UART_FIFO_DEPTH || isr_queued != isr_len) {
+        why = "ISR line fits the FIFO or was rejected";
+    } else if (parked != isr_len) {
+        why = "uart_tx_queue() sent bytes itself";
+    } else if (uart_tx_pending()) {
+        why = "TX ring not drained by ISR";
+    } else if (!irqs) {
+        why = "no TX interrupt refilled the FIFO";
+    }
+
+    if (why) {
+        test_print_fail("Test9 UART IRQ", why);
+        return -1;
+    }
+    test_print_pass("Test9: UART IRQ-driven TX");
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test10_log_records
+ * Description: [Test 10] Appends TEST_LOG_RECORDS records to Core 0's log
+ *              queue, reports the ticks per record, then flushes them and
+ *              checks every record came out and none was dropped.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test10_log_records(void) {
+    log_flush(LOG_DEPTH);                       /* start from an empty queue */
+    uint32_t drops = log_dropped(0);
+
+    uint64_t start = read_cntpct();
+    for (uint32_t i = 0; i < TEST_LOG_RECORDS; i++) {
+        LOG("Test10 log record ", i);
+    }
+    uint64_t ticks = read_cntpct() - start;
+
+    unsigned int emitted = log_flush(LOG_DEPTH);
+
+    spinlock_acquire(SPINLOCK_ADDR);
+    uart_puts("[Core 0] LOG ticks for ");
+    uart_puthex(TEST_LOG_RECORDS);
+    uart_puts(" records: ");
+    uart_puthex(ticks);
+    uart_puts("\n");
+    spinlock_release(SPINLOCK_ADDR);
+
+    if (emitted < TEST_LOG_RECORDS || log_dropped(0) != drops) {   /* other cores may add */
+        test_print_fail("Test10 log", "records lost or dropped");
+        return -1;
+    }
+    test_print_pass("Test10: per-core log queue");
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test11_pmu_probe
+ * Description: [Test 11] Opens and closes TEST_PMU_SCOPES probe scopes
+ *              around a SHA-256 block on Core 0 and checks the probe row
+ *              counted every scope and accumulated cycles and a max.
+ *              Calls the functions directly, so it runs without PROBES=1.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test11_pmu_probe(void) {
+    static const uint8_t block[TC_SHA256_BLOCK_SIZE];
+    struct tc_sha256_state_struct s;
+    uint8_t digest[TC_SHA256_DIGEST_SIZE];
+
+    const pmu_stat_t *st = pmu_probe_stat(0, PMU_PROBE_SELFTEST);
+    uint64_t calls  = st->calls;
+    uint64_t cycles = st->cycles;
+
+    for (uint32_t i = 0; i < TEST_PMU_SCOPES; i++) {
+        pmu_probe_begin(PMU_PROBE_SELFTEST);
+        tc_sha256_init(&s);
+        tc_sha256_update(&s, block, sizeof(block));
+        tc_sha256_final(digest, &s);
+        pmu_probe_end(PMU_PROBE_SELFTEST);
+    }
+
+    uint64_t dc = st->cycles - cycles;
+
+    spinlock_acquire(SPINLOCK_ADDR);
+    uart_puts("[Core 0] PMU selftest cycles/scope: ");
+    uart_putdec(dc / TEST_PMU_SCOPES);
+    uart_puts(" inst: ");
+    uart_putdec(st->inst);
+    uart_puts("\n");
+    spinlock_release(SPINLOCK_ADDR);
+
+    if (st->calls - calls != TEST_PMU_SCOPES || dc == 0 || st->max_cycles == 0) {
+        test_print_fail("Test11 PMU", "probe row not updated");
+        return -1;
+    }
+    test_print_pass("Test11: PMU probe accounting");
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test_at_par
+ * Description: Translate 'va' with AT S1E1R (or S1E1W) and return PAR_EL1:
+ *              bit 0 set = the access would fault, bits [63:56] = MAIR attr
+ *****************************************************************************/
+static uint64_t test_at_par(uintptr_t va, int write) {
+    uint64_t par;
+
+    if (write) __asm__ volatile("at s1e1w, %0" :: "r"(va) : "memory");
+    else       __asm__ volatile("at s1e1r, %0" :: "r"(va) : "memory");
+    __asm__ volatile("isb\n mrs %0, par_el1" : "=r"(par) :: "memory");
+    return par;
+}
+
+/******************************************************************************
+ * Function: test12_mmu_regions
+ * Description: [Test 12] Asks the MMU (AT + PAR_EL1, nothing is actually
+ *              accessed) whether the regions mmu_build_tables() set up
+ *              have the right permissions: text and rodata not writable,
+ *              boot and task stack guard pages unmapped, stacks and .bss
+ *              writable Normal WB, MMU_NONCACHEABLE buffers Normal NC.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test12_mmu_regions(void) {
+    extern char __rodata_start[], __task_stacks_start[], __boot_stacks_start[];
+    static uint8_t test_nc_buf[TEST_MMU_NC_BYTES] MMU_NONCACHEABLE;
+    static uint8_t test_wb_buf[TEST_MMU_NC_BYTES];
+    const char *why = 0;
+
+    uintptr_t text   = (uintptr_t)&test12_mmu_regions;
+    uintptr_t rodata = (uintptr_t)__rodata_start;
+    uintptr_t tguard = (uintptr_t)__task_stacks_start;
+    uintptr_t bguard = (uintptr_t)__boot_stacks_start;
+
+    if (test_at_par(text, 0) & TEST_PAR_FAULT)                 why = "text not readable";
+    else if (!(test_at_par(text, 1) & TEST_PAR_FAULT))         why = "text writable";
+    else if (!(test_at_par(rodata, 1) & TEST_PAR_FAULT))       why = "rodata writable";
+    else if (!(test_at_par(tguard, 0) & TEST_PAR_FAULT))       why = "task stack guard mapped";
+    else if (test_at_par(tguard + MMU_PAGE_SIZE, 1) & TEST_PAR_FAULT) why = "task stack not writable";
+    else if (!(test_at_par(bguard, 0) & TEST_PAR_FAULT))       why = "boot stack guard mapped";
+    else if (test_at_par(bguard + MMU_PAGE_SIZE, 1) & TEST_PAR_FAULT) why = "boot stack not writable";
+    else if ((test_at_par((uintptr_t)test_wb_buf, 1) >> 56) != TEST_PAR_ATTR_WB) why = "bss not Normal WB";
+    else if ((test_at_par((uintptr_t)test_nc_buf, 1) >> 56) != TEST_PAR_ATTR_NC) why = "NC buffer cacheable";
+
+    spinlock_acquire(SPINLOCK_ADDR);
+    uart_puts("[Core 0] MMU 2 MB slots split into 4 KB pages: ");
+    uart_putdec(mmu_l3_tables_used());
+    uart_puts("\n");
+    spinlock_release(SPINLOCK_ADDR);
+
+    if (why) {
+        test_print_fail("Test12 MMU", why);
+        return -1;
+    }
+    test_print_pass("Test12: MMU region attributes and guard pages");
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test13_slab_pool
+ * Description: [Test 13] Creates a TEST_SLAB_OBJS pool in the shared arena
+ *              and allocates every object from Core 0: the first quarter
+ *              comes from Core 0's own list, the rest is stolen from the
+ *              other three. One more alloc must fail. After freeing all of
+ *              them (onto Core 0's list) in_use is 0, high_water is
+ *              TEST_SLAB_OBJS and the next alloc needs no steal.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test13_slab_pool(void) {
+    extern char __shared_start[], __shared_end[];
+    slab_pool_t *p = slab_pool_create("test13", TEST_SLAB_OBJ_SIZE, TEST_SLAB_OBJS);
+    uint8_t *obj[TEST_SLAB_OBJS];
+    slab_stats_t st;
+    const char *why = 0;
+
+    if (!p) {
+        test_print_fail("Test13 slab", "arena exhausted");
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < TEST_SLAB_OBJS && !why; i++) {
+        obj[i] = slab_alloc(p);
+        if (!obj[i]) why = "pool ran dry early";
+        else if ((uintptr_t)obj[i] % SLAB_ALIGN) why = "object misaligned";
+        else if (obj[i] < (uint8_t *)__shared_start ||
+                 obj[i] + p->obj_size > (uint8_t *)__shared_end) why = "object outside arena";
+        for (uint32_t j = 0; j < i && !why; j++) {
+            if (obj[j] == obj[i]) why = "object handed out twice";
+        }
+    }
+
+    if (!why && slab_alloc(p) != 0)                      why = "alloc past capacity";
+    if (!why && slab_free(p, obj[0] + 1) != -1)          why = "bad pointer accepted";
+    for (uint32_t i = 0; i < TEST_SLAB_OBJS && !why; i++) {
+        if (slab_free(p, obj[i]) != 0) why = "free rejected";
+    }
+
+    slab_stats(p, &st);
+    if (!why && (st.in_use != 0 || st.high_water != TEST_SLAB_OBJS ||
+                 st.fails != 1 || st.steals != TEST_SLAB_OBJS - TEST_SLAB_OBJS / SLAB_CORES)) {
+        why = "counters wrong";
+    }
+    if (!why) {
+        uint64_t steals = st.steals;
+        void *again = slab_alloc(p);
+        slab_stats(p, &st);
+        if (!again || st.steals != steals) why = "freed object not on own list";
+        else slab_free(p, again);
+    }
+
+    spinlock_acquire(SPINLOCK_ADDR);
+    slab_stats_print(p);
+    arena_stats_print();
+    spinlock_release(SPINLOCK_ADDR);
+
+    if (why) {
+        test_print_fail("Test13 slab", why);
+        return -1;
+    }
+    test_print_pass("Test13: slab pool per-core free lists");
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test_zc_receive
+ * Description: Poll Core 0's inbox for the test message with 'data',
+ *              releasing anything else (late ACKs from earlier tests)
+ * Returns: 1 found, -1 HMAC rejected, 0 not seen in TEST_ZC_POLL_ROUNDS
+ *****************************************************************************/
+static int test_zc_receive(mailbox_msg_t *msg, unsigned int data) {
+    for (uint32_t i = 0; i < TEST_ZC_POLL_ROUNDS; i++) {
+        int rc = mailbox_receive_msg(0, msg);
+        if (rc == -1) return -1;
+        if (rc == 1) {
+            if (msg->msg_type == MSG_DATA && msg->msg_data == data) return 1;
+            mailbox_release(msg);
+        }
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test14_mailbox_zero_copy
+ * Description: [Test 14] Fills TEST_ZC_BYTES of a msg_large buffer and sends
+ *              it to Core 0's own inbox by handle. The receiver must see
+ *              the very same bytes (the payload pointer is the buffer, no
+ *              copy), and mailbox_release() must return the buffer. A
+ *              second message whose payload is changed after sending must
+ *              fail verification; the test frees that buffer by hand.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test14_mailbox_zero_copy(void) {
+    mailbox_msg_t msg;
+    slab_stats_t before, after;
+    uint32_t handle;
+    const char *why = 0;
+
+    if (!slab_msg_large) {
+        test_print_fail("Test14 zero-copy", "message pools not created");
+        return -1;
+    }
+    slab_stats(slab_msg_large, &before);
+
+    uint8_t *buf = mailbox_buf_alloc(TEST_ZC_BYTES, &handle);
+    if (!buf) {
+        test_print_fail("Test14 zero-copy", "no message buffer");
+        return -1;
+    }
+    for (uint32_t i = 0; i < TEST_ZC_BYTES; i++) buf[TEST_ZC_OFFSET + i] = (uint8_t)(i * 7);
+
+    if (mailbox_send_buf(0, MSG_DATA, TEST_ZC_DATA, handle, TEST_ZC_OFFSET, TEST_ZC_BYTES) != 0) {
+        why = "send failed";
+    } else if (test_zc_receive(&msg, TEST_ZC_DATA) != 1) {
+        why = "message not received";
+    } else {
+        const uint8_t *p = mailbox_payload(&msg);
+        if (p != buf + TEST_ZC_OFFSET || msg.buf_len != TEST_ZC_BYTES) why = "payload moved";
+        for (uint32_t i = 0; i < TEST_ZC_BYTES && !why; i++) {
+            if (p[i] != (uint8_t)(i * 7)) why = "payload corrupted";
+        }
+        mailbox_release(&msg);
+    }
+
+    /* Tampered payload: changed after the tag was computed */
+    if (!why) {
+        buf = mailbox_buf_alloc(TEST_ZC_BYTES, &handle);
+        if (!buf || mailbox_send_buf(0, MSG_DATA, TEST_ZC_DATA + 1, handle, 0, TEST_ZC_BYTES) != 0) {
+            why = "second send failed";
+        } else {
+            buf[TEST_ZC_BYTES / 2] ^= 0x01;
+            if (test_zc_receive(&msg, TEST_ZC_DATA + 1) != -1) why = "tampered payload accepted";
+            slab_handle_free(handle);
+        }
+    }
+
+    slab_stats(slab_msg_large, &after);
+    if (!why && after.in_use != before.in_use) why = "buffer leaked";
+
+    if (why) {
+        test_print_fail("Test14 zero-copy", why);
+        return -1;
+    }
+    test_print_pass("Test14: zero-copy mailbox payload");
+    return 0;
+}
+
+static sw_timer_t test_timers[4];
+static uint32_t   test_timer_hits[4];
+
+static void test_timer_fn(sw_timer_t *t)
+{
+    test_timer_hits[t - test_timers]++;
+}
+
+/******************************************************************************
+ * Function: test15_timer_wheel
+ * Description: Arms four timers on Core 0's wheel and drives timer_run()
+ *              with cntpct values ahead of real time, so the result does
+ *              not depend on how long the UART takes. sched_run() empties
+ *              the wheel again before the scheduler uses it.
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int test15_timer_wheel(void) {
+    sw_timer_t *t = test_timers;
+    timer_stats_t st;
+    uint64_t freq, daif, base;
+    const char *why = 0;
+
+    __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+    __asm__ volatile("mrs %0, daif\n msr daifset, #2" : "=r"(daif) :: "memory");
+
+    timer_init();
+    for (uint32_t i = 0; i < 4; i++) {
+        timer_setup(&t[i], test_timer_fn);
+        test_timer_hits[i] = 0;
+    }
+    __asm__ volatile("isb; mrs %0, cntpct_el0" : "=r"(base));
+    timer_arm(&t[0], TEST_TIMER_ONESHOT_US, 0);
+    timer_arm(&t[1], TEST_TIMER_PERIOD_US, TEST_TIMER_PERIOD_US);
+    timer_arm(&t[2], 2 * TEST_TIMER_PERIOD_US, 0);
+    timer_arm(&t[3], TEST_TIMER_FAR_US, 0);
+
+    if (timer_cancel(&t[2]) != 1 || timer_pending(&t[2])) why = "cancel failed";
+    else if (timer_next_deadline() > base + freq * TEST_TIMER_ONESHOT_US / 1000000 + freq / TIMER_WHEEL_HZ * 2)
+        why = "next deadline after the one-shot";
+
+    /* 10 ms: the one-shot once, the periodic one about ten times */
+    timer_run(base + freq / 1000 * TEST_TIMER_RUN_MS);
+    if (!why && test_timer_hits[0] != 1) why = "one-shot count";
+    if (!why && (test_timer_hits[1] < TEST_TIMER_RUN_MS - 1 || test_timer_hits[1] > TEST_TIMER_RUN_MS))
+        why = "periodic count";
+    if (!why && (test_timer_hits[2] || test_timer_hits[3])) why = "fired early";
+
+    /* Past the far timer: it has cascaded down and fires exactly once */
+    timer_cancel(&t[1]);
+    timer_run(base + freq * (TEST_TIMER_FAR_US / 1000000 + 1));
+    timer_stats(0, &st);
+    if (!why && test_timer_hits[3] != 1) why = "far timer count";
+    if (!why && (st.pending != 0 || st.cascaded == 0)) why = "wheel not empty";
+
+    __asm__ volatile("msr daif, %0" :: "r"(daif) : "memory");
+
+    if (why) {
+        test_print_fail("Test15 timer wheel", why);
+        return -1;
+    }
+    test_print_pass("Test15: timer wheel arm/cancel/expiry");
+    return 0;
+}
+
+/* test19: one letter per run of a task on Core 1's scheduler */
+static char              test_sched_trace[TEST_SCHED_TRACE];
+static volatile uint32_t test_sched_len;
+static volatile uint32_t test_sched_high_done;
+static volatile uint32_t test_sched_done;
+
+static void test_sched_mark(char c) {
+    if (test_sched_len < TEST_SCHED_TRACE) test_sched_trace[test_sched_len] = c;
+    test_sched_len++;
+}
+
+/* HIGH: runs first, then sleeps so the lower levels get the core */
+static void test_sched_high(void) {
+    test_sched_mark('H');
+    task_sleep_ms(TEST_SCHED_SLEEP_MS);
+    test_sched_mark('H');
+    atomic_store_release32(&test_sched_high_done, 1);
+}
+
+/* NORMAL, two of them: each yield must hand over to the other */
+static void test_sched_normal(void) {
+    char c = (sched_self()->id == TEST_SCHED_ID + 1) ? 'A' : 'B';
+
+    for (uint32_t i = 0; i < TEST_SCHED_ROUNDS; i++) {
+        test_sched_mark(c);
+        task_yield();
+    }
+}
+
+/* LOW: only while HIGH sleeps; HIGH takes over at the first yield after
+ * its wake-up */
+static void test_sched_low(void) {
+    test_sched_mark('L');
+    while (!atomic_load_acquire32(&test_sched_high_done)) task_yield();
+    test_sched_mark('L');
+    atomic_store_release32(&test_sched_done, 1);
+}
+
+/* Core 1's side: registered lowest level first, so the order is the
+ * scheduler's and not the registration's. Core 1 stays in sched_run(). */
+static void test19_core1_job(void) {
+    jobContext_t jobs[4] = {
+        { TEST_SCHED_ID + 0, 1, "t19_low",  test_sched_low,    TASK_PRIO_LOW,    TASK_AFFINITY_PINNED },
+        { TEST_SCHED_ID + 1, 1, "t19_a",    test_sched_normal, TASK_PRIO_NORMAL, TASK_AFFINITY_PINNED },
+        { TEST_SCHED_ID + 2, 1, "t19_b",    test_sched_normal, TASK_PRIO_NORMAL, TASK_AFFINITY_PINNED },
+        { TEST_SCHED_ID + 3, 1, "t19_high", test_sched_high,   TASK_PRIO_HIGH,   TASK_AFFINITY_PINNED },
+    };
+
+    for (uint32_t i = 0; i < 4; i++) sched_add_task(&jobs[i]);
+    sched_run();
+}
+
+/******************************************************************************
+ * Function: test19_sched_run_order
+ * Description: Starts a cooperative scheduler on Core 1 with one HIGH, two
+ *              NORMAL and one LOW task and checks the order they ran in
+ *              against TEST_SCHED_EXPECT. Core 1 does not come back to
+ *              test_secondary_idle(), so this must be the last test that
+ *              posts to it.
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int test19_sched_run_order(void) {
+    static const char expect[] = TEST_SCHED_EXPECT;
+    const char *why = 0;
+
+    test_sched_len       = 0;
+    test_sched_high_done = 0;
+    test_sched_done      = 0;
+
+    if (test_remote_post(test19_core1_job) != 0) {
+        why = "Core 1 did not take the job";
+    } else {
+        uint64_t start = read_cntpct();
+        while (!atomic_load_acquire32(&test_sched_done)) {
+            if (read_cntpct() - start > TEST_QUEUE_CROSS_TICKS) {
+                why = "tasks did not finish";
+                break;
+            }
+        }
+    }
+
+    uint32_t len = test_sched_len;
+    if (len > TEST_SCHED_TRACE) len = TEST_SCHED_TRACE;
+
+    spinlock_acquire(SPINLOCK_ADDR);
+    uart_puts("[Core 0] Test19 run order: ");
+    for (uint32_t i = 0; i < len; i++) uart_putc(test_sched_trace[i]);
+    uart_puts(" (expected ");
+    uart_puts(expect);
+    uart_puts(")\n");
+    spinlock_release(SPINLOCK_ADDR);
+
+    for (uint32_t i = 0; !why && i < sizeof(expect) - 1; i++) {
+        if (i >= len || test_sched_trace[i] != expect[i]) {
+            if (i == 0) why = "highest level did not run first";
+            else if (i <= 2 * TEST_SCHED_ROUNDS) why = "same level did not round-robin";
+            else why = "lower level ran while a higher one was ready";
+        }
+    }
+    if (!why && test_sched_len != sizeof(expect) - 1) why = "extra runs";
+
+    if (why) {
+        test_print_fail("Test19 scheduler run order", why);
+        return -1;
+    }
+    test_print_pass("Test19: scheduler priority levels and round-robin");
+    return 0;
+}
+
+static uint8_t test_crc_buf[TEST_CRC_BYTES + 8];
+
+/* Random lengths, offsets and split points against the bitwise references */
+static const char *test_crc_backend(void)
+{
+    uint32_t x = 0x12345678;
+
+    for (uint32_t r = 0; r < TEST_CRC_ROUNDS; r++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        uint32_t len = x % TEST_CRC_BYTES;
+        uint32_t cut = len ? (x >> 10) % len : 0;
+        const uint8_t *p = test_crc_buf + ((x >> 20) & 7);
+
+        uint16_t c16 = crc16_modbus_update(crc16_modbus_update(CRC16_MODBUS_INIT, p, cut),
+                                           p + cut, len - cut);
+        uint32_t c32 = crc32_update(crc32_update(CRC32_INIT, p, cut), p + cut, len - cut);
+        uint32_t c32c = crc32c_update(crc32c_update(CRC32_INIT, p, cut), p + cut, len - cut);
+
+        if (c16 != crc16_modbus_bitwise(CRC16_MODBUS_INIT, p, len)) return "CRC-16 differs from reference";
+        if (c32 != crc32_bitwise(CRC32_INIT, p, len))               return "CRC-32 differs from reference";
+        if (c32c != crc32c_bitwise(CRC32_INIT, p, len))             return "CRC-32C differs from reference";
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test16_crc
+ * Description: [Test 16] Checks the catalogue check values over "123456789"
+ *              (CRC-16/MODBUS 0x4B37, CRC-32 0xCBF43926, CRC-32C 0xE3069283)
+ *              on every available backend, then cross-checks each backend
+ *              against the bitwise definitions over TEST_CRC_ROUNDS random
+ *              unaligned buffers fed in two pieces. Restores the
+ *              boot-selected backend.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test16_crc(void) {
+    static const uint8_t check[] = "123456789";
+    const int backends[] = { CRC_BACKEND_TABLE, CRC_BACKEND_HW };
+    int saved = crc_get_backend();
+    int have_hw = 0;
+    const char *why = 0;
+
+    for (uint32_t i = 0; i < sizeof(test_crc_buf); i++) test_crc_buf[i] = (uint8_t)(i * 131u + 17u);
+
+    for (uint32_t b = 0; b < 2 && !why; b++) {
+        if (crc_set_backend(backends[b]) != 0) continue;    /* no CRC32 instructions */
+        if (backends[b] == CRC_BACKEND_HW) have_hw = 1;
+
+        if (crc16_modbus(check, 9) != 0x4B37) why = "CRC-16/MODBUS check value";
+        else if (crc32(check, 9) != 0xCBF43926u) why = "CRC-32 check value";
+        else if (crc32c(check, 9) != 0xE3069283u) why = "CRC-32C check value";
+        else why = test_crc_backend();
+    }
+    crc_set_backend(saved);
+
+    if (why) {
+        test_print_fail("Test16 CRC", why);
+        return -1;
+    }
+    test_print_pass(have_hw ? "Test16: CRC table/CRC32-instruction backends"
+                            : "Test16: CRC table backend (no CRC32 in ID_AA64ISAR0_EL1)");
+    return 0;
+}
+
+static uint8_t  test_mqtt_out[256];
+static uint32_t test_mqtt_len;
+static uint32_t test_mqtt_calls;
+
+/* Capture transport: the batch as it would go on the wire */
+static int test_mqtt_writev(void *ctx, const mqtt_iov_t *iov, uint32_t n)
+{
+    (void)ctx;
+    test_mqtt_len = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (iov[i].len > sizeof(test_mqtt_out) - test_mqtt_len) return -1;
+        memcpy(&test_mqtt_out[test_mqtt_len], iov[i].base, iov[i].len);
+        test_mqtt_len += iov[i].len;
+    }
+    test_mqtt_calls++;
+    return 0;
+}
+
+/******************************************************************************
+ * Function: test17_mqtt_publish
+ * Description: [Test 17] Encodes the remaining-length values on each side of
+ *              the 1/2/3/4-byte boundaries, then publishes "a/b" = "hello"
+ *              (payload in two segments) at QoS 0 and QoS 1 + RETAIN in one
+ *              batch of TEST_MQTT_BATCH packets and compares the bytes the
+ *              transport received with the MQTT 3.1.1 encoding. Wildcard,
+ *              empty topics, QoS 3 and DUP with QoS 0 must be refused.
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test17_mqtt_publish(void) {
+    static const uint32_t vals[] = { 0, 127, 128, 16383, 16384, 2097151, 2097152, MQTT_REMAINING_MAX };
+    static const uint8_t  lens[] = { 1, 1,   2,   2,     3,     3,       4,       4 };
+    static const uint8_t  want[] = {
+        0x30, 10, 0, 3, 'a', '/', 'b', 'h', 'e', 'l', 'l', 'o',
+        0x33, 12, 0, 3, 'a', '/', 'b', 0, 1, 'h', 'e', 'l', 'l', 'o',
+        0x33, 12, 0, 3, 'a', '/', 'b', 0, 2, 'h', 'e', 'l', 'l', 'o',
+    };
+    static mqtt_writer_t w;
+    mqtt_transport_t tx = { test_mqtt_writev, 0 };
+    mqtt_iov_t payload[2] = { { (const uint8_t *)"hel", 3 }, { (const uint8_t *)"lo", 2 } };
+    uint8_t v[4];
+    const char *why = 0;
+
+    for (uint32_t i = 0; i < sizeof(lens) && !why; i++) {
+        if (mqtt_varint_encode(v, vals[i]) != lens[i]) why = "remaining length size";
+    }
+    if (!why && mqtt_varint_encode(v, MQTT_REMAINING_MAX + 1) != 0) why = "oversized remaining length";
+    if (!why && (mqtt_varint_encode(v, 321) != 2 || v[0] != 0xC1 || v[1] != 0x02)) why = "varint bytes";
+
+    mqtt_writer_init(&w, &tx);
+    test_mqtt_calls = 0;
+    if (!why && mqtt_publish(&w, "a/b", MQTT_QOS0, payload, 2) != 0) why = "QoS 0 publish";
+    if (!why && mqtt_publish(&w, "a/b", MQTT_QOS1 | MQTT_RETAIN, payload, 2) != 1) why = "QoS 1 packet id";
+    if (!why && mqtt_publish(&w, "a/b", MQTT_QOS1 | MQTT_RETAIN, payload, 2) != 2) why = "QoS 1 packet id";
+    if (!why && (test_mqtt_calls != 0 || mqtt_batch_packets(&w) != TEST_MQTT_BATCH)) why = "batch flushed early";
+    if (!why && (mqtt_flush(&w) != 0 || test_mqtt_calls != 1)) why = "flush";
+    if (!why && (test_mqtt_len != sizeof(want) || memcmp(test_mqtt_out, want, sizeof(want)) != 0))
+        why = "packet bytes";
+    if (!why && (w.stats.packets != TEST_MQTT_BATCH || w.stats.bytes != sizeof(want))) why = "stats";
+
+    if (!why && (mqtt_publish(&w, "a/+", MQTT_QOS0, payload, 2) != -1 ||
+                 mqtt_publish(&w, "#", MQTT_QOS0, payload, 2) != -1 ||
+                 mqtt_publish(&w, "", MQTT_QOS0, payload, 2) != -1 ||
+                 mqtt_publish(&w, "a/b", MQTT_QOS1 | MQTT_QOS2, payload, 2) != -1 ||
+                 mqtt_publish(&w, "a/b", MQTT_QOS0 | MQTT_DUP, payload, 2) != -1)) {
+        why = "bad publish accepted";
+    }
+
+    if (why) {
+        test_print_fail("Test17 MQTT publish", why);
+        return -1;
+    }
+    test_print_pass("Test17: MQTT PUBLISH encoder and batching");
+    return 0;
+}
+
+static modbus_master_t test_mb_fast, test_mb_slow;
+
+static int test_mb_write(void *ctx, const uint8_t *buf, uint32_t len)
+{
+    (void)ctx; (void)buf; (void)len;
+    return 0;                               /* the test plays the slave */
+}
+
+/* FC 3 reply of TEST_MB_REGS registers from 'slave', CRC appended */
+static uint32_t test_mb_reply(uint8_t *r, uint8_t slave)
+{
+    r[0] = slave;
+    r[1] = MODBUS_FC_READ_HOLDING;
+    r[2] = 2 * TEST_MB_REGS;
+    for (uint32_t i = 0; i < TEST_MB_REGS; i++) {
+        r[3 + 2 * i] = (uint8_t)(i >> 8);
+        r[4 + 2 * i] = (uint8_t)(i * 3);
+    }
+    uint32_t n   = 3 + 2 * TEST_MB_REGS;
+    uint16_t crc = modbus_crc16(r, n);
+    r[n++] = (uint8_t)crc;
+    r[n++] = (uint8_t)(crc >> 8);
+    return n;
+}
+
+/*
+ * One FC 3 transaction starting at *t: the reply arrives in bursts of
+ * 'burst' bytes, each stamped when its last byte is in (back to back on
+ * the wire), then the line is idle for t3.5. 'gap' adds extra silence
+ * before the second burst. Returns the status of the frame, -1 if none.
+ */
+static int test_mb_transact(modbus_master_t *m, const uint8_t *r, uint32_t n,
+                            uint32_t burst, uint64_t gap, uint64_t *t)
+{
+    modbus_frame_t f;
+
+    if (modbus_read_registers(m, TEST_MB_SLAVE, MODBUS_FC_READ_HOLDING, 0, TEST_MB_REGS, *t) != 0) {
+        return -1;
+    }
+    *t += 8 * m->char_ticks;                /* request on the wire */
+    for (uint32_t off = 0; off < n; off += burst) {
+        uint32_t len = n - off < burst ? n - off : burst;
+        *t += len * m->char_ticks + (off == burst ? gap : 0);
+        modbus_rx_feed(m, r + off, len, *t);
+    }
+    *t += m->t35;
+    if (!modbus_poll(m, *t) || modbus_frame_pop(m, &f) != 0) return -1;
+    *t += m->t35;
+    return f.status == MODBUS_ERR_EXCEPTION ? (int)(MODBUS_ERR_EXCEPTION | (f.exception << 8))
+                                            : (int)f.status;
+}
+
+/******************************************************************************
+ * Function: test18_modbus_rtu
+ * Description: [Test 18] Drives two masters (TEST_MB_BAUD_FAST with the
+ *              fixed 750 / 1750 us timers, TEST_MB_BAUD_SLOW with
+ *              character-time ones) with cntpct values of its own:
+ *              - a 25-byte reply in TEST_MB_BURST-byte bursts, each burst
+ *                longer on the wire than t1.5 (fast) or t3.5 (slow), must
+ *                still be one good frame
+ *              - a flipped CRC byte, a silence above t1.5 inside the
+ *                frame, an exception reply (code 2), another slave's
+ *                address and no reply at all must each give their status
+ * Returns: 0 on PASS, -1 on FAIL
+ *****************************************************************************/
+int test18_modbus_rtu(void) {
+    static int ready;
+    modbus_port_t fast = { test_mb_write, 0, TEST_MB_BAUD_FAST };
+    modbus_port_t slow = { test_mb_write, 0, TEST_MB_BAUD_SLOW };
+    modbus_master_t *m = &test_mb_fast;
+    modbus_frame_t f;
+    uint8_t r[MODBUS_ADU_MAX];
+    uint64_t t = 1000;
+    const char *why = 0;
+
+    if (!ready) {                           /* the queues come from the arena */
+        if (modbus_master_init(&test_mb_fast, &fast) != 0 ||
+            modbus_master_init(&test_mb_slow, &slow) != 0) {
+            test_print_fail("Test18 Modbus RTU", "init failed");
+            return -1;
+        }
+        ready = 1;
+    }
+    modbus_stats_t before = m->stats;
+
+    uint32_t n = test_mb_reply(r, TEST_MB_SLAVE);
+    if (test_mb_transact(&test_mb_fast, r, n, TEST_MB_BURST, 0, &t) != MODBUS_OK)
+        why = "bursts split or marked bad (fast)";
+    else if (test_mb_transact(&test_mb_slow, r, n, TEST_MB_BURST, 0, &t) != MODBUS_OK)
+        why = "bursts split or marked bad (slow)";
+    else if (test_mb_transact(m, r, n, n, 0, &t) != MODBUS_OK)
+        why = "whole reply";
+
+    if (!why) {
+        r[n - 1] ^= 0x01;
+        if (test_mb_transact(m, r, n, n, 0, &t) != MODBUS_ERR_CRC) why = "bad CRC accepted";
+        r[n - 1] ^= 0x01;
+    }
+    if (!why && test_mb_transact(m, r, n, TEST_MB_BURST, m->t15 + m->char_ticks, &t) != MODBUS_ERR_FRAME)
+        why = "t1.5 gap accepted";
+
+    if (!why) {
+        uint8_t ex[5] = { TEST_MB_SLAVE, MODBUS_FC_READ_HOLDING | MODBUS_EXCEPTION, 0x02 };
+        uint16_t crc = modbus_crc16(ex, 3);
+        ex[3] = (uint8_t)crc;
+        ex[4] = (uint8_t)(crc >> 8);
+        if (test_mb_transact(m, ex, 5, 5, 0, &t) != (MODBUS_ERR_EXCEPTION | (0x02 << 8)))
+            why = "exception reply";
+    }
+    if (!why) {
+        n = test_mb_reply(r, TEST_MB_SLAVE + 1);
+        if (test_mb_transact(m, r, n, n, 0, &t) != MODBUS_ERR_MISMATCH) why = "other slave accepted";
+    }
+
+    /* No reply: nothing before the deadline, a timeout at it */
+    if (!why && modbus_read_registers(m, TEST_MB_SLAVE, MODBUS_FC_READ_HOLDING, 0, TEST_MB_REGS, t) != 0)
+        why = "request refused";
+    if (!why) {
+        uint64_t deadline = modbus_next_deadline(m);
+        if (modbus_poll(m, deadline - 1)) why = "timeout early";
+        else if (!modbus_poll(m, deadline) || modbus_frame_pop(m, &f) != 0 ||
+                 f.status != MODBUS_ERR_TIMEOUT) why = "no timeout";
+    }
+    if (!why && (m->stats.crc_errors - before.crc_errors != 1 ||
+                 m->stats.frame_errors - before.frame_errors != 1 ||
+                 m->stats.exceptions - before.exceptions != 1 ||
+                 m->stats.mismatches - before.mismatches != 1 ||
+                 m->stats.timeouts - before.timeouts != 1)) {
+        why = "error counters";
+    }
+
+    if (why) {
+        test_print_fail("Test18 Modbus RTU", why);
+        return -1;
+    }
+    test_print_pass("Test18: Modbus RTU framing and error paths");
+    return 0;
+}
+
 /******************************************************************************
  * Function: run_all_tests
  * Description: Master test runner — executes all unit test cases in sequence.
@@ -214,6 +1497,22 @@ void run_all_tests(void) {
 
     test1_ping_all_cores();
     test2_send_data_messages();
-    test3_uart_rx_keyboard_simulation();  // Does not return (WFE loop)
+    test3_uart_rx_keyboard_simulation();  // announces only, returns
+    test4_spsc_queue_throughput();
+    test5_mpsc_queue_throughput();
+    test6_mpmc_queue_throughput();
+    test7_sha256_backends();
+    test8_lock_stats();
+    test9_uart_irq_tx();
+    test10_log_records();
+    test11_pmu_probe();
+    test12_mmu_regions();
+    test13_slab_pool();
+    test14_mailbox_zero_copy();
+    test15_timer_wheel();
+    test16_crc();
+    test17_mqtt_publish();
+    test18_modbus_rtu();
+    test19_sched_run_order();             // last: Core 1 stays in sched_run
 }
 
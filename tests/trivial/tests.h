@@ -19,6 +19,47 @@
 #define TEST_DELAY_SHORT        2000000
 #define TEST_DELAY_MEDIUM       3000000
 #define TEST_DELAY_LONG         10000000
+#define TEST_QUEUE_CAPACITY     64
+#define TEST_QUEUE_OPS          4096
+#define TEST_QUEUE_CROSS_TICKS  62500000        /* 1 s at 62.5 MHz    */
+
+/* test_remote_state: Core 0 posts a job, Core 1 runs it */
+#define TEST_REMOTE_IDLE        0
+#define TEST_REMOTE_POSTED      1
+#define TEST_REMOTE_RUNNING     2
+#define TEST_REMOTE_DONE        3
+#define TEST_SHA_BENCH_BLOCKS   16
+#define TEST_LOCK_ITERS         1024
+#define TEST_UART_DRAIN_TICKS   6250000         /* 100 ms at 62.5 MHz */
+#define TEST_LOG_RECORDS        8
+#define TEST_PMU_SCOPES         16
+#define TEST_MMU_NC_BYTES       64
+#define TEST_PAR_FAULT          1ull            /* PAR_EL1.F              */
+#define TEST_PAR_ATTR_WB        0xFFu           /* MAIR Attr0 (pagetable.h) */
+#define TEST_PAR_ATTR_NC        0x44u           /* MAIR Attr2             */
+#define TEST_SLAB_OBJS          8               /* 2 per core list        */
+#define TEST_SLAB_OBJ_SIZE      24              /* rounds up to 32        */
+#define TEST_ZC_BYTES           200             /* msg_large payload      */
+#define TEST_ZC_OFFSET          16
+#define TEST_ZC_DATA            0x2C0FFEE0
+#define TEST_ZC_POLL_ROUNDS     1000
+#define TEST_TIMER_ONESHOT_US   500
+#define TEST_TIMER_PERIOD_US    1000
+#define TEST_TIMER_FAR_US       60000000ull     /* 60 s: top wheel level  */
+#define TEST_TIMER_RUN_MS       10
+#define TEST_CRC_BYTES          520             /* lengths 0 .. 519       */
+#define TEST_CRC_ROUNDS         64
+#define TEST_MQTT_BATCH         3               /* packets per flush      */
+#define TEST_MB_SLAVE           1
+#define TEST_MB_REGS            10              /* 25-byte FC 3 reply     */
+#define TEST_MB_BURST           8               /* PL011 RX trigger level */
+#define TEST_MB_BAUD_FAST       115200          /* fixed t1.5 / t3.5      */
+#define TEST_MB_BAUD_SLOW       9600            /* character-time t1.5 / t3.5 */
+#define TEST_SCHED_ID           0x7E0           /* test19 task IDs, +0..3 */
+#define TEST_SCHED_ROUNDS       3               /* yields per NORMAL task */
+#define TEST_SCHED_SLEEP_MS     10              /* HIGH's sleep           */
+#define TEST_SCHED_TRACE        16
+#define TEST_SCHED_EXPECT       "HABABABLHL"
 
 /**************************************************
  * HELPER FUNCTIONS
@@ -40,11 +81,141 @@ int  test2_send_data_messages(void);
 
 /******************************************************************************
  * Function: test3_uart_rx_keyboard_simulation
- * Description: Announces live UART keyboard simulation, then idles Core 0
- * Returns: None (enters WFE loop)
+ * Description: Announces live UART keyboard simulation (Cores 1 & 2)
+ * Returns: None
  *****************************************************************************/
 void test3_uart_rx_keyboard_simulation(void);
 
+/******************************************************************************
+ * Function: test4_spsc_queue_throughput / test5_mpsc_... / test6_mpmc_...
+ * Description: Push/pop TEST_QUEUE_OPS records through each queue flavour,
+ *              check FIFO order and full/empty, print elapsed ticks. MPSC
+ *              and MPMC then run again with Core 1 producing (and, for
+ *              MPMC, consuming) at the same time as Core 0.
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test4_spsc_queue_throughput(void);
+int  test5_mpsc_queue_throughput(void);
+int  test6_mpmc_queue_throughput(void);
+
+/******************************************************************************
+ * Function: test7_sha256_backends
+ * Description: Known-answer + cross-check of scalar vs CE SHA-256 compress,
+ *              prints cycles/block for both
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test7_sha256_backends(void);
+
+/******************************************************************************
+ * Function: test8_lock_stats
+ * Description: Uncontended ticket/MCS lock round-trips, counter checks and a
+ *              dump of every lock's contention stats
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test8_lock_stats(void);
+
+/******************************************************************************
+ * Function: test9_uart_irq_tx
+ * Description: Non-blocking uart_write(), and a TX-ring drain that only the
+ *              TX interrupt can do (uart_tx_queue() with IRQs masked)
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test9_uart_irq_tx(void);
+
+/******************************************************************************
+ * Function: test10_log_records
+ * Description: Core 0 log queue round-trip: append, flush, count, no drops
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test10_log_records(void);
+
+/******************************************************************************
+ * Function: test11_pmu_probe
+ * Description: PMU probe bookkeeping: calls, cycles and max per scope
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test11_pmu_probe(void);
+
+/******************************************************************************
+ * Function: test12_mmu_regions
+ * Description: AT/PAR_EL1 checks of text/rodata/stack/NC region attributes
+ *              and of the unmapped stack guard pages
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test12_mmu_regions(void);
+
+/******************************************************************************
+ * Function: test13_slab_pool
+ * Description: Drain a small slab pool from Core 0 (own list, then stolen
+ *              from the other cores' lists), check exhaustion, frees,
+ *              bad-pointer rejection and the usage/high-water counters
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test13_slab_pool(void);
+
+/******************************************************************************
+ * Function: test14_mailbox_zero_copy
+ * Description: Core 0 -> Core 0 message carrying a pool buffer: the payload
+ *              arrives in place, intact, and is freed by mailbox_release;
+ *              a payload changed after sending is rejected by the HMAC
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test14_mailbox_zero_copy(void);
+
+/******************************************************************************
+ * Function: test15_timer_wheel
+ * Description: Core 0's timer wheel run over simulated time: a one-shot
+ *              fires once, a periodic one once per period, a cancelled one
+ *              never, and a 60 s timer only after its cascades
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test15_timer_wheel(void);
+
+/******************************************************************************
+ * Function: test19_sched_run_order
+ * Description: Scheduler run order on Core 1: the highest ready level runs
+ *              first, tasks on one level round-robin at each yield, and a
+ *              lower level runs only while the higher ones sleep
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test19_sched_run_order(void);
+
+/******************************************************************************
+ * Function: test16_crc
+ * Description: CRC-16/MODBUS, CRC-32 and CRC-32C: check values, then the
+ *              table and (if present) CRC32-instruction backends against
+ *              the bitwise references, streamed in two pieces
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test16_crc(void);
+
+/******************************************************************************
+ * Function: test17_mqtt_publish
+ * Description: MQTT PUBLISH encoder: remaining-length varints at the byte
+ *              boundaries, exact packet bytes for QoS 0 and QoS 1, one
+ *              writev() per batch and rejection of bad topics / flags
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test17_mqtt_publish(void);
+
+/******************************************************************************
+ * Function: test18_modbus_rtu
+ * Description: Modbus RTU master over simulated time: replies delivered in
+ *              FIFO-sized bursts, then the bad CRC, t1.5 gap, exception,
+ *              wrong slave and timeout paths
+ * Returns: 0 on success, -1 on failure
+ *****************************************************************************/
+int  test18_modbus_rtu(void);
+
+/******************************************************************************
+ * Function: test_secondary_idle
+ * Description: Core 1's idle loop: WFE, running the cross-core jobs of
+ *              test5/test6 when Core 0 posts them, until test19 moves it
+ *              into sched_run()
+ * Returns: None (never returns)
+ *****************************************************************************/
+void test_secondary_idle(void);
+
 /******************************************************************************
  * Function: run_all_tests
  * Description: Master runner — executes all unit tests in order